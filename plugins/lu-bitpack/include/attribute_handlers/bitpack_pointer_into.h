@@ -0,0 +1,7 @@
+#pragma once
+#include <gcc-plugin.h>
+#include <tree.h>
+
+namespace attribute_handlers {
+   extern tree bitpack_pointer_into(tree* node, tree name, tree args, int flags, bool* no_add_attrs);
+}
\ No newline at end of file
@@ -16,7 +16,10 @@ namespace attribute_handlers::helpers {
    enum class x_option_type {
       none,
       buffer,
+      delta,
       integral,
+      pointer,
+      quantized,
       string,
       transforms,
    };
@@ -59,6 +62,7 @@ namespace attribute_handlers::helpers {
          gcc_wrappers::attribute_list get_existing_attributes() const;
       
          void check_and_report_applied_to_integral();
+         void check_and_report_applied_to_string();
       
       protected:
          bool _impl_check_x_options(tree subject, x_option_type here);
@@ -10,6 +10,10 @@ class basic_global_state : public lu::singleton<basic_global_state> {
       struct {
          gcc_wrappers::decl::optional_function memcpy;
          gcc_wrappers::decl::optional_function memset;
+         
+         // Only needed for dirty checks.
+         gcc_wrappers::decl::optional_function memcmp;
+         gcc_wrappers::decl::optional_function strncmp;
       } builtin_functions;
       bitpacking::global_options global_options;
       std::string xml_output_path;
@@ -34,8 +34,9 @@ namespace bitpacking {
          } config;
          //
          gcc_wrappers::optional_node default_value;
-         bool has_attr_nonstring = false;
-         bool is_omitted         = false;
+         bool has_attr_mixed_radix = false;
+         bool has_attr_nonstring   = false;
+         bool is_omitted           = false;
          std::vector<std::string> stat_categories;
          std::vector<std::string> misc_annotations;
          std::optional<intmax_t>  union_member_id;
@@ -3,14 +3,19 @@
 #include <limits>
 #include <optional>
 #include <variant>
+#include <vector>
 #include <version>
 #include "gcc_wrappers/decl/function.h"
+#include "gcc_wrappers/decl/variable.h"
 #include "gcc_wrappers/type/base.h"
 
 namespace bitpacking::typed_data_options {
    namespace requested {
       struct buffer;
+      struct delta;
       struct integral;
+      struct pointer;
+      struct quantized;
       struct string;
       struct tagged_union;
       struct transformed;
@@ -27,6 +32,27 @@ namespace bitpacking::typed_data_options {
          
          constexpr bool operator==(const buffer&) const noexcept = default;
       };
+      struct delta {
+         //
+         // An array of integers, typically sorted or otherwise non-decreasing. 
+         // The first element is serialized in `first_bits` bits, and each one 
+         // after it as its difference from the previous element, in 
+         // `delta_bits` bits (see `codegen/delta.h`).
+         //
+         size_t first_bits = 0;
+         size_t delta_bits = 0;
+         size_t length     = 0; // element count of the innermost array
+         
+         bool load(gcc_wrappers::node target, const requested::delta&, bool complain = true);
+         
+         constexpr size_t bitcount() const noexcept {
+            if (this->length == 0)
+               return 0;
+            return this->first_bits + (this->length - 1) * this->delta_bits;
+         }
+         
+         constexpr bool operator==(const delta&) const noexcept = default;
+      };
       struct integral {
          static constexpr const intmax_t  no_minimum = std::numeric_limits<intmax_t>::lowest();
          static constexpr const uintmax_t no_maximum = std::numeric_limits<uintmax_t>::max();
@@ -35,20 +61,71 @@ namespace bitpacking::typed_data_options {
          intmax_t  min      = no_minimum;
          uintmax_t max      = no_maximum;
          
+         // If not empty, the only values this integral can take, sorted and 
+         // without duplicates. We serialize a value's index within the set, 
+         // rather than the value itself (see `codegen/value_set.h`).
+         std::vector<intmax_t> value_set;
+         
          bool load(gcc_wrappers::node target, const requested::integral&, bool complain = true);
          
-         constexpr bool operator==(const integral&) const noexcept = default;
+         #if __cpp_lib_constexpr_vector >= 201907L
+         constexpr
+         #endif
+         bool operator==(const integral&) const noexcept = default;
       };
       struct pointer {
-         constexpr bool operator==(const pointer&) const noexcept = default;
+         //
+         // If set, the pointer is known to be null or to point to an element 
+         // of this array, and we serialize it as an index into the array 
+         // rather than as an address (see `codegen/pointer_into.h`).
+         //
+         gcc_wrappers::decl::optional_variable into;
+         size_t element_count = 0;
+         size_t bitcount      = 0; // only meaningful if `into` is set
+         
+         bool load(gcc_wrappers::node target, const requested::pointer&, bool complain = true);
+         
+         bool operator==(const pointer&) const noexcept = default;
+      };
+      struct quantized {
+         //
+         // A floating-point or integral value, scaled from the range [min, max] 
+         // into a fixed number of bits, and rescaled when read back. Values 
+         // outside of the range are clamped to it (see `codegen/quantize.h`).
+         //
+         size_t      bitcount    = 0;
+         long double min         = 0;
+         long double max         = 0;
+         bool        is_integral = false; // the target is an integer, not a float
+         
+         bool load(gcc_wrappers::node target, const requested::quantized&, bool complain = true);
+         
+         // The distance between adjacent values that survive a round-trip.
+         long double step() const;
+         
+         constexpr bool operator==(const quantized&) const noexcept = default;
       };
       struct string {
          size_t length    = 0;     // does not include null terminator
          bool   nonstring = false; // if true, we don't need a null terminator (i.e. GCC attr)
          
+         // Characters are serialized in `char_bits` bits each. If `charset` 
+         // isn't empty, then each character is serialized as its index within 
+         // it, rather than as itself (see `codegen/charset.h`).
+         size_t char_bits = 8;
+         std::vector<uint8_t> charset;
+         
          bool load(gcc_wrappers::node target, const requested::string&, bool complain = true);
          
-         constexpr bool operator==(const string&) const noexcept = default;
+         // True if we can't use the bitstream string functions.
+         constexpr bool uses_charset() const noexcept {
+            return this->char_bits != 8 || !this->charset.empty();
+         }
+         
+         #if __cpp_lib_constexpr_vector >= 201907L
+         constexpr
+         #endif
+         bool operator==(const string&) const noexcept = default;
       };
       struct structure {
          //
@@ -57,6 +134,11 @@ namespace bitpacking::typed_data_options {
          // we need to split the struct across sector boundaries.
          //
          
+         // If true, the struct's members are packed together as the digits of 
+         // one or more combined integers (see `codegen/mixed_radix.h`), and 
+         // the struct can never be split across sector boundaries.
+         bool mixed_radix = false;
+         
          constexpr bool operator==(const structure&) const noexcept = default;
       };
       struct tagged_union {
@@ -85,17 +167,44 @@ namespace bitpacking::typed_data_options {
       struct buffer {
          constexpr bool operator==(const buffer&) const noexcept = default;
       };
+      struct delta {
+         size_t first_bits = 0;
+         size_t delta_bits = 0;
+         
+         constexpr bool operator==(const delta&) const noexcept = default;
+      };
       struct integral {
          std::optional<size_t>    bitcount;
          std::optional<intmax_t>  min;
          std::optional<uintmax_t> max;
+         std::vector<intmax_t>    value_set;
          
-         constexpr bool operator==(const integral&) const noexcept = default;
+         #if __cpp_lib_constexpr_vector >= 201907L
+         constexpr
+         #endif
+         bool operator==(const integral&) const noexcept = default;
+      };
+      struct pointer {
+         gcc_wrappers::decl::optional_variable into;
+         
+         bool operator==(const pointer&) const noexcept = default;
+      };
+      struct quantized {
+         size_t      bitcount = 0;
+         long double min      = 0;
+         long double max      = 0;
+         
+         constexpr bool operator==(const quantized&) const noexcept = default;
       };
       struct string {
-         std::optional<bool> nonstring;
+         std::optional<bool>   nonstring;
+         std::optional<size_t> char_bits;
+         std::vector<uint8_t>  charset;
          
-         constexpr bool operator==(const string&) const noexcept = default;
+         #if __cpp_lib_constexpr_vector >= 201907L
+         constexpr
+         #endif
+         bool operator==(const string&) const noexcept = default;
       };
       struct tagged_union {
          std::string tag_identifier;
@@ -121,8 +230,10 @@ namespace bitpacking::typed_data_options {
       std::monostate,
       computed::boolean,
       computed::buffer,
+      computed::delta,
       computed::integral,
       computed::pointer,
+      computed::quantized,
       computed::string,
       computed::structure,
       computed::tagged_union,
@@ -131,7 +242,10 @@ namespace bitpacking::typed_data_options {
    using requested_variant = std::variant<
       std::monostate,
       requested::buffer,
+      requested::delta,
       requested::integral,
+      requested::pointer,
+      requested::quantized,
       requested::string,
       requested::tagged_union,
       requested::transformed
@@ -1,5 +1,6 @@
 #pragma once
 #include <limits>
+#include <vector>
 #include "gcc_wrappers/decl/function.h"
 #include "gcc_wrappers/type/base.h"
 #include "gcc_wrappers/type/function.h"
@@ -37,12 +38,14 @@ namespace bitpacking {
       public:
          struct {
             gcc_wrappers::decl::optional_function stream_state_init;
+            gcc_wrappers::decl::optional_function checksum_update; // optional
             function_set read;
             function_set save;
          } functions;
          struct {
             size_t max_count = 1;
-            size_t bytes_per = std::numeric_limits<size_t>::max(); // size in bytes per sector
+            size_t bytes_per = std::numeric_limits<size_t>::max(); // size in bytes per sector (or of the largest sector)
+            std::vector<size_t> sizes; // size in bytes of each sector, if they differ
          } sectors;
          struct {
             gcc_wrappers::type::optional_record  bitstream_state;
@@ -50,6 +53,8 @@ namespace bitpacking {
             gcc_wrappers::type::optional_base    boolean; // for old C codebases
             gcc_wrappers::type::optional_base    buffer_byte;
             gcc_wrappers::type::optional_pointer buffer_byte_ptr;
+            gcc_wrappers::type::optional_base    checksum; // optional
+            gcc_wrappers::type::optional_pointer checksum_ptr;
          } types;
          bool invalid = true;
          
@@ -60,5 +65,12 @@ namespace bitpacking {
          //
          
          bool type_is_boolean(const gcc_wrappers::type::base) const;
+         
+         // The size in bytes of the n-th sector.
+         size_t sector_size(size_t n) const;
+         
+         // True if the generated functions should compute a checksum of the 
+         // data they read or save.
+         bool checksums_enabled() const;
    };
 }
\ No newline at end of file
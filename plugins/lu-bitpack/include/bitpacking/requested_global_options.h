@@ -1,6 +1,7 @@
 #pragma once
 #include <optional>
 #include <string_view>
+#include <vector>
 #include <gcc-plugin.h>
 #include <c-family/c-pragma.h> // cpp_reader
 #include "gcc_wrappers/identifier.h"
@@ -30,6 +31,10 @@ namespace bitpacking {
             size_t       data;
             location_set loc;
          };
+         struct size_list_option {
+            std::vector<size_t> data;
+            location_set        loc;
+         };
       
          struct function_set {
             std::optional<identifier_option> boolean;
@@ -48,6 +53,9 @@ namespace bitpacking {
          std::optional<identifier_option>* _id_option_for_key(std::string_view);
          std::optional<size_option>* _size_option_for_key(std::string_view);
          
+         // May throw `pragma_parse_exception`.
+         static size_t _parse_size(std::string_view key, cpp_ttype token_type, tree data, location_t loc);
+         
       public:
          // May throw `pragma_parse_exception`.
          requested_global_options(cpp_reader&);
@@ -55,17 +63,20 @@ namespace bitpacking {
          location_t pragma_location = UNKNOWN_LOCATION;
          struct {
             std::optional<identifier_option> stream_state_init;
+            std::optional<identifier_option> checksum_update;
             function_set read;
             function_set save;
          } functions;
          struct {
             std::optional<size_option> max_count;
             std::optional<size_option> bytes_per;
+            std::optional<size_list_option> sizes;
          } sectors;
          struct {
             std::optional<identifier_option> bitstream_state;
             std::optional<identifier_option> boolean;
             std::optional<identifier_option> buffer_byte;
+            std::optional<identifier_option> checksum;
          } types;
    };
 }
\ No newline at end of file
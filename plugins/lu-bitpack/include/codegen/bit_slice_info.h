@@ -0,0 +1,16 @@
+#pragma once
+
+namespace codegen {
+   //
+   // Represents some of the bits that a scalar value is serialized as: 
+   // `count` bits, starting `start` bits above the least significant bit. 
+   // When a value is split across a sector boundary, each sector transfers 
+   // one slice of it.
+   //
+   struct bit_slice_info {
+      constexpr bool operator==(const bit_slice_info&) const noexcept = default;
+      
+      size_t start = 0;
+      size_t count = 0;
+   };
+}
\ No newline at end of file
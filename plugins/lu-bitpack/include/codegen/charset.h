@@ -0,0 +1,46 @@
+#pragma once
+#include "gcc_wrappers/expr/base.h"
+#include "gcc_wrappers/value.h"
+#include "codegen/expr_pair.h"
+#include "codegen/optional_value_pair.h"
+
+namespace bitpacking::typed_data_options::computed {
+   struct string;
+}
+namespace codegen::instructions::utils {
+   struct generation_context;
+}
+
+//
+// Reduced character sets: a string whose characters all come from a small 
+// alphabet is serialized in fewer than 8 bits per character. Each character 
+// is saved as a code: its index within the charset's table, if it has one, 
+// or else the character itself. Characters that have no code are saved as 
+// code 0.
+//
+// For each table, we define (once per translation unit) a constant table of 
+// its characters, which maps codes back to characters when reading; and a 
+// 256-entry table of codes, which maps characters to codes when saving.
+//
+// Characters are transferred one at a time, in a loop. As with the bitstream 
+// string functions, a string that requires a terminator is padded with the 
+// terminator's code after its end.
+//
+namespace codegen::charset {
+   // Generates the loops that read and save a string, given the (innermost) 
+   // array that holds it. If checksums are enabled, each character's code is 
+   // fed into the checksum as it's read or saved.
+   extern expr_pair generate(
+      const bitpacking::typed_data_options::computed::string&,
+      const optional_value_pair& array,
+      const instructions::utils::generation_context&
+   );
+   
+   // Generates a loop that compares a string's serialized codes against the 
+   // codes that a save would write.
+   extern gcc_wrappers::expr::base generate_dirty_check(
+      const bitpacking::typed_data_options::computed::string&,
+      gcc_wrappers::value array,
+      const instructions::utils::generation_context&
+   );
+}
\ No newline at end of file
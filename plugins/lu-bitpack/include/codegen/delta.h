@@ -0,0 +1,44 @@
+#pragma once
+#include "gcc_wrappers/expr/base.h"
+#include "gcc_wrappers/value.h"
+#include "codegen/expr_pair.h"
+#include "codegen/optional_value_pair.h"
+
+namespace bitpacking::typed_data_options::computed {
+   struct delta;
+}
+namespace codegen::instructions::utils {
+   struct generation_context;
+}
+
+//
+// Delta encoding: the first element of an array of integers is serialized as 
+// itself, in a fixed number of bits, and each element after it is serialized 
+// as its difference from the element before it, in a smaller fixed number of 
+// bits. The serialized size of the array is therefore still static.
+//
+// When saving, we keep a running total of the values that a read would 
+// produce, and compute each difference against that total rather than the 
+// previous element itself. Differences that are negative or too large to 
+// fit are clamped, and so the elements after such a clamped difference read 
+// back as near as possible to their true values, rather than accumulating 
+// the error. Negative elements are saved as zero.
+//
+namespace codegen::delta {
+   // Generates the loops that read and save an array, given the (innermost) 
+   // array. If checksums are enabled, each serialized value is fed into the 
+   // checksum as it's read or saved.
+   extern expr_pair generate(
+      const bitpacking::typed_data_options::computed::delta&,
+      const optional_value_pair& array,
+      const instructions::utils::generation_context&
+   );
+   
+   // Generates a loop that compares an array's serialized values against the 
+   // values that a save would write.
+   extern gcc_wrappers::expr::base generate_dirty_check(
+      const bitpacking::typed_data_options::computed::delta&,
+      gcc_wrappers::value array,
+      const instructions::utils::generation_context&
+   );
+}
\ No newline at end of file
@@ -1,9 +1,12 @@
 #pragma once
+#include <limits>
+#include <optional>
 #include <string>
 #include <variant>
 #include <vector>
 #include <gcc-plugin.h>
 #include <c-family/c-pragma.h>
+#include "gcc_wrappers/attribute_list.h"
 #include "gcc_wrappers/identifier.h"
 
 namespace codegen {
@@ -18,6 +21,13 @@ namespace codegen {
                gcc_wrappers::optional_node referent; // thing to which the identifier refers
             } cached;
          };
+         
+         // How per-sector functions are generated.
+         enum class codegen_mode {
+            code,      // as straight-line code
+            table,     // as calls to a shared interpreter, given a table of the sector's layout
+            automatic, // whichever of the above is estimated to be smaller, per sector
+         };
       
       public:
          struct {
@@ -26,7 +36,55 @@ namespace codegen {
          } function_names;
          std::vector<std::vector<identifier>> identifier_groups;
          struct {
-            bool enable_debug_output = false;
+            bool enable_debug_output       = false;
+            bool generate_dirty_checks     = false;
+            bool generate_identifier_reads = false;
+            
+            // If true, then a scalar that doesn't fit in the bits left in a 
+            // sector is split: its low bits end the sector, and its high bits 
+            // start the next one.
+            bool split_scalars_across_sectors = false;
+            
+            // If true, then an opaque buffer or unterminated string that doesn't 
+            // fit in the bits left in a sector is split: as many of its bytes 
+            // as fit end the sector, and the rest start the next one.
+            bool split_buffers_across_sectors = false;
+            
+            // If true, then a tagged union that doesn't fit in the bits left 
+            // in a sector is split: each of its branches continues into the 
+            // next sector, and the code for each sector checks the tag anew.
+            bool split_unions_across_sectors = false;
+            
+            // If non-zero, generate resumable step functions, which process 
+            // steps of roughly this many bits.
+            size_t resumable_step_size = 0;
+            
+            // If non-zero, a sector whose node tree has more than this many 
+            // nodes is split into several functions, each with roughly this 
+            // many nodes, which the sector's read and save functions call in 
+            // turn.
+            size_t max_statements_per_function = 0;
+            
+            codegen_mode mode = codegen_mode::code;
+            
+            // Applied to every function we generate, e.g. to place them in 
+            // a particular section.
+            gcc_wrappers::attribute_list function_attributes;
+            
+            // Only the per-sector functions for sectors in this range (inclusive) 
+            // are defined in the current translation unit. The rest are only 
+            // declared, and are expected to be defined by other translation 
+            // units that generate the same layout.
+            struct {
+               size_t first = 0;
+               size_t last  = std::numeric_limits<size_t>::max();
+            } sectors;
+            
+            // Whether the current translation unit defines everything that isn't 
+            // specific to a single sector: the whole-struct functions, the 
+            // requested read and save functions, and so on. If not, they're only 
+            // declared.
+            bool emit_shared = true;
          } settings;
          
          // location at which our data starts
@@ -36,5 +94,9 @@ namespace codegen {
          bool from_pragma_parser(cpp_reader&);
          bool are_identifiers_valid(bool complain = true);
          bool are_function_names_valid(bool complain = true) const;
+         
+         // Whether the current translation unit should define the per-sector 
+         // functions for the given sector.
+         bool defines_sector(size_t) const;
    };
 }
\ No newline at end of file
@@ -1,9 +1,15 @@
 #pragma once
+#include <limits>
 #include <memory>
+#include <string_view>
 #include <vector>
 #include "codegen/instructions/base.h"
+#include "codegen/expr_pair.h"
 #include "codegen/func_pair.h"
 #include "codegen/whole_struct_function_dictionary.h"
+#include "gcc_wrappers/attribute_list.h"
+#include "gcc_wrappers/decl/function.h"
+#include "gcc_wrappers/type/function.h"
 
 namespace codegen {
    class generation_request;
@@ -11,23 +17,121 @@ namespace codegen {
 
 namespace codegen {
    class generation_result {
+      public:
+         // A run of one top-level identifier's items within a single sector.
+         struct identifier_span {
+            size_t sector_index = 0;
+            size_t offset       = 0; // in bits, from the start of the sector
+            std::unique_ptr<instructions::base> instructions;
+         };
+         
+         // A run of items within a sector, which a resumable step function 
+         // processes without stopping.
+         struct resumable_step {
+            size_t size = 0; // in bits
+            std::unique_ptr<instructions::base> instructions;
+         };
+         
       public:
          // void __lu_bitpack_read_sector_0(struct lu_BitstreamState*);
          // void __lu_bitpack_save_sector_0(struct lu_BitstreamState*);
          std::vector<func_pair> per_sector;
          
+         // Only generated for sectors too large for one function (see the 
+         // `max_statements_per_function` option):
+         // void __lu_bitpack_read_sector_0_part_0(struct lu_BitstreamState*);
+         // void __lu_bitpack_save_sector_0_part_0(struct lu_BitstreamState*);
+         std::vector<func_pair> per_sector_parts;
+         
          // void __lu_bitpack_read(const buffer_byte_type* src, int sector_id);
          // void __lu_bitpack_save(buffer_byte_type* dst, int sector_id);
          optional_func_pair top_level;
          
          whole_struct_function_dictionary whole_struct;
          
+         // Only generated on request:
+         // int __lu_bitpack_sector_is_dirty_0(const buffer_byte_type* existing);
+         // int __lu_bitpack_sector_is_dirty(const buffer_byte_type* existing, int sector_id);
+         std::vector<gcc_wrappers::decl::function> dirty_check_per_sector;
+         gcc_wrappers::decl::optional_function     dirty_check_top_level;
+         
+         // Only generated on request:
+         // void __lu_bitpack_read_foo(const buffer_byte_type* (*get_sector)(int sector_id));
+         std::vector<gcc_wrappers::decl::function> per_identifier_read;
+         
+         // Only generated on request:
+         // int __lu_bitpack_read_step_sector_0(struct lu_BitstreamState*, int* cursor, int bit_budget);
+         // int __lu_bitpack_save_step_sector_0(struct lu_BitstreamState*, int* cursor, int bit_budget);
+         // int __lu_bitpack_read_step(struct lu_BitstreamState*, int sector_id, int* cursor, int bit_budget);
+         // int __lu_bitpack_save_step(struct lu_BitstreamState*, int sector_id, int* cursor, int bit_budget);
+         std::vector<func_pair> step_per_sector;
+         optional_func_pair     step_top_level;
+         
+         // Only generated if any sector is encoded as a table (see `codegen_mode`):
+         // void __lu_bitpack_read_table(struct lu_BitstreamState*, void* const* addresses, const uint32_t* words, const uint32_t* args);
+         // void __lu_bitpack_save_table(struct lu_BitstreamState*, void* const* addresses, const uint32_t* words, const uint32_t* args);
+         optional_func_pair table_interpreter;
+         
+         // Indices of the sectors whose read and save functions call the table 
+         // interpreter.
+         std::vector<size_t> table_sectors;
+         
+         // Applied to every function we generate (see the `function_attributes` 
+         // option).
+         gcc_wrappers::attribute_list function_attributes;
+      
+         // Which functions the current translation unit defines (see the 
+         // `sectors` and `emit_shared` options). Functions that we don't define 
+         // are still declared, so that the functions we do define can call 
+         // them.
+         struct {
+            size_t first_sector = 0;
+            size_t last_sector  = std::numeric_limits<size_t>::max();
+            bool   shared       = true;
+         } emitting;
+         
       protected:
+         bool _defines_sector(size_t) const;
+         
+         // Makes sure that every whole-struct function (or whole-struct dirty 
+         // check) that the given node tree calls exists. When we define shared 
+         // functions, we have to define these even for sectors whose functions 
+         // we don't define.
+         void _generate_whole_struct_functions_used_by(const instructions::base&, bool dirty_checks);
+         
+         // Generates functions that each process a run of the sector's top-level 
+         // nodes, of up to `max_statements` nodes in total, and returns calls to 
+         // them in order.
+         expr_pair _generate_sector_in_parts(
+            size_t sector_index,
+            const instructions::base&,
+            gcc_wrappers::type::function per_sector_function_type,
+            size_t max_statements,
+            const instructions::utils::generation_context& sector_context
+         );
+         
          void _generate_per_sector_functions(const generation_request&, const std::vector<std::unique_ptr<instructions::base>>& instructions_by_sector);
          bool _get_or_declare_top_level_functions(const generation_request&);
          void _generate_top_level_function(const generation_request&, size_t sector_count, bool is_read);
+         void _generate_top_level_dirty_check();
+         void _generate_top_level_step_function(bool is_read);
          
       public:
          bool generate(const generation_request&, const std::vector<std::unique_ptr<instructions::base>>&);
+         
+         // The instructions must be a separate tree from those used to generate 
+         // the read and save functions.
+         void generate_dirty_checks(const std::vector<std::unique_ptr<instructions::base>>&);
+         
+         // Generates a function that reads only the given identifier, fetching 
+         // only the sectors it spans. The spans must be in sector order, and 
+         // their instructions must be separate trees from those used to 
+         // generate any other function.
+         void generate_identifier_read(std::string_view identifier_name, const std::vector<identifier_span>&);
+         
+         // Generates functions that read or save a sector a bounded number of 
+         // bits at a time. The steps' instructions must be separate trees from 
+         // those used to generate any other function.
+         void generate_resumable_steps(const std::vector<std::vector<resumable_step>>& steps_by_sector);
    };
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <type_traits>
 #include <vector>
 #include "codegen/expr_pair.h"
+#include "gcc_wrappers/expr/base.h"
 
 namespace codegen::instructions::utils {
    struct generation_context;
@@ -27,6 +28,11 @@ namespace codegen::instructions {
          virtual type get_type() const noexcept {return (type)-1;}
          virtual expr_pair generate(const utils::generation_context&) const { assert(false && "abstract"); }
          
+         // Generates code that reads this node's data from a packed sector and 
+         // returns `1` from the enclosing function if it differs from the live 
+         // value. Values are accessed via the "save" side of their paths.
+         virtual gcc_wrappers::expr::base generate_dirty_check(const utils::generation_context&) const { assert(false && "abstract"); }
+         
       public:
          template<typename Subclass> requires std::is_base_of_v<base, Subclass>
          const Subclass* as() const noexcept {
@@ -58,6 +64,7 @@ namespace codegen::instructions {
          virtual type get_type() const noexcept override { return node_type; };
          
          virtual expr_pair generate(const utils::generation_context&) const;
+         virtual gcc_wrappers::expr::base generate_dirty_check(const utils::generation_context&) const;
          
       public:
          std::vector<std::unique_ptr<base>> instructions;
@@ -8,6 +8,7 @@ namespace codegen::instructions {
          virtual type get_type() const noexcept override { return node_type; };
          
          virtual expr_pair generate(const utils::generation_context&) const;
+         virtual gcc_wrappers::expr::base generate_dirty_check(const utils::generation_context&) const;
       
       public:
          size_t bitcount = 0;
@@ -1,5 +1,8 @@
 #pragma once
+#include <optional>
 #include "codegen/instructions/base.h"
+#include "codegen/array_access_info.h"
+#include "codegen/bit_slice_info.h"
 #include "codegen/expr_pair.h"
 #include "codegen/value_path.h"
 
@@ -10,10 +13,23 @@ namespace codegen::instructions {
          virtual type get_type() const noexcept override { return node_type; };
          
          virtual expr_pair generate(const utils::generation_context&) const;
+         virtual gcc_wrappers::expr::base generate_dirty_check(const utils::generation_context&) const;
       
+      protected:
+         // Generates just the calls to read and save the value.
+         expr_pair _generate_transfer(const utils::generation_context&) const;
+         
       public:
          value_path value;
          
+         // If set, then only these of the value's serialized bits are read or 
+         // saved; the rest are in another sector.
+         std::optional<bit_slice_info> bit_slice;
+         
+         // If set, then only these of an opaque buffer's or unterminated 
+         // string's bytes are read or saved; the rest are in another sector.
+         std::optional<array_access_info> byte_slice;
+         
          bool is_omitted_and_defaulted() const;
    };
 }
\ No newline at end of file
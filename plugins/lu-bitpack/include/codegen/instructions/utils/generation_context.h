@@ -1,14 +1,30 @@
 #pragma once
+#include <memory>
+#include "gcc_wrappers/attribute_list.h"
+#include "gcc_wrappers/decl/function.h"
+#include "gcc_wrappers/decl/result.h"
+#include "gcc_wrappers/expr/base.h"
 #include "gcc_wrappers/type/record.h"
+#include "gcc_wrappers/value.h"
 #include "codegen/func_pair.h"
 #include "codegen/optional_value_pair.h"
 #include "codegen/whole_struct_function_info.h"
 
 namespace codegen {
+   class decl_descriptor;
    class whole_struct_function_dictionary;
 }
 
 namespace codegen::instructions::utils {
+   // Produces the node tree for serializing an entire value, given its 
+   // descriptor: the whole struct pointed to by a PARM_DECL, or any other 
+   // value with a root VAR_DECL or PARM_DECL.
+   //
+   // A whole struct is always expanded into its members, even if it can't 
+   // be split otherwise (i.e. mixed-radix structs), if `whole_struct` is 
+   // true; whole-struct functions use this for their own node trees.
+   extern std::unique_ptr<instructions::base> make_instruction_tree_for(const decl_descriptor&, bool whole_struct = false);
+   
    struct generation_context {
       public:
          generation_context(whole_struct_function_dictionary& w) : whole_struct_functions(w) {}
@@ -16,10 +32,32 @@ namespace codegen::instructions::utils {
       public:
          whole_struct_function_dictionary& whole_struct_functions;
          optional_value_pair state_ptr;
+         
+         // Only set if checksums are enabled (and never set when generating 
+         // dirty checks): a pointer to the running checksum.
+         optional_value_pair checksum_ptr;
       
+         // Only set when generating dirty checks: the result variable of the 
+         // function we're generating, so that we can return early.
+         gcc_wrappers::decl::optional_result dirty_check_result;
+         
+         // Applied to every whole-struct function we generate (see the 
+         // `function_attributes` option of `generate_functions`).
+         gcc_wrappers::attribute_list function_attributes;
+      
+         // If false, whole-struct functions are only declared, as another 
+         // translation unit will define them (see the `emit_shared` option of 
+         // `generate_functions`).
+         bool define_whole_struct_functions = true;
+         
       protected:
          whole_struct_function_info _make_whole_struct_functions_for(gcc_wrappers::type::record) const;
+         void _make_whole_struct_dirty_check_for(gcc_wrappers::type::record) const;
       public:
          func_pair get_whole_struct_functions_for(gcc_wrappers::type::record) const;
+         gcc_wrappers::decl::function get_whole_struct_dirty_check_for(gcc_wrappers::type::record) const;
+         
+         // if (condition) return 1;
+         gcc_wrappers::expr::base make_dirty_check_return_if(gcc_wrappers::value condition) const;
    };
 }
\ No newline at end of file
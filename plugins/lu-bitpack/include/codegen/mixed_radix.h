@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "gcc_wrappers/expr/base.h"
+#include "gcc_wrappers/type/base.h"
+#include "gcc_wrappers/type/record.h"
+#include "gcc_wrappers/value.h"
+#include "codegen/expr_pair.h"
+#include "codegen/optional_value_pair.h"
+
+namespace bitpacking {
+   class data_options;
+}
+namespace codegen {
+   class decl_descriptor;
+}
+namespace codegen::instructions::utils {
+   struct generation_context;
+}
+
+//
+// Mixed-radix packing: rather than packing each member of a struct in its 
+// own whole number of bits, we treat each member as one digit of a larger 
+// integer, whose radix is the number of values the member can take. Three 
+// members in the range [0, 4] then take 7 bits (5 * 5 * 5 = 125 < 128) 
+// rather than 9.
+//
+// Digits are packed in member order, least significant first. Consecutive 
+// digits are grouped such that each group's combined range fits in 32 bits;
+// each group is then read or saved with a single bitstream call.
+//
+namespace codegen::mixed_radix {
+   struct digit {
+      const decl_descriptor* member = nullptr;
+      std::vector<size_t>    indices; // array element, if the member is an array
+      intmax_t  min   = 0;
+      uintmax_t radix = 0;
+   };
+   
+   struct group {
+      std::vector<digit> digits;
+      uintmax_t range    = 1; // product of the digits' radices
+      size_t    bitcount = 0;
+   };
+   
+   struct layout {
+      std::vector<group> groups;
+      size_t bitcount          = 0;
+      size_t unpacked_bitcount = 0; // if each member were packed on its own
+   };
+   
+   // True if values with these options and this serialized type are packed 
+   // as mixed-radix integers. Unnamed structs are always expanded in place, 
+   // so they can't be.
+   extern bool is_mixed_radix(const bitpacking::data_options&, gcc_wrappers::type::base serialized_type);
+   extern bool is_mixed_radix(const decl_descriptor&);
+   
+   // Returns an empty optional if any of the struct's members can't be 
+   // packed as a digit: they must all be integers or booleans (or arrays 
+   // thereof) with a range of at most 32 bits.
+   extern std::optional<layout> compute_layout(gcc_wrappers::type::record, bool report_errors = false);
+   
+   // Generates the body of a whole-struct read and save function, given the 
+   // struct to read into and the struct to save from.
+   extern expr_pair generate(
+      const layout&,
+      const optional_value_pair& structure,
+      const instructions::utils::generation_context&
+   );
+   
+   // Generates the body of a whole-struct dirty check, given the struct to 
+   // compare against.
+   extern gcc_wrappers::expr::base generate_dirty_check(
+      const layout&,
+      gcc_wrappers::value structure,
+      const instructions::utils::generation_context&
+   );
+}
\ No newline at end of file
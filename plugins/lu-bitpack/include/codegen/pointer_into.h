@@ -0,0 +1,34 @@
+#pragma once
+#include "gcc_wrappers/type/base.h"
+#include "gcc_wrappers/value.h"
+
+namespace bitpacking::typed_data_options::computed {
+   struct pointer;
+}
+
+//
+// Pointers into a known array: a pointer that can only be null or point to 
+// an element of some array is serialized as the element's index plus one, 
+// with zero standing for a null pointer. An array of 100 elements then takes 
+// 7 bits per pointer rather than 32, and saved data stays valid if the array 
+// moves between builds.
+//
+// A pointer that doesn't point into the array is saved as null. A pointer 
+// into the middle of an element is saved as that element.
+//
+namespace codegen::pointer_into {
+   // The bits to save for a pointer, as a `uint32_t`.
+   extern gcc_wrappers::value packed_bits_of(
+      const bitpacking::typed_data_options::computed::pointer&,
+      gcc_wrappers::value value
+   );
+   
+   // The pointer that serialized bits stand for, as the given pointer type. 
+   // Indices past the end of the array (i.e. from corrupt data) read back as 
+   // null pointers.
+   extern gcc_wrappers::value unpacked_value_of(
+      const bitpacking::typed_data_options::computed::pointer&,
+      gcc_wrappers::value      bits,
+      gcc_wrappers::type::base pointer_type
+   );
+}
\ No newline at end of file
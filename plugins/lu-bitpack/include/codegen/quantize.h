@@ -0,0 +1,34 @@
+#pragma once
+#include "gcc_wrappers/type/base.h"
+#include "gcc_wrappers/value.h"
+
+namespace bitpacking::typed_data_options::computed {
+   struct quantized;
+}
+
+//
+// Quantization: a floating-point value within a known range is scaled into 
+// a fixed number of bits, as `round((v - min) * steps / (max - min))` where 
+// `steps` is the largest value those bits can hold, and is rescaled when read 
+// back.
+//
+// An integer is instead divided into equally-sized buckets, one per value 
+// the bits can hold, and reads back as the lowest value in its bucket. This 
+// needs only integer arithmetic, and can't overflow.
+//
+// Values outside of the range are clamped to it when saved.
+//
+namespace codegen::quantize {
+   // The bits to save for a value, as a `uint32_t`.
+   extern gcc_wrappers::value packed_bits_of(
+      const bitpacking::typed_data_options::computed::quantized&,
+      gcc_wrappers::value value
+   );
+   
+   // The value that serialized bits stand for, as the given type.
+   extern gcc_wrappers::value unpacked_value_of(
+      const bitpacking::typed_data_options::computed::quantized&,
+      gcc_wrappers::value      bits,
+      gcc_wrappers::type::base value_type
+   );
+}
\ No newline at end of file
@@ -6,6 +6,8 @@
 namespace codegen::rechunked::chunks {
    enum class type {
       array_slice,
+      bit_slice,
+      byte_slice,
       condition,
       padding,
       qualified_decl,
@@ -0,0 +1,16 @@
+#pragma once
+#include "codegen/rechunked/chunks/base.h"
+#include "codegen/bit_slice_info.h"
+
+namespace codegen::rechunked::chunks {
+   class bit_slice : public base {
+      public:
+         static constexpr const type chunk_type = type::bit_slice;
+         virtual type get_type() const noexcept override { return chunk_type; }
+         
+         virtual bool compare(const base&) const noexcept override;
+         
+      public:
+         bit_slice_info data;
+   };
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+#include "codegen/rechunked/chunks/base.h"
+#include "codegen/array_access_info.h"
+
+namespace codegen::rechunked::chunks {
+   class byte_slice : public base {
+      public:
+         static constexpr const type chunk_type = type::byte_slice;
+         virtual type get_type() const noexcept override { return chunk_type; }
+         
+         virtual bool compare(const base&) const noexcept override;
+         
+      public:
+         array_access_info data;
+   };
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#pragma once
+#include <cstddef>
+#include "gcc_wrappers/value.h"
+
+namespace codegen {
+   // Given a pointer to a sector, produces a non-const `buffer_byte_type*` to 
+   // the byte that contains the given bit. The buffer byte type may be `void`, 
+   // so we index into the sector as an array of bytes.
+   extern gcc_wrappers::value sector_byte_containing(gcc_wrappers::value sector, size_t bit_offset);
+}
\ No newline at end of file
@@ -1,10 +1,13 @@
 #pragma once
 #include <memory> // GCC headers fuck up string-related STL identifiers that <memory> depends on
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 #include "gcc_wrappers/type/base.h"
 #include "codegen/serialization_items/segment.h"
 #include "codegen/array_access_info.h"
+#include "codegen/bit_slice_info.h"
 
 namespace bitpacking {
    class data_options;
@@ -27,6 +30,14 @@ namespace codegen {
          //
          std::vector<segment> segments;
          
+         // If set, then this item represents only some of a scalar value's 
+         // serialized bits; the rest are in another sector.
+         std::optional<bit_slice_info> bit_slice;
+         
+         // If set, then this item represents only some of an opaque buffer's 
+         // or unterminated string's bytes; the rest are in another sector.
+         std::optional<array_access_info> byte_slice;
+         
       public:
          void append_segment(const decl_descriptor&);
       
@@ -41,6 +52,14 @@ namespace codegen {
          
          bool can_expand() const;
          
+         // Whether this item is a scalar whose serialized bits can be divided 
+         // between sectors (see `split_bits`).
+         bool can_split_bits() const;
+         
+         // Whether this item is an opaque buffer or unterminated string whose 
+         // bytes can be divided between sectors (see `split_bytes`).
+         bool can_split_bytes() const;
+         
          bool is_opaque_buffer() const;
          bool is_padding() const;
          bool is_union() const;
@@ -60,6 +79,14 @@ namespace codegen {
       public:
          std::vector<serialization_item> expanded() const;
          
+         // Splits a scalar into two items: one for its first (least significant) 
+         // `bitcount` serialized bits, and one for the rest.
+         std::pair<serialization_item, serialization_item> split_bits(size_t bitcount) const;
+         
+         // Splits an opaque buffer or unterminated string into two items: one 
+         // for its first `bytecount` bytes, and one for the rest.
+         std::pair<serialization_item, serialization_item> split_bytes(size_t bytecount) const;
+         
          std::string to_string() const;
    };
 }
\ No newline at end of file
@@ -3,8 +3,40 @@
 #include "codegen/serialization_item.h"
 
 namespace codegen::serialization_item_list_ops {
+   struct division_options {
+      //
+      // If true, then an integer that can't fit in the bits left in a sector 
+      // will have its low bits placed there, and its high bits placed in the 
+      // next sector (see `serialization_item::split_bits`). Otherwise, it will 
+      // be pushed to the next sector whole.
+      //
+      bool split_scalars = false;
+      
+      //
+      // If true, then an opaque buffer or unterminated string that can't fit 
+      // in the bits left in a sector will have as many of its bytes as can 
+      // fit placed there, and the rest placed in the next sector (see 
+      // `serialization_item::split_bytes`).
+      //
+      bool split_buffers = false;
+      
+      //
+      // If true, then a tagged union that can't fit in the bits left in a 
+      // sector will have each of its branches laid out across the boundary, 
+      // with the branches padded to equal lengths within each sector. 
+      // Otherwise, it will be pushed to the next sector whole.
+      //
+      bool split_unions = false;
+   };
+   
+   //
+   // Sectors may differ in size: `sector_sizes_in_bits` lists the size of each 
+   // sector in turn, and the last size listed applies to all sectors after it. 
+   // (For sectors that are all the same size, list just the one size.)
+   //
    extern std::vector<std::vector<serialization_item>> divide_items_by_sectors(
-      size_t sector_size_in_bits,
-      std::vector<serialization_item> src
+      std::vector<size_t> sector_sizes_in_bits,
+      std::vector<serialization_item> src,
+      const division_options& options = {}
    );
 }
\ No newline at end of file
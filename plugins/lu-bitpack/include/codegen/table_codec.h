@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "codegen/instructions/base.h"
+#include "codegen/expr_pair.h"
+#include "codegen/func_pair.h"
+#include "codegen/optional_value_pair.h"
+#include "gcc_wrappers/decl/variable.h"
+
+namespace codegen::instructions::utils {
+   struct generation_context;
+}
+
+//
+// Table-driven codec: instead of generating straight-line code for a sector, 
+// we can flatten its node tree into a list of operations, emit that list as 
+// constant tables, and have a shared interpreter run through them. This can 
+// be far smaller than straight-line code, at some cost in speed.
+//
+// Each operation is encoded as one 32-bit word:
+//
+//    bits  0 -  5: bitcount
+//    bits  6 -  8: kind (see `op_kind`)
+//    bit   9     : the operation has a minimum
+//    bits 10 - 31: number of times to repeat the operation
+//
+// along with one address (of the first value the operation transfers), and 
+// zero or more 32-bit arguments, in this order: the minimum, if any; the 
+// length, for strings and buffers; and the stride in bytes between values, 
+// if the operation repeats. The word list ends with a zero word.
+//
+namespace codegen::table_codec {
+   enum class op_kind : uint8_t {
+      u8,
+      u16,
+      u32,
+      boolean,
+      string_nt,
+      string_ut,
+      buffer,
+   };
+   
+   struct op {
+      gcc_wrappers::decl::optional_variable root;
+      size_t  offset   = 0; // in bytes, from the start of `root`
+      op_kind kind     = op_kind::u8;
+      uint8_t bitcount = 0;
+      std::optional<intmax_t> min;
+      size_t  length   = 0; // for strings and buffers
+      size_t  count    = 1;
+      size_t  stride   = 0; // in bytes
+   };
+   
+   // Flattens a sector's node tree into a list of operations. Returns an 
+   // empty optional if the tree contains anything that a table can't 
+   // express, e.g. unions, transformed values, or values that aren't at 
+   // fixed addresses.
+   extern std::optional<std::vector<op>> compile(const instructions::base&, const instructions::utils::generation_context&);
+   
+   // Rough estimates, in bytes, of the code that would be generated for a 
+   // node tree (read and save functions combined), and of the tables that 
+   // would be generated for a list of operations. These are only used to 
+   // compare the two, so they needn't be exact.
+   extern size_t estimate_code_size(const instructions::base&);
+   extern size_t estimate_table_size(const std::vector<op>&);
+   
+   // void __lu_bitpack_read_table(struct lu_BitstreamState*, void* const* addresses, const uint32_t* words, const uint32_t* args);
+   // void __lu_bitpack_save_table(struct lu_BitstreamState*, void* const* addresses, const uint32_t* words, const uint32_t* args);
+   extern func_pair generate_interpreter();
+   
+   // Declares the interpreter without defining it, for translation units 
+   // that leave its definition to another (see the `emit_shared` option).
+   extern func_pair declare_interpreter();
+   
+   // Defines a sector's tables as file-scope constants, and returns calls to 
+   // the interpreter that run through them.
+   extern expr_pair generate_table_call(
+      size_t                     sector_index,
+      const std::vector<op>&,
+      func_pair                  interpreter,
+      const optional_value_pair& state_ptr
+   );
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "gcc_wrappers/value.h"
+
+namespace codegen::instructions::utils {
+   struct generation_context;
+}
+
+//
+// Value sets: an integral that can only take a handful of values, scattered 
+// across a wide range, is serialized as its index within the sorted set of 
+// values it can take, rather than as the value itself. Ten values between 1 
+// and 50000 then take 4 bits rather than 16.
+//
+// For each set, we define (once per translation unit) a constant table of its 
+// values, which maps indices back to values when reading; and a function that 
+// binary-searches that table, which maps values to indices when saving.
+//
+namespace codegen::value_set {
+   // The index to save for a value, as a `uint32_t`. A value that isn't in the 
+   // set is saved as the index of the smallest value above it, or of the 
+   // largest value if there is none.
+   extern gcc_wrappers::value index_of(
+      const std::vector<intmax_t>& set,
+      gcc_wrappers::value          value,
+      const instructions::utils::generation_context&
+   );
+   
+   // The value that a serialized index stands for. The index should have been 
+   // read with the set's bitcount; any such index past the end of the set 
+   // (i.e. from corrupt data) is clamped.
+   extern gcc_wrappers::value value_at(
+      const std::vector<intmax_t>& set,
+      gcc_wrappers::value          index
+   );
+}
\ No newline at end of file
@@ -13,10 +13,15 @@ namespace codegen {
       public:
          optional_func_pair get_functions_for(gcc_wrappers::type::base) const;
          const instructions::base* get_instructions_for(gcc_wrappers::type::base) const;
+         gcc_wrappers::decl::optional_function get_dirty_check_for(gcc_wrappers::type::base) const;
          
          // Asserts that functions don't already exist for the given struct type.
          void add_functions_for(gcc_wrappers::type::base, whole_struct_function_info&&);
          
+         // Asserts that read/save functions already exist for the given struct 
+         // type, and that a dirty check doesn't.
+         void add_dirty_check_for(gcc_wrappers::type::base, gcc_wrappers::decl::function, std::unique_ptr<instructions::base>&&);
+         
          template<typename Functor>
          void for_each(Functor&& functor) const {
             for(auto& pair : this->_functions) {
@@ -2,10 +2,19 @@
 #include <memory>
 #include "codegen/instructions/base.h"
 #include "codegen/func_pair.h"
+#include "gcc_wrappers/decl/function.h"
 
 namespace codegen {
    struct whole_struct_function_info {
       optional_func_pair functions;
       std::unique_ptr<instructions::base> instructions_root;
+      
+      // Only generated if a dirty check needs it. The dirty check uses its 
+      // own node tree, since nodes own the VAR_DECLs (e.g. loop counters) 
+      // that the code they generate refers to.
+      struct {
+         gcc_wrappers::decl::optional_function function;
+         std::unique_ptr<instructions::base>   instructions_root;
+      } dirty_check;
    };
 }
\ No newline at end of file
@@ -46,6 +46,9 @@ namespace gcc_wrappers::constant {
          
          std::string to_string() const;
          
+         // The value as the host's `long double`. May lose precision.
+         long double to_host_value() const;
+         
          template<typename Integral> requires std::is_integral_v<Integral>
          Integral to_integer() const {
             return (Integral) _to_host_wide_int();
@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+#include "gcc_wrappers/type/array.h"
+#include "gcc_wrappers/value.h"
+#include "gcc_wrappers/_node_boilerplate.define.h"
+
+namespace gcc_wrappers {
+   // A brace-enclosed initializer, i.e. a CONSTRUCTOR node.
+   class constructor : public value {
+      public:
+         static bool raw_node_is(tree t) {
+            return TREE_CODE(t) == CONSTRUCTOR;
+         }
+         GCC_NODE_WRAPPER_BOILERPLATE(constructor)
+         
+      public:
+         // Creates an initializer for an array. The elements must be constant 
+         // expressions (including address constants), so that the initializer 
+         // can be used for a static variable.
+         constructor(type::array, const std::vector<value>& elements);
+         
+         size_t size() const; // number of explicitly-initialized elements
+   };
+   DECLARE_GCC_OPTIONAL_NODE_WRAPPER(constructor);
+}
+
+#include "gcc_wrappers/_node_boilerplate.undef.h"
\ No newline at end of file
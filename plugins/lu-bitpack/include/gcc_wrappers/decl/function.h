@@ -74,6 +74,11 @@ namespace gcc_wrappers::decl {
          void make_nothrow();
          void set_is_nothrow(bool);
          
+         // Applies the given attributes as if they'd been written on this 
+         // declaration, running each attribute's handler (so that e.g. the 
+         // `section` attribute actually changes the function's section).
+         void apply_attributes(attribute_list);
+         
          bool has_body() const;
          
          // assert(!has_body());
@@ -36,6 +36,28 @@ namespace gcc_wrappers::expr {
             );
          }
          
+         // Call through a function pointer.
+         template<typename... Args> requires (std::is_base_of_v<value, Args> && ...)
+         call(value func_ptr, Args... args) {
+            auto ptr_type = func_ptr.value_type();
+            assert(ptr_type.is_pointer());
+            assert(ptr_type.remove_pointer().is_function());
+            auto func_type = ptr_type.remove_pointer().as_function();
+            if (!func_type.is_unprototyped()) {
+               if (func_type.is_varargs()) {
+                  assert(sizeof...(Args) >= func_type.fixed_argument_count());
+               } else {
+                  assert(sizeof...(Args) == func_type.fixed_argument_count());
+               }
+            }
+            this->_node = build_call_nary(
+               func_type.return_type().unwrap(),
+               func_ptr.unwrap(),
+               sizeof...(Args),
+               args.unwrap()...
+            );
+         }
+         
          // estimate; may fail
          decl::optional_function callee() const; // get_callee_fndecl
          
@@ -4,6 +4,7 @@
 #include <vector>
 #include "lu/singleton.h"
 #include "codegen/serialization_item.h"
+#include "codegen/whole_struct_function_dictionary.h"
 
 class last_generation_result;
 class last_generation_result : public lu::singleton<last_generation_result> {
@@ -22,6 +23,11 @@ class last_generation_result : public lu::singleton<last_generation_result> {
       } _items_by_sector;
       std::vector<sector_offset_info> offsets_by_sector_expanded;
       
+      // Kept so that code generated after the fact (e.g. accessors) can call 
+      // the whole-struct functions that were already generated, rather than 
+      // generating duplicates of them.
+      codegen::whole_struct_function_dictionary _whole_struct_functions;
+      
    public:
       constexpr bool empty() const noexcept { return this->_empty; }
       
@@ -34,7 +40,10 @@ class last_generation_result : public lu::singleton<last_generation_result> {
       
       size_t sector_count() const noexcept { return this->_items_by_sector.verbatim.size(); }
       
+      codegen::whole_struct_function_dictionary& whole_struct_functions() noexcept { return this->_whole_struct_functions; }
+      
       void update(
-         const sectored_item_list& items_by_sector
+         const sectored_item_list& items_by_sector,
+         codegen::whole_struct_function_dictionary&& whole_struct_functions
       );
 };
\ No newline at end of file
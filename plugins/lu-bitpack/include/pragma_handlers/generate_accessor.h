@@ -0,0 +1,7 @@
+#pragma once
+#include <gcc-plugin.h>
+#include <c-family/c-pragma.h>
+
+namespace pragma_handlers {
+   extern void generate_accessor(cpp_reader*);
+}
\ No newline at end of file
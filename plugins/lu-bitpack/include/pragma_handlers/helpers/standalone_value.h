@@ -0,0 +1,37 @@
+#pragma once
+#include <optional>
+#include <gcc-plugin.h>
+#include "codegen/decl_descriptor.h"
+#include "codegen/serialization_item.h"
+#include "gcc_wrappers/decl/variable.h"
+#include "gcc_wrappers/type/base.h"
+
+namespace pragma_handlers::helpers {
+   // A serialized value that generated code can read or write in place, without 
+   // touching the rest of its sector.
+   struct standalone_value {
+      size_t sector_index = 0;
+      size_t offset       = 0; // in bits, from the start of the sector
+      size_t size         = 0; // in bits
+      
+      // The value's type, minus any array ranks that the user indexed into.
+      gcc_wrappers::type::optional_base type;
+   };
+   
+   // Locates a value using the last generation result. Reports an error and 
+   // returns an empty optional if the value isn't serialized, or if it can't 
+   // be accessed on its own (e.g. if it's split across sectors).
+   extern std::optional<standalone_value> locate_standalone_value(
+      const codegen::serialization_item&,
+      location_t  pragma_loc,
+      const char* pragma_name
+   );
+   
+   // Produces a descriptor for a local variable of the value's type. Apart from 
+   // that, it's a copy of the value's own descriptor, so that code generated 
+   // for the local variable uses the same bitpacking options as the value.
+   extern codegen::decl_descriptor describe_standalone_value(
+      const codegen::serialization_item&,
+      gcc_wrappers::decl::variable
+   );
+}
\ No newline at end of file
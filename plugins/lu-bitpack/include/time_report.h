@@ -0,0 +1,100 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "lu/singleton.h"
+#include "gcc_wrappers/decl/function.h"
+
+//
+// Per-phase timing and counters for `#pragma lu_bitpack generate_functions`,
+// enabled via `-fplugin-arg-lu_bitpack-time-report`. If the argument's value
+// is a path ending in ".json", the report is written there as JSON; else, it
+// is printed to stderr when compilation finishes.
+//
+// Phase timings are exclusive: if one phase begins while another is active
+// (e.g. whole-struct functions being generated on demand while we build the
+// per-sector functions), the outer phase's clock is paused until the inner
+// phase ends.
+//
+class time_report;
+class time_report : public lu::singleton<time_report> {
+   public:
+      using clock = std::chrono::steady_clock;
+      
+      enum class phase {
+         describe,      // decl descriptors; describe_and_check_decl_tree
+         divide,        // divide_items_by_sectors
+         rechunk,       // rechunking; items_to_instruction_tree
+         generate,      // GENERIC for the per-sector and top-level functions
+         whole_struct,  // GENERIC for whole-struct functions
+         stats_and_xml, // stats_gatherer; report_generator
+      };
+      static constexpr const size_t phase_count = (size_t)phase::stats_and_xml + 1;
+      
+      struct phase_info {
+         clock::duration elapsed = clock::duration::zero();
+         size_t          entered = 0;
+      };
+      
+      // Brackets one run of `generate_functions`. This also makes the run show
+      // up as its own line in GCC's `-ftime-report` output, whether or not our
+      // own report is enabled.
+      class scoped_invocation {
+         public:
+            scoped_invocation();
+            ~scoped_invocation();
+            
+            scoped_invocation(const scoped_invocation&) = delete;
+            scoped_invocation& operator=(const scoped_invocation&) = delete;
+      };
+      
+      class scoped_phase {
+         protected:
+            bool _timed = false;
+         public:
+            scoped_phase(phase);
+            ~scoped_phase();
+            
+            scoped_phase(const scoped_phase&) = delete;
+            scoped_phase& operator=(const scoped_phase&) = delete;
+      };
+      
+   protected:
+      struct active_phase {
+         phase             id;
+         clock::time_point resumed_at;
+      };
+      std::vector<active_phase> _stack;
+      
+      void _push(phase);
+      void _pop();
+      
+   public:
+      bool        enabled = false;
+      std::string output_path; // empty = print to stderr
+      
+      size_t invocations = 0; // generate_functions runs
+      std::array<phase_info, phase_count> phases;
+      struct {
+         size_t serialization_items = 0;
+         size_t rechunked_chunks    = 0;
+         size_t instruction_nodes   = 0;
+         size_t tree_nodes          = 0; // reachable from generated function bodies
+      } counts;
+      
+   public:
+      static const char* name_of(phase);
+      
+      // Counts the GENERIC nodes reachable from a function's body.
+      static size_t count_tree_nodes_in_function(gcc_wrappers::decl::function);
+      
+      // Peak resident set size of the compiler process, in KiB.
+      static size_t peak_rss_kib();
+      
+      std::string to_json() const;
+      std::string to_text() const;
+      
+      // Invoked when GCC finishes compiling the translation unit.
+      void emit();
+};
@@ -0,0 +1,220 @@
+#include "attribute_handlers/bitpack_charset.h"
+#include <algorithm>
+#include <array>
+#include <cinttypes> // PRIdMAX and friends
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <c-family/c-common.h> // lookup_name
+#include "lu/strings/handle_kv_string.h"
+#include "attribute_handlers/helpers/bp_attr_context.h"
+#include "attribute_handlers/helpers/type_transitively_has_attribute.h"
+#include "attribute_handlers/generic_bitpacking_data_option.h"
+#include "gcc_wrappers/attribute_list.h"
+#include "gcc_wrappers/constant/integer.h"
+#include "gcc_wrappers/constant/string.h"
+#include "gcc_wrappers/decl/variable.h"
+#include "gcc_wrappers/type/array.h"
+#include "gcc_wrappers/builtin_types.h"
+#include "gcc_wrappers/identifier.h"
+#include "gcc_wrappers/list_node.h"
+namespace gw {
+   using namespace gcc_wrappers;
+}
+
+namespace attribute_handlers {
+   // Collects the characters in a constant array's initializer, given the 
+   // array's name. A character's index within the array is its code.
+   static void _load_charset_table(
+      std::string_view          name,
+      helpers::bp_attr_context& context,
+      std::vector<intmax_t>&    values
+   ) {
+      auto str = std::string(name);
+      if (str.empty()) {
+         context.report_error("specifies a blank charset table name");
+         return;
+      }
+      auto id   = gw::identifier(str.c_str());
+      auto node = lookup_name(id.unwrap());
+      if (node == NULL_TREE) {
+         context.report_error("specifies a charset table, %qE, that does not exist", id.unwrap());
+         return;
+      }
+      if (!gw::decl::variable::raw_node_is(node)) {
+         context.report_error("specifies a charset table, %qE, that is not a variable", id.unwrap());
+         return;
+      }
+      auto decl = gw::decl::variable::wrap(node);
+      auto type = decl.value_type();
+      if (!type.is_array() || !type.as_array().value_type().is_integral()) {
+         context.report_error("specifies a charset table, %qE, that is not an array of integers", id.unwrap());
+         return;
+      }
+      if (!type.as_array().value_type().is_const()) {
+         context.report_error("specifies a charset table, %qE, that is not %<const%>", id.unwrap());
+         return;
+      }
+      auto init = decl.initial_value();
+      if (!init || TREE_CODE(init->unwrap()) != CONSTRUCTOR) {
+         context.report_error("specifies a charset table, %qE, that has not been defined with a brace-enclosed initializer (it must be defined before this attribute is used)", id.unwrap());
+         return;
+      }
+      
+      unsigned HOST_WIDE_INT i;
+      tree v;
+      FOR_EACH_CONSTRUCTOR_VALUE(CONSTRUCTOR_ELTS(init->unwrap()), i, v) {
+         std::optional<intmax_t> value;
+         if (gw::constant::integer::raw_node_is(v))
+            value = gw::constant::integer::wrap(v).value<intmax_t>();
+         if (!value.has_value()) {
+            context.report_error("specifies a charset table, %qE, whose elements are not all integer constants", id.unwrap());
+            return;
+         }
+         values.push_back(*value);
+      }
+   }
+   
+   extern tree bitpack_charset(tree* node_ptr, tree name, tree args, int flags, bool* no_add_attrs) {
+      *no_add_attrs = false;
+      
+      auto result = generic_bitpacking_data_option(node_ptr, name, args, flags, no_add_attrs);
+      if (*no_add_attrs) {
+         return result;
+      }
+      
+      if (flags & ATTR_FLAG_INTERNAL) {
+         return NULL_TREE;
+      }
+      
+      helpers::bp_attr_context context(node_ptr, name, flags);
+      context.check_and_report_contradictory_x_options(helpers::x_option_type::string);
+      context.check_and_report_applied_to_string();
+      
+      struct {
+         std::optional<int>         bits;
+         std::optional<std::string> table;
+      } params;
+      {
+         auto data = TREE_VALUE(args);
+         if (data == NULL_TREE || !gw::constant::string::raw_node_is(data) || TREE_CHAIN(args) != NULL_TREE) {
+            context.report_error("must take a single string argument, of the form %<bits=...,table=...%>");
+            *no_add_attrs = true;
+            return NULL_TREE;
+         }
+         try {
+            lu::strings::handle_kv_string(gw::constant::string::wrap(data).value(), std::array{
+               lu::strings::kv_string_param{
+                  .name      = "bits",
+                  .has_param = true,
+                  .int_param = true,
+                  .handler   = [&params](std::string_view v, int vi) {
+                     params.bits = vi;
+                  },
+               },
+               lu::strings::kv_string_param{
+                  .name      = "table",
+                  .has_param = true,
+                  .handler   = [&params](std::string_view v, int vi) {
+                     params.table = v;
+                  },
+               },
+            });
+         } catch (std::runtime_error& ex) {
+            std::string message = "argument failed to parse: ";
+            message += ex.what();
+            context.report_error(message);
+            *no_add_attrs = true;
+            return NULL_TREE;
+         }
+      }
+      
+      if (!params.bits.has_value() && !params.table.has_value()) {
+         context.report_error("must specify a bitcount per character (%<bits=...%>), a charset table (%<table=...%>), or both");
+      }
+      if (params.bits.has_value()) {
+         if (*params.bits < 1 || *params.bits > 8) {
+            context.report_error("specifies an invalid bitcount per character, %u (must be between 1 and 8, inclusive)", *params.bits);
+         }
+      }
+      
+      std::vector<intmax_t> table;
+      if (params.table.has_value()) {
+         _load_charset_table(*params.table, context, table);
+         if (!context.has_any_errors()) {
+            if (table.empty()) {
+               context.report_error("specifies an empty charset table");
+            } else if (table.size() > 256) {
+               context.report_error("specifies a charset table with more than 256 characters");
+            } else if (params.bits.has_value() && table.size() > (size_t(1) << *params.bits)) {
+               context.report_error("specifies a charset table with %u characters, which is more than %u bits per character can encode", (int)table.size(), *params.bits);
+            }
+         }
+         if (!context.has_any_errors()) {
+            for(auto v : table) {
+               if (v < 0 || v > 255) {
+                  context.report_error("specifies a charset table containing a value, %r%" PRIdMAX "%R, that is not a single byte", "quote", v);
+                  break;
+               }
+            }
+         }
+         if (!context.has_any_errors()) {
+            //
+            // Each character must have only one code, or we couldn't know which 
+            // code to save it as.
+            //
+            auto sorted = table;
+            std::sort(sorted.begin(), sorted.end());
+            auto it = std::adjacent_find(sorted.begin(), sorted.end());
+            if (it != sorted.end()) {
+               context.report_error("specifies a charset table that lists a character, %r%" PRIdMAX "%R, more than once", "quote", *it);
+            }
+         }
+         if (!context.has_any_errors()) {
+            //
+            // A string that requires a null terminator must be able to save 
+            // one. We can't diagnose characters that are missing from the 
+            // table, since we don't know what the string will hold; those 
+            // are saved as code 0, and read back as the table's first 
+            // character.
+            //
+            bool nonstring = false;
+            {
+               auto list = context.get_existing_attributes();
+               nonstring = list.has_attribute("nonstring") || list.has_attribute("lu_nonstring");
+            }
+            if (!nonstring)
+               nonstring = helpers::type_transitively_has_attribute(context.type_of_target(), "lu_nonstring");
+            
+            if (!nonstring && std::find(table.begin(), table.end(), 0) == table.end()) {
+               context.report_error("specifies a charset table with no null terminator (%<0%>), but the string requires one");
+               if (!context.target_type()) {
+                  context.report_note("if this string does not require a null terminator, then applying %<__attribute__((nonstring))%> or %<__attribute__((lu_nonstring))%> before this attribute would allow this table");
+               } else {
+                  context.report_note("if these strings do not require null terminators, then applying %<__attribute__((lu_nonstring))%> before this attribute would allow this table");
+               }
+            }
+         }
+      }
+      
+      *no_add_attrs = true;
+      if (context.has_any_errors()) {
+         return NULL_TREE;
+      }
+      
+      //
+      // Reapply the attribute with the bitcount (or zero, if unspecified) and 
+      // the table's characters, so that we needn't parse the string or look 
+      // the table up again later.
+      //
+      const auto& ty = gw::builtin_types::get();
+      
+      gw::list_node list({}, gw::constant::integer(ty.basic_int, params.bits.value_or(0)));
+      for(auto v : table)
+         list.append({}, gw::constant::integer(ty.uint8, (int)v));
+      context.reapply_with_new_args(list);
+      return NULL_TREE;
+   }
+}
\ No newline at end of file
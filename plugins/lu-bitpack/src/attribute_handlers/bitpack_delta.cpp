@@ -0,0 +1,79 @@
+#include "attribute_handlers/bitpack_delta.h"
+#include <cstdint>
+#include <optional>
+#include "attribute_handlers/helpers/bp_attr_context.h"
+#include "attribute_handlers/generic_bitpacking_data_option.h"
+#include "gcc_wrappers/constant/integer.h"
+#include "gcc_wrappers/type/array.h"
+namespace gw {
+   using namespace gcc_wrappers;
+}
+
+namespace attribute_handlers {
+   // The bitstream functions can't read or write more than 32 bits at a time.
+   static constexpr const size_t max_bitcount = 32;
+   
+   extern tree bitpack_delta(tree* node_ptr, tree name, tree args, int flags, bool* no_add_attrs) {
+      auto result = generic_bitpacking_data_option(node_ptr, name, args, flags, no_add_attrs);
+      if (*no_add_attrs) {
+         return result;
+      }
+      
+      helpers::bp_attr_context context(node_ptr, name, flags);
+      context.check_and_report_contradictory_x_options(helpers::x_option_type::delta);
+      
+      auto type = context.type_of_target();
+      if (!type.is_array()) {
+         auto pp = type.pretty_print();
+         context.report_error("applied to type %qs, which is not an array; only arrays of [arrays of [...]] integers can be delta-encoded", pp.c_str());
+         *no_add_attrs = true;
+         return NULL_TREE;
+      }
+      auto array_type = type.as_array();
+      auto value_type = array_type.value_type();
+      while (value_type.is_array()) {
+         array_type = value_type.as_array();
+         value_type = array_type.value_type();
+      }
+      if (!value_type.is_integer()) {
+         auto pp = value_type.pretty_print();
+         context.report_error("applied to an array of type %qs, which is not an integer type", pp.c_str());
+      }
+      if (auto extent = array_type.extent(); !extent.has_value()) {
+         context.report_error("applied to a variable-length array; VLAs are not supported");
+      } else if (*extent == 0) {
+         context.report_error("applied to a zero-length array");
+      }
+      if (context.has_any_errors()) {
+         *no_add_attrs = true;
+         return NULL_TREE;
+      }
+      
+      std::optional<size_t> first_bits;
+      std::optional<size_t> delta_bits;
+      {
+         auto next = TREE_VALUE(args);
+         if (next != NULL_TREE && gw::constant::integer::raw_node_is(next))
+            first_bits = gw::constant::integer::wrap(next).value<size_t>();
+         args = TREE_CHAIN(args);
+         next = TREE_VALUE(args);
+         if (next != NULL_TREE && gw::constant::integer::raw_node_is(next))
+            delta_bits = gw::constant::integer::wrap(next).value<size_t>();
+      }
+      
+      size_t max_first = value_type.size_in_bits();
+      if (max_first > max_bitcount)
+         max_first = max_bitcount;
+      
+      if (!first_bits.has_value() || *first_bits == 0 || *first_bits > max_first) {
+         context.report_error("first argument (bitcount of the first element) must be an integer constant between 1 and %u", (int)max_first);
+      } else if (!delta_bits.has_value() || *delta_bits == 0 || *delta_bits > *first_bits) {
+         context.report_error("second argument (bitcount of each difference) must be an integer constant between 1 and the first argument, %u", (int)*first_bits);
+      }
+      
+      if (context.has_any_errors()) {
+         *no_add_attrs = true;
+      }
+      return NULL_TREE;
+   }
+}
\ No newline at end of file
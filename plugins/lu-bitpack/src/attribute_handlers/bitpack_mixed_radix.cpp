@@ -0,0 +1,36 @@
+#include "attribute_handlers/bitpack_mixed_radix.h"
+#include "attribute_handlers/helpers/bp_attr_context.h"
+#include "attribute_handlers/generic_bitpacking_data_option.h"
+namespace gw {
+   using namespace gcc_wrappers;
+}
+
+namespace attribute_handlers {
+   extern tree bitpack_mixed_radix(tree* node_ptr, tree name, tree args, int flags, bool* no_add_attrs) {
+      auto result = generic_bitpacking_data_option(node_ptr, name, args, flags, no_add_attrs);
+      if (*no_add_attrs) {
+         return result;
+      }
+      
+      helpers::bp_attr_context context(node_ptr, name, flags);
+      
+      //
+      // Whole-struct functions are generated per type, so this attribute 
+      // must be on the struct type itself, not on any one declaration of 
+      // it. Whether the struct's members are suitable is checked during 
+      // codegen, once their own bitpacking options are known.
+      //
+      auto type = context.target_type();
+      if (!type) {
+         context.report_error("applied to a declaration; it can only be applied to a struct type");
+      } else if (!type->is_record()) {
+         auto pp = type->pretty_print();
+         context.report_error("applied to non-struct type %qs", pp.c_str());
+      }
+      
+      if (context.has_any_errors()) {
+         *no_add_attrs = true;
+      }
+      return NULL_TREE;
+   }
+}
\ No newline at end of file
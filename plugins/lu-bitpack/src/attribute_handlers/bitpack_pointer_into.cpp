@@ -0,0 +1,122 @@
+#include "attribute_handlers/bitpack_pointer_into.h"
+#include <cstdint>
+#include <string>
+#include <c-family/c-common.h> // lookup_name
+#include "attribute_handlers/helpers/bp_attr_context.h"
+#include "attribute_handlers/generic_bitpacking_data_option.h"
+#include "gcc_wrappers/constant/string.h"
+#include "gcc_wrappers/decl/variable.h"
+#include "gcc_wrappers/type/array.h"
+#include "gcc_wrappers/identifier.h"
+#include "gcc_wrappers/list_node.h"
+namespace gw {
+   using namespace gcc_wrappers;
+}
+
+namespace attribute_handlers {
+   // Indices are read and saved with the 32-bit bitstream functions, and zero 
+   // is reserved for null pointers.
+   static constexpr const uintmax_t max_element_count = (uintmax_t(1) << 32) - 1;
+   
+   extern tree bitpack_pointer_into(tree* node_ptr, tree name, tree args, int flags, bool* no_add_attrs) {
+      *no_add_attrs = false;
+      
+      auto result = generic_bitpacking_data_option(node_ptr, name, args, flags, no_add_attrs);
+      if (*no_add_attrs) {
+         return result;
+      }
+      
+      if (flags & ATTR_FLAG_INTERNAL) {
+         return NULL_TREE;
+      }
+      
+      helpers::bp_attr_context context(node_ptr, name, flags);
+      context.check_and_report_contradictory_x_options(helpers::x_option_type::pointer);
+      
+      auto type = context.type_of_target();
+      while (type.is_array())
+         type = type.as_array().value_type();
+      if (!type.is_pointer()) {
+         auto pp = type.pretty_print();
+         context.report_error("applied to type %qs, which is not a pointer type", pp.c_str());
+         *no_add_attrs = true;
+         return NULL_TREE;
+      }
+      
+      //
+      // The argument is either the array itself, or its name as a string 
+      // (as with value tables; see `lu_bitpack_value_set`).
+      //
+      tree node = TREE_VALUE(args);
+      if (node != NULL_TREE && gw::constant::string::raw_node_is(node)) {
+         auto str = std::string(gw::constant::string::wrap(node).value());
+         if (str.empty()) {
+            context.report_error("argument, if it is a string, must name an array, and cannot be blank");
+            *no_add_attrs = true;
+            return NULL_TREE;
+         }
+         auto id = gw::identifier(str.c_str());
+         node = lookup_name(id.unwrap());
+         if (node == NULL_TREE) {
+            context.report_error("specifies an array, %qE, that does not exist", id.unwrap());
+            *no_add_attrs = true;
+            return NULL_TREE;
+         }
+      }
+      if (node != NULL_TREE && TREE_CODE(node) == ADDR_EXPR) {
+         //
+         // Allow `&array`.
+         //
+         node = TREE_OPERAND(node, 0);
+      }
+      if (node == NULL_TREE || !gw::decl::variable::raw_node_is(node)) {
+         context.report_error("argument must be an array variable, or a string naming one");
+         *no_add_attrs = true;
+         return NULL_TREE;
+      }
+      
+      auto decl = gw::decl::variable::wrap(node);
+      if (!TREE_STATIC(node) && !DECL_EXTERNAL(node)) {
+         //
+         // Generated functions can't see locals, and a local's address 
+         // wouldn't be the same from one call to the next anyway.
+         //
+         context.report_error("specifies an array, %qE, that does not have static storage duration", decl.unwrap());
+      }
+      
+      auto array_type = decl.value_type();
+      if (!array_type.is_array()) {
+         context.report_error("specifies a variable, %qE, that is not an array", decl.unwrap());
+      } else {
+         auto extent = array_type.as_array().extent();
+         if (!extent.has_value() || *extent == 0) {
+            context.report_error("specifies an array, %qE, that does not have a known, non-zero length (it must be declared with its length before this attribute is used)", decl.unwrap());
+         } else if (*extent > max_element_count) {
+            context.report_error("specifies an array, %qE, that has too many elements to index in 32 bits", decl.unwrap());
+         }
+         
+         auto element_type = array_type.as_array().value_type();
+         auto pointee_type = type.remove_pointer();
+         if (element_type.main_variant() != pointee_type.main_variant()) {
+            auto pp_a = pointee_type.pretty_print();
+            auto pp_b = element_type.pretty_print();
+            context.report_error("is applied to a pointer to %qs, but specifies an array, %qE, of %qs", pp_a.c_str(), decl.unwrap(), pp_b.c_str());
+         } else if (!element_type.is_complete() || element_type.size_in_bytes() == 0) {
+            auto pp = element_type.pretty_print();
+            context.report_error("specifies an array, %qE, whose elements (of type %qs) have no size", decl.unwrap(), pp.c_str());
+         }
+      }
+      
+      *no_add_attrs = true;
+      if (context.has_any_errors()) {
+         return NULL_TREE;
+      }
+      
+      //
+      // Reapply the attribute with the array's declaration, so that we needn't 
+      // look it up again later.
+      //
+      context.reapply_with_new_args(gw::list_node({}, decl));
+      return NULL_TREE;
+   }
+}
\ No newline at end of file
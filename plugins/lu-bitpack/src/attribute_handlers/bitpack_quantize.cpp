@@ -0,0 +1,117 @@
+#include "attribute_handlers/bitpack_quantize.h"
+#include <cinttypes> // PRIdMAX and friends
+#include <cstdint>
+#include <optional>
+#include "attribute_handlers/helpers/bp_attr_context.h"
+#include "attribute_handlers/generic_bitpacking_data_option.h"
+#include "gcc_wrappers/constant/floating_point.h"
+#include "gcc_wrappers/constant/integer.h"
+#include "gcc_wrappers/type/array.h"
+#include "gcc_wrappers/type/integral.h"
+#include <real.h> // REAL_MODE_FORMAT
+namespace gw {
+   using namespace gcc_wrappers;
+}
+
+namespace attribute_handlers {
+   // The bitstream functions can't read or write more than 32 bits at a time.
+   static constexpr const size_t max_bitcount = 32;
+   
+   extern tree bitpack_quantize(tree* node_ptr, tree name, tree args, int flags, bool* no_add_attrs) {
+      auto result = generic_bitpacking_data_option(node_ptr, name, args, flags, no_add_attrs);
+      if (*no_add_attrs) {
+         return result;
+      }
+      
+      helpers::bp_attr_context context(node_ptr, name, flags);
+      context.check_and_report_contradictory_x_options(helpers::x_option_type::quantized);
+      
+      auto type = context.type_of_target();
+      while (type.is_array())
+         type = type.as_array().value_type();
+      
+      bool is_float = type.is_floating_point();
+      if (!is_float && !type.is_integer()) {
+         auto pp = type.pretty_print();
+         context.report_error("applied to type %qs, which is neither a floating-point type nor an integer type", pp.c_str());
+         *no_add_attrs = true;
+         return NULL_TREE;
+      }
+      
+      //
+      // Integers must be quantized over an integer range; floats can use 
+      // either kind of constant.
+      //
+      auto _get_bound = [is_float](tree node) -> std::optional<long double> {
+         if (node == NULL_TREE)
+            return {};
+         if (gw::constant::integer::raw_node_is(node)) {
+            auto v = gw::constant::integer::wrap(node).value<intmax_t>();
+            if (!v.has_value())
+               return {};
+            return (long double)*v;
+         }
+         if (is_float && gw::constant::floating_point::raw_node_is(node)) {
+            auto c = gw::constant::floating_point::wrap(node);
+            if (c.is_nan() || c.is_any_infinity())
+               return {};
+            return c.to_host_value();
+         }
+         return {};
+      };
+      
+      std::optional<long double> min;
+      std::optional<long double> max;
+      std::optional<size_t>      bitcount;
+      {
+         min  = _get_bound(TREE_VALUE(args));
+         args = TREE_CHAIN(args);
+         max  = _get_bound(TREE_VALUE(args));
+         args = TREE_CHAIN(args);
+         
+         auto next = TREE_VALUE(args);
+         if (next != NULL_TREE && gw::constant::integer::raw_node_is(next))
+            bitcount = gw::constant::integer::wrap(next).value<size_t>();
+      }
+      
+      const char* const bound_kind = is_float ? "a finite number" : "an integer constant";
+      if (!min.has_value())
+         context.report_error("first argument (minimum value) must be %s", bound_kind);
+      if (!max.has_value())
+         context.report_error("second argument (maximum value) must be %s", bound_kind);
+      if (min.has_value() && max.has_value() && !(*min < *max))
+         context.report_error("minimum value (first argument) must be less than the maximum value (second argument)");
+      
+      if (!bitcount.has_value() || *bitcount == 0 || *bitcount > max_bitcount) {
+         context.report_error("third argument (bitcount) must be an integer constant between 1 and %u", (int)max_bitcount);
+      } else if (is_float) {
+         //
+         // Every quantized value must be exactly representable in the 
+         // floating-point type, or rounding could push a value past the 
+         // last one we can save.
+         //
+         size_t precision = REAL_MODE_FORMAT(TYPE_MODE(type.unwrap()))->p;
+         if (*bitcount > precision) {
+            auto pp = type.pretty_print();
+            context.report_error("third argument (bitcount) cannot exceed the precision of type %qs (%u bits)", pp.c_str(), (int)precision);
+         }
+      } else if (min.has_value() && max.has_value()) {
+         auto it = type.as_integral();
+         for(auto v : { (intmax_t)*min, (intmax_t)*max }) {
+            bool fits = v >= it.minimum_value();
+            if (fits && v > 0)
+               fits = (uintmax_t)v <= it.maximum_value();
+            if (!fits) {
+               auto pp = type.pretty_print();
+               context.report_error("specifies a bound, %r%" PRIdMAX "%R, that type %qs cannot hold", "quote", v, pp.c_str());
+               break;
+            }
+         }
+      }
+      
+      if (context.has_any_errors()) {
+         *no_add_attrs = true;
+      }
+      return NULL_TREE;
+   }
+}
\ No newline at end of file
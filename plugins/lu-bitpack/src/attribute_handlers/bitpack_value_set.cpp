@@ -0,0 +1,167 @@
+#include "attribute_handlers/bitpack_value_set.h"
+#include <algorithm>
+#include <cinttypes> // PRIdMAX and friends
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include <c-family/c-common.h> // lookup_name
+#include "attribute_handlers/helpers/bp_attr_context.h"
+#include "attribute_handlers/generic_bitpacking_data_option.h"
+#include "gcc_wrappers/constant/integer.h"
+#include "gcc_wrappers/constant/string.h"
+#include "gcc_wrappers/decl/variable.h"
+#include "gcc_wrappers/type/array.h"
+#include "gcc_wrappers/type/integral.h"
+#include "gcc_wrappers/identifier.h"
+#include "gcc_wrappers/list_node.h"
+namespace gw {
+   using namespace gcc_wrappers;
+}
+
+namespace attribute_handlers {
+   // Collects the values in a constant array's initializer, given the array's 
+   // name.
+   static void _load_value_table(
+      gw::constant::string      name,
+      helpers::bp_attr_context& context,
+      std::vector<intmax_t>&    values
+   ) {
+      auto str = std::string(name.value());
+      if (str.empty()) {
+         context.report_error("argument, if it is a string, must name a value table, and cannot be blank");
+         return;
+      }
+      auto id   = gw::identifier(str.c_str());
+      auto node = lookup_name(id.unwrap());
+      if (node == NULL_TREE) {
+         context.report_error("specifies a value table, %qE, that does not exist", id.unwrap());
+         return;
+      }
+      if (!gw::decl::variable::raw_node_is(node)) {
+         context.report_error("specifies a value table, %qE, that is not a variable", id.unwrap());
+         return;
+      }
+      auto decl = gw::decl::variable::wrap(node);
+      auto type = decl.value_type();
+      if (!type.is_array() || !type.as_array().value_type().is_integral()) {
+         context.report_error("specifies a value table, %qE, that is not an array of integers", id.unwrap());
+         return;
+      }
+      if (!type.as_array().value_type().is_const()) {
+         context.report_error("specifies a value table, %qE, that is not %<const%>", id.unwrap());
+         return;
+      }
+      auto init = decl.initial_value();
+      if (!init || TREE_CODE(init->unwrap()) != CONSTRUCTOR) {
+         context.report_error("specifies a value table, %qE, that has not been defined with an initializer (it must be defined before this attribute is used)", id.unwrap());
+         return;
+      }
+      
+      unsigned HOST_WIDE_INT i;
+      tree v;
+      FOR_EACH_CONSTRUCTOR_VALUE(CONSTRUCTOR_ELTS(init->unwrap()), i, v) {
+         std::optional<intmax_t> value;
+         if (gw::constant::integer::raw_node_is(v))
+            value = gw::constant::integer::wrap(v).value<intmax_t>();
+         if (!value.has_value()) {
+            context.report_error("specifies a value table, %qE, whose elements are not all integer constants", id.unwrap());
+            return;
+         }
+         values.push_back(*value);
+      }
+   }
+   
+   extern tree bitpack_value_set(tree* node_ptr, tree name, tree args, int flags, bool* no_add_attrs) {
+      *no_add_attrs = false;
+      
+      auto result = generic_bitpacking_data_option(node_ptr, name, args, flags, no_add_attrs);
+      if (*no_add_attrs) {
+         return result;
+      }
+      
+      if (flags & ATTR_FLAG_INTERNAL) {
+         return NULL_TREE;
+      }
+      
+      helpers::bp_attr_context context(node_ptr, name, flags);
+      context.check_and_report_applied_to_integral();
+      context.check_and_report_contradictory_x_options(helpers::x_option_type::integral);
+      
+      //
+      // The arguments are either the values themselves, as integer constants, 
+      // or the name of a constant array that lists them (i.e. a table that 
+      // the program already has).
+      //
+      std::vector<intmax_t> values;
+      {
+         auto first = TREE_VALUE(args);
+         if (first != NULL_TREE && gw::constant::string::raw_node_is(first)) {
+            if (TREE_CHAIN(args) != NULL_TREE) {
+               context.report_error("must take either a single string (the name of a value table) or one or more integer constants");
+            } else {
+               _load_value_table(gw::constant::string::wrap(first), context, values);
+            }
+         } else {
+            size_t i = 0;
+            for(; args != NULL_TREE; args = TREE_CHAIN(args), ++i) {
+               auto next = TREE_VALUE(args);
+               std::optional<intmax_t> value;
+               if (next != NULL_TREE && gw::constant::integer::raw_node_is(next))
+                  value = gw::constant::integer::wrap(next).value<intmax_t>();
+               if (!value.has_value()) {
+                  context.report_error("argument %u must be an integer constant", (int)i + 1);
+                  continue;
+               }
+               values.push_back(*value);
+            }
+         }
+      }
+      
+      std::sort(values.begin(), values.end());
+      values.erase(std::unique(values.begin(), values.end()), values.end());
+      if (values.empty() && !context.has_any_errors()) {
+         context.report_error("specifies an empty value set");
+      }
+      
+      //
+      // Every value must be one that the target can actually hold.
+      //
+      auto type = context.type_of_target();
+      while (type.is_array())
+         type = type.as_array().value_type();
+      if (!context.has_any_errors()) {
+         auto it = type.as_integral();
+         for(auto v : values) {
+            bool fits = v >= it.minimum_value();
+            if (fits && v > 0)
+               fits = (uintmax_t)v <= it.maximum_value();
+            if (!fits) {
+               auto pp = type.pretty_print();
+               context.report_error("specifies a value, %r%" PRIdMAX "%R, that type %qs cannot hold", "quote", v, pp.c_str());
+               break;
+            }
+         }
+      }
+      
+      *no_add_attrs = true;
+      if (context.has_any_errors()) {
+         return NULL_TREE;
+      }
+      
+      //
+      // Reapply the attribute with the final set, sorted and without duplicates, 
+      // so that we needn't look the value table up again later.
+      //
+      auto it = type.as_integral();
+      
+      auto _int = [&it](intmax_t v) {
+         return gw::constant::integer::wrap(build_int_cst(it.unwrap(), (HOST_WIDE_INT)v));
+      };
+      gw::list_node list({}, _int(values[0]));
+      for(size_t i = 1; i < values.size(); ++i)
+         list.append({}, _int(values[i]));
+      context.reapply_with_new_args(list);
+      return NULL_TREE;
+   }
+}
\ No newline at end of file
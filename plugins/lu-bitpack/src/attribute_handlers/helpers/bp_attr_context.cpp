@@ -163,15 +163,58 @@ namespace attribute_handlers::helpers {
       }
    }
    
+   void bp_attr_context::check_and_report_applied_to_string() {
+      auto type = type_of_target();
+      if (!type.is_array()) {
+         report_error("applied to a scalar type; only arrays of [arrays of [...]] single-byte values may be marked as strings");
+      } else {
+         gw::type::array array_type = type.as_array();
+         gw::type::base  value_type = array_type.value_type();
+         while (value_type.is_array()) {
+            array_type = value_type.as_array();
+            value_type = array_type.value_type();
+         }
+         auto extent_opt = array_type.extent();
+         if (!extent_opt.has_value()) {
+            report_error("applied to a variable-length array; VLAs are not supported");
+         } else {
+            size_t extent = *extent_opt;
+            if (extent == 0) {
+               report_error("applied to a zero-length array");
+            } else {
+               bool nonstring = false;
+               {
+                  auto list = get_existing_attributes();
+                  nonstring = list.has_attribute("nonstring") || list.has_attribute("lu_nonstring");
+               }
+               if (!nonstring && extent == 1) {
+                  report_error("applied to a zero-length string (array length is 1; terminator byte is required; ergo no room for any actual string content)");
+               }
+            }
+         }
+      }
+   }
+   
    bool bp_attr_context::_impl_check_x_options(tree subject, x_option_type here) {
       constexpr const auto attribs_buffer = std::array{
          "lu_bitpack_as_opaque_buffer",
       };
+      constexpr const auto attribs_delta = std::array{
+         "lu_bitpack_delta",
+      };
       constexpr const auto attribs_integral = std::array{
          "lu_bitpack_bitcount",
          "lu_bitpack_range",
+         "lu_bitpack_value_set",
+      };
+      constexpr const auto attribs_pointer = std::array{
+         "lu_bitpack_pointer_into",
+      };
+      constexpr const auto attribs_quantized = std::array{
+         "lu_bitpack_quantize",
       };
       constexpr const auto attribs_string = std::array{
+         "lu_bitpack_charset",
          "lu_bitpack_string",
       };
       constexpr const auto attribs_transforms = std::array{
@@ -202,10 +245,22 @@ namespace attribute_handlers::helpers {
          for(const char* name : attribs_buffer)
             if (_has(name))
                return true;
+      if (here != x_option_type::delta)
+         for(const char* name : attribs_delta)
+            if (_has(name))
+               return true;
       if (here != x_option_type::integral)
          for(const char* name : attribs_integral)
             if (_has(name))
                return true;
+      if (here != x_option_type::pointer)
+         for(const char* name : attribs_pointer)
+            if (_has(name))
+               return true;
+      if (here != x_option_type::quantized)
+         for(const char* name : attribs_quantized)
+            if (_has(name))
+               return true;
       if (here != x_option_type::string)
          for(const char* name : attribs_string)
             if (_has(name))
@@ -8,7 +8,7 @@ namespace gw {
    using namespace gcc_wrappers;
 }
 
-// For looking up memcpy and memset:
+// For looking up memcpy, memset, and friends:
 #include <c-family/c-common.h> // lookup_name
 
 #include <diagnostic.h>
@@ -71,4 +71,28 @@ void basic_global_state::pull_builtin_functions() {
          decl = bare;
       }
    }
+   {
+      auto& decl = this->builtin_functions.memcmp;
+      if (!decl) {
+         auto id   = gw::identifier("memcmp");
+         auto bare = lookup_name(id.unwrap());
+         if (bare == NULL_TREE) {
+            id   = gw::identifier("__builtin_memcmp");
+            bare = lookup_name(id.unwrap());
+         }
+         decl = bare;
+      }
+   }
+   {
+      auto& decl = this->builtin_functions.strncmp;
+      if (!decl) {
+         auto id   = gw::identifier("strncmp");
+         auto bare = lookup_name(id.unwrap());
+         if (bare == NULL_TREE) {
+            id   = gw::identifier("__builtin_strncmp");
+            bare = lookup_name(id.unwrap());
+         }
+         decl = bare;
+      }
+   }
 }
\ No newline at end of file
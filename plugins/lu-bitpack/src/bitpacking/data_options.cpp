@@ -6,6 +6,7 @@
 #include "bitpacking/verify_union_internal_tag.h"
 #include "bitpacking/verify_union_members.h"
 #include "basic_global_state.h"
+#include "gcc_wrappers/constant/floating_point.h"
 #include "gcc_wrappers/constant/integer.h"
 #include "gcc_wrappers/constant/string.h"
 #include "gcc_wrappers/decl/field.h"
@@ -75,8 +76,14 @@ namespace bitpacking {
          const auto& var = std::get<typed_data_options::requested_variant>(this->typed);
          if (std::holds_alternative<typed_data_options::requested::buffer>(var))
             seen_type = "buffer";
+         else if (std::holds_alternative<typed_data_options::requested::delta>(var))
+            seen_type = "delta";
          else if (std::holds_alternative<typed_data_options::requested::integral>(var))
             seen_type = "integral";
+         else if (std::holds_alternative<typed_data_options::requested::pointer>(var))
+            seen_type = "pointer";
+         else if (std::holds_alternative<typed_data_options::requested::quantized>(var))
+            seen_type = "quantized";
          else if (std::holds_alternative<typed_data_options::requested::string>(var))
             seen_type = "string";
          else if (std::holds_alternative<typed_data_options::requested::transformed>(var))
@@ -145,6 +152,10 @@ namespace bitpacking {
             this->misc_annotations.push_back(std::string(str.value()));
             continue;
          }
+         if (key == "lu_bitpack_mixed_radix") {
+            this->has_attr_mixed_radix = true;
+            continue;
+         }
          
          //
          // Typed data options:
@@ -158,6 +169,17 @@ namespace bitpacking {
             continue;
          }
          
+         // Delta:
+         if (key == "lu_bitpack_delta") {
+            if (this->_fail_if_cannot_load_as<typed_data_options::requested::delta>(target, node, "delta"))
+               continue;
+            auto& dst  = _get_or_emplace_for_load<typed_data_options::requested::delta>();
+            auto  args = attr.arguments();
+            dst.first_bits = *args[0].as<gw::constant::integer>().value<size_t>();
+            dst.delta_bits = *args[1].as<gw::constant::integer>().value<size_t>();
+            continue;
+         }
+         
          // Integral:
          if (key == "lu_bitpack_bitcount") {
             if (this->_fail_if_cannot_load_as<typed_data_options::requested::integral>(target, node, "integral"))
@@ -175,6 +197,41 @@ namespace bitpacking {
             dst.max = args[1].as<gw::constant::integer>().value<intmax_t>();
             continue;
          }
+         if (key == "lu_bitpack_value_set") {
+            if (this->_fail_if_cannot_load_as<typed_data_options::requested::integral>(target, node, "integral"))
+               continue;
+            auto& dst = _get_or_emplace_for_load<typed_data_options::requested::integral>();
+            dst.value_set.clear();
+            for(auto arg : attr.arguments())
+               dst.value_set.push_back(*arg.as<gw::constant::integer>().value<intmax_t>());
+            continue;
+         }
+         
+         // Pointer:
+         if (key == "lu_bitpack_pointer_into") {
+            if (this->_fail_if_cannot_load_as<typed_data_options::requested::pointer>(target, node, "pointer"))
+               continue;
+            auto& dst = _get_or_emplace_for_load<typed_data_options::requested::pointer>();
+            dst.into = attr.arguments().front().as<gw::decl::variable>();
+            continue;
+         }
+         
+         // Quantized:
+         if (key == "lu_bitpack_quantize") {
+            if (this->_fail_if_cannot_load_as<typed_data_options::requested::quantized>(target, node, "quantized"))
+               continue;
+            auto& dst  = _get_or_emplace_for_load<typed_data_options::requested::quantized>();
+            auto  args = attr.arguments();
+            auto  _get = [](gw::node arg) -> long double {
+               if (arg.is<gw::constant::floating_point>())
+                  return arg.as<gw::constant::floating_point>().to_host_value();
+               return (long double)*arg.as<gw::constant::integer>().value<intmax_t>();
+            };
+            dst.min      = _get(args[0]);
+            dst.max      = _get(args[1]);
+            dst.bitcount = *args[2].as<gw::constant::integer>().value<size_t>();
+            continue;
+         }
          
          // String:
          if (key == "lu_bitpack_string") {
@@ -184,6 +241,20 @@ namespace bitpacking {
             continue;
          }
          
+         if (key == "lu_bitpack_charset") {
+            if (this->_fail_if_cannot_load_as<typed_data_options::requested::string>(target, node, "string"))
+               continue;
+            auto& dst  = _get_or_emplace_for_load<typed_data_options::requested::string>();
+            auto  args = attr.arguments();
+            auto  bits = *args[0].as<gw::constant::integer>().value<size_t>();
+            if (bits != 0)
+               dst.char_bits = bits;
+            dst.charset.clear();
+            for(size_t i = 1; i < args.size(); ++i)
+               dst.charset.push_back(*args[i].as<gw::constant::integer>().value<uint8_t>());
+            continue;
+         }
+         
          // Tagged union:
          if (key == "lu_bitpack_union_external_tag") {
             if (this->_fail_if_cannot_load_as<typed_data_options::requested::tagged_union>(target, node, "union"))
@@ -264,11 +335,26 @@ namespace bitpacking {
          if (!dst.load(node, *casted, this->config.report_errors)) {
             this->_failed = true;
          }
+      } else if (auto* casted = std::get_if<typed_data_options::requested::delta>(&loaded)) {
+         auto& dst = dst_var.emplace<typed_data_options::computed::delta>();
+         if (!dst.load(node, *casted, this->config.report_errors)) {
+            this->_failed = true;
+         }
       } else if (auto* casted = std::get_if<typed_data_options::requested::integral>(&loaded)) {
          auto& dst = dst_var.emplace<typed_data_options::computed::integral>();
          if (!dst.load(node, *casted, this->config.report_errors)) {
             this->_failed = true;
          }
+      } else if (auto* casted = std::get_if<typed_data_options::requested::pointer>(&loaded)) {
+         auto& dst = dst_var.emplace<typed_data_options::computed::pointer>();
+         if (!dst.load(node, *casted, this->config.report_errors)) {
+            this->_failed = true;
+         }
+      } else if (auto* casted = std::get_if<typed_data_options::requested::quantized>(&loaded)) {
+         auto& dst = dst_var.emplace<typed_data_options::computed::quantized>();
+         if (!dst.load(node, *casted, this->config.report_errors)) {
+            this->_failed = true;
+         }
       } else if (auto* casted = std::get_if<typed_data_options::requested::string>(&loaded)) {
          auto& dst = dst_var.emplace<typed_data_options::computed::string>();
          dst.nonstring = this->has_attr_nonstring;
@@ -330,7 +416,8 @@ namespace bitpacking {
                   //
                   dst_var.emplace<typed_data_options::computed::pointer>();
                } else if (value_type->is_record()) {
-                  dst_var.emplace<typed_data_options::computed::structure>();
+                  auto& dst = dst_var.emplace<typed_data_options::computed::structure>();
+                  dst.mixed_radix = this->has_attr_mixed_radix;
                } else {
                   //
                   // Unrecognized type.
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <bit>
 #include "bitpacking/data_options/typed.h"
 #include "gcc_wrappers/decl/base_value.h"
@@ -50,6 +51,44 @@ namespace bitpacking::typed_data_options::computed {
       return true;
    }
    
+   //
+   // delta
+   //
+   
+   bool delta::load(gw::node target, const requested::delta& src, bool complain) {
+      gw::type::optional_array array_type;
+      if (target.is<gw::decl::base_value>()) {
+         auto type = target.as<gw::decl::base_value>().value_type();
+         if (type.is_array())
+            array_type = type.as_array();
+      } else if (target.is<gw::type::array>()) {
+         array_type = target.as<gw::type::array>();
+      }
+      if (!array_type) {
+         if (complain) {
+            error_at(_loc(target), "delta bitpacking options cannot be applied to something that is not an array");
+         }
+         return false;
+      }
+      auto value_type = array_type->value_type();
+      while (value_type.is_array()) {
+         array_type = value_type.as_array();
+         value_type = array_type->value_type();
+      }
+      
+      auto ex_opt = array_type->extent();
+      if (!ex_opt.has_value() || *ex_opt == 0) {
+         if (complain) {
+            error_at(_loc(target), "delta bitpacking options cannot be applied to a variable-length or zero-length array");
+         }
+         return false;
+      }
+      this->first_bits = src.first_bits;
+      this->delta_bits = src.delta_bits;
+      this->length     = *ex_opt;
+      return true;
+   }
+   
    //
    // integral
    //
@@ -62,6 +101,24 @@ namespace bitpacking::typed_data_options::computed {
             bitwidth = decl.size_in_bits();
       }
       
+      if (!src.value_set.empty()) {
+         if (src.bitcount.has_value() || src.min.has_value() || src.max.has_value()) {
+            if (complain) {
+               error_at(_loc(target), "invalid bitpacking options for this integral: a value set cannot be combined with a bitcount or range");
+            }
+            return false;
+         }
+         //
+         // The attribute handler will have already sorted the set and removed 
+         // any duplicates.
+         //
+         this->value_set = src.value_set;
+         this->min       = this->value_set.front();
+         this->max       = this->value_set.back();
+         this->bitcount  = std::bit_width(this->value_set.size() - 1);
+         return true;
+      }
+      
       if (src.bitcount.has_value()) {
          this->bitcount = *src.bitcount;
          if (src.min.has_value()) {
@@ -116,6 +173,64 @@ namespace bitpacking::typed_data_options::computed {
       return true;
    }
    
+   //
+   // pointer
+   //
+   
+   bool pointer::load(gw::node target, const requested::pointer& src, bool complain) {
+      this->into = src.into;
+      if (!this->into)
+         return true;
+      
+      auto extent = this->into->value_type().as_array().extent();
+      if (!extent.has_value() || *extent == 0) {
+         if (complain) {
+            error_at(_loc(target), "failed to apply bitpacking options: the array that this pointer points into, %qE, does not have a known, non-zero length", this->into->unwrap());
+         }
+         return false;
+      }
+      //
+      // Zero stands for a null pointer, so indices are offset by one.
+      //
+      this->element_count = *extent;
+      this->bitcount      = std::bit_width(this->element_count);
+      return true;
+   }
+   
+   //
+   // quantized
+   //
+   
+   bool quantized::load(gw::node target, const requested::quantized& src, bool complain) {
+      auto type = _get_innermost_value_type(target);
+      if (!type) {
+         if (complain) {
+            error_at(_loc(target), "failed to apply bitpacking options: we cannot figure out what value type we are applying them to, for some reason, and we need to know whether it is an integer or a floating-point value in order to quantize it");
+         }
+         return false;
+      }
+      this->bitcount    = src.bitcount;
+      this->min         = src.min;
+      this->max         = src.max;
+      this->is_integral = type->is_integral();
+      return true;
+   }
+   
+   long double quantized::step() const {
+      uintmax_t steps = (uintmax_t(1) << this->bitcount) - 1;
+      if (this->is_integral) {
+         //
+         // Integers are divided into equal buckets, each of which reads back 
+         // as its lowest value. The buckets must cover every value in the 
+         // range, i.e. ceil((range + 1) / (steps + 1)), which we compute in a 
+         // way that can't overflow.
+         //
+         uintmax_t range = (uintmax_t)(intmax_t)this->max - (uintmax_t)(intmax_t)this->min;
+         return (long double)(range / (steps + 1) + 1);
+      }
+      return (this->max - this->min) / (long double)steps;
+   }
+   
    //
    // string
    //
@@ -156,6 +271,23 @@ namespace bitpacking::typed_data_options::computed {
          assert(this->length > 0); // should've been validated by the attribute handler
          --this->length; // we require a null terminator, which eats into the array length
       }
+      
+      this->charset = src.charset;
+      if (src.char_bits.has_value()) {
+         this->char_bits = *src.char_bits;
+      } else if (!this->charset.empty()) {
+         this->char_bits = std::bit_width(this->charset.size() - 1);
+         if (this->char_bits == 0)
+            this->char_bits = 1;
+      }
+      if (!this->charset.empty() && !this->nonstring) {
+         if (std::find(this->charset.begin(), this->charset.end(), 0) == this->charset.end()) {
+            if (complain) {
+               error_at(_loc(target), "string bitpacking options specify a charset with no null terminator, but the string requires one (if it doesn't, mark it with %<lu_nonstring%>)");
+            }
+            return false;
+         }
+      }
       return true;
    }
    
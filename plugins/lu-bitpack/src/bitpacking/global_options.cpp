@@ -1,4 +1,5 @@
 #include "bitpacking/global_options.h"
+#include <algorithm> // std::find, std::max_element
 #include "lu/stringf.h"
 #include "bitpacking/requested_global_options.h"
 #include "gcc_wrappers/type/helpers/lookup_by_name.h"
@@ -62,6 +63,28 @@ namespace bitpacking {
          else
             dst = std::numeric_limits<size_t>::max();
       }
+      this->sectors.sizes.clear();
+      if (auto& opt = src.sectors.sizes; opt.has_value()) {
+         const auto& list = opt->data;
+         if (src.sectors.bytes_per.has_value()) {
+            error_at(opt->loc.key, "options %<sector_size%> and %<sector_sizes%> cannot be used together");
+            this->invalid = true;
+         } else if (src.sectors.max_count.has_value() && src.sectors.max_count->data != list.size()) {
+            error_at(opt->loc.data, "option %<sector_sizes%> lists %u sizes, but option %<sector_count%> is %u", (int)list.size(), (int)src.sectors.max_count->data);
+            this->invalid = true;
+         } else if (std::find(list.begin(), list.end(), 0) != list.end()) {
+            error_at(opt->loc.data, "option %<sector_sizes%> lists a sector size of zero");
+            this->invalid = true;
+         } else {
+            //
+            // Anything that only cares about the largest sector, or about how 
+            // many sectors there are, can keep using those options as usual.
+            //
+            this->sectors.sizes     = list;
+            this->sectors.max_count = list.size();
+            this->sectors.bytes_per = *std::max_element(list.begin(), list.end());
+         }
+      }
       
       //
       // Type options:
@@ -114,6 +137,21 @@ namespace bitpacking {
          _missing_option(src, "buffer_byte_typename");
       }
       
+      if (auto& opt = src.types.checksum; opt.has_value()) {
+         auto id   = opt->data;
+         auto type = gw::type::lookup_by_name(id);
+         if (!type) {
+            error_at(opt->loc.data, "identifier %qE does not name a type", id.unwrap());
+            this->invalid = true;
+         } else if (!type->is_integral()) {
+            error_at(opt->loc.data, "identifier %qE names a non-integral type", id.unwrap());
+            this->invalid = true;
+         } else {
+            this->types.checksum     = type;
+            this->types.checksum_ptr = type->add_pointer();
+         }
+      }
+      
       //
       // Resolve functions:
       //
@@ -151,6 +189,44 @@ namespace bitpacking {
          _missing_option(src, "func_initialize");
       }
       
+      // u32 lu_ChecksumUpdate(u32 checksum, uint32_t value, uint8_t bitcount)
+      if (auto& opt = src.functions.checksum_update; opt.has_value()) {
+         auto loc  = opt->loc.data;
+         auto fopt = _get_function_or_fail(loc, opt->data);
+         if (!src.types.checksum.has_value()) {
+            error_at(loc, "option %<func_checksum_update%> requires option %<checksum_type%>");
+            this->invalid = true;
+         } else if (fopt && this->types.checksum) {
+            auto decl = *fopt;
+            auto type = decl.function_type();
+            if (type.has_signature(
+               false,
+               false,
+               true,
+               *this->types.checksum,
+               std::array<gw::type::base, 3>{
+                  *this->types.checksum,
+                  ty.uint32,
+                  ty.uint8
+               }
+            )) {
+               this->functions.checksum_update = decl;
+            } else {
+               error_at(
+                  loc,
+                  "the specified function has the wrong signature (expected: %<%s %s(%s checksum, uint32_t value, uint8_t bitcount)%>)",
+                  this->types.checksum->name().data(),
+                  decl.name().data(),
+                  this->types.checksum->name().data()
+               );
+               this->invalid = true;
+            }
+         }
+      } else if (auto& opt = src.types.checksum; opt.has_value()) {
+         error_at(opt->loc.key, "option %<checksum_type%> requires option %<func_checksum_update%>");
+         this->invalid = true;
+      }
+      
       // bitstream read
       {
          constexpr const char* operation = "read";
@@ -459,4 +535,15 @@ namespace bitpacking {
          return type.is_type_or_transitive_typedef_thereof(*this->types.boolean);
       return false;
    }
+   
+   size_t global_options::sector_size(size_t n) const {
+      const auto& sizes = this->sectors.sizes;
+      if (n < sizes.size())
+         return sizes[n];
+      return this->sectors.bytes_per;
+   }
+   
+   bool global_options::checksums_enabled() const {
+      return !!this->functions.checksum_update;
+   }
 }
\ No newline at end of file
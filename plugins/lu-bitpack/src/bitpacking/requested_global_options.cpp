@@ -13,7 +13,7 @@ namespace gw {
 
 namespace bitpacking {
    std::optional<requested_global_options::identifier_option>* requested_global_options::_id_option_for_key(std::string_view key) {
-      if (key == "sector_count" || key == "sector_size")
+      if (key == "sector_count" || key == "sector_size" || key == "sector_sizes")
          return nullptr;
       
       if (key == "bitstream_state_typename")
@@ -22,12 +22,17 @@ namespace bitpacking {
          return &this->types.boolean;
       if (key == "buffer_byte_typename")
          return &this->types.buffer_byte;
+      if (key == "checksum_type")
+         return &this->types.checksum;
       
       if (key.starts_with("func_")) {
          key.remove_prefix(5);
          if (key == "initialize") {
             return &this->functions.stream_state_init;
          }
+         if (key == "checksum_update") {
+            return &this->functions.checksum_update;
+         }
          function_set* fset = nullptr;
          if (key.starts_with("read_")) {
             fset = &this->functions.read;
@@ -74,6 +79,40 @@ namespace bitpacking {
       return nullptr;
    }
    
+   /*static*/ size_t requested_global_options::_parse_size(std::string_view key, cpp_ttype token_type, tree data, location_t loc) {
+      if (token_type != CPP_NUMBER) {
+         throw pragma_parse_exception(
+            loc,
+            "expected positive integer constant value for key %<%s%>; got something other than a number; pragma ignored",
+            key.data()
+         );
+      }
+      if (TREE_CODE(data) != INTEGER_CST) {
+         throw pragma_parse_exception(
+            loc,
+            "expected positive integer constant value for key %<%s%>; got some other kind of number instead; pragma ignored",
+            key.data()
+         );
+      }
+      auto node = gw::constant::integer::wrap(data);
+      if (node.sign() < 0) {
+         throw pragma_parse_exception(
+            loc,
+            "expected positive integer constant value for key %<%s%>; got a negative integer instead; pragma ignored",
+            key.data()
+         );
+      }
+      auto node_v = node.try_value_unsigned();
+      if (!node_v.has_value()) {
+         throw pragma_parse_exception(
+            loc,
+            "expected positive integer constant value for key %<%s%>; got an integer but could not read it (too large?); pragma ignored",
+            key.data()
+         );
+      }
+      return *node_v;
+   }
+   
    requested_global_options::requested_global_options(cpp_reader& reader) {
       tree dummy_token = NULL_TREE;
       if (pragma_lex(&dummy_token, &this->pragma_location) != CPP_OPEN_PAREN) {
@@ -152,41 +191,42 @@ namespace bitpacking {
             dst_v.loc.data = loc;
          } else if (auto* dst = _size_option_for_key(key)) {
             token_type = pragma_lex(&data, &loc);
-            if (token_type != CPP_NUMBER) {
-               throw pragma_parse_exception(
-                  loc,
-                  "expected positive integer constant value for key %<%s%>; got something other than a number; pragma ignored",
-                  key.data()
-               );
-            }
-            if (TREE_CODE(data) != INTEGER_CST) {
-               throw pragma_parse_exception(
-                  loc,
-                  "expected positive integer constant value for key %<%s%>; got some other kind of number instead; pragma ignored",
-                  key.data()
-               );
-            }
-            auto node = gw::constant::integer::wrap(data);
-            if (node.sign() < 0) {
-               throw pragma_parse_exception(
-                  loc,
-                  "expected positive integer constant value for key %<%s%>; got a negative integer instead; pragma ignored",
-                  key.data()
-               );
-            }
-            auto node_v = node.try_value_unsigned();
-            if (!node_v.has_value()) {
+            
+            auto& dst_v = dst->emplace();
+            dst_v.data      = _parse_size(key, token_type, data, loc);
+            dst_v.loc.key  = key_loc;
+            dst_v.loc.data = loc;
+         } else if (key == "sector_sizes") {
+            //
+            // A parenthesized, comma-separated list of sizes, one per sector.
+            //
+            token_type = pragma_lex(&data, &loc);
+            if (token_type != CPP_OPEN_PAREN) {
                throw pragma_parse_exception(
                   loc,
-                  "expected positive integer constant value for key %<%s%>; got an integer but could not read it (too large?); pragma ignored",
+                  "expected %<(%> to begin the list of sizes for key %<%s%>; pragma ignored",
                   key.data()
                );
             }
-            
-            auto& dst_v = dst->emplace();
-            dst_v.data      = *node_v;
+            auto& dst_v = this->sectors.sizes.emplace();
             dst_v.loc.key  = key_loc;
             dst_v.loc.data = loc;
+            do {
+               location_t item_loc;
+               token_type = pragma_lex(&data, &item_loc);
+               dst_v.data.push_back(_parse_size(key, token_type, data, item_loc));
+               
+               token_type = pragma_lex(&data, &item_loc);
+               if (token_type == CPP_CLOSE_PAREN)
+                  break;
+               if (token_type != CPP_COMMA) {
+                  throw pragma_parse_exception(
+                     item_loc,
+                     "expected %<,%> or %<)%> in the list of sizes for key %<%s%>; pragma ignored",
+                     key.data()
+                  );
+               }
+            } while (true);
          } else {
             warning_at(key_loc, OPT_Wpragmas, "unrecognized key %<%s%>; ignoring value and skipping to the next %<,%> or %<)%> in the pragma", key.data());
             do {
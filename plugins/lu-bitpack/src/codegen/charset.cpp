@@ -0,0 +1,299 @@
+#include "codegen/charset.h"
+#include <cassert>
+#include <functional>
+#include <map>
+#include "lu/stringf.h"
+#include "lu/strings/zview.h"
+#include "bitpacking/data_options/typed.h"
+#include "bitpacking/global_options.h"
+#include "basic_global_state.h"
+#include "codegen/instructions/utils/generation_context.h"
+#include "gcc_wrappers/constant/integer.h"
+#include "gcc_wrappers/decl/variable.h"
+#include "gcc_wrappers/expr/assign.h"
+#include "gcc_wrappers/expr/call.h"
+#include "gcc_wrappers/expr/local_block.h"
+#include "gcc_wrappers/flow/simple_for_loop.h"
+#include "gcc_wrappers/flow/simple_if_else_set.h"
+#include "gcc_wrappers/type/array.h"
+#include "gcc_wrappers/type/integral.h"
+#include "gcc_wrappers/builtin_types.h"
+#include "gcc_wrappers/constructor.h"
+#include "gcc_wrappers/statement_list.h"
+namespace gw {
+   using namespace gcc_wrappers;
+}
+namespace typed_options {
+   using namespace bitpacking::typed_data_options::computed;
+}
+
+namespace codegen::charset {
+   namespace {
+      struct _entry {
+         size_t id = 0;
+         gw::decl::optional_variable characters;
+         gw::decl::optional_variable codes;
+      };
+   }
+   
+   // A plug-in instance only ever compiles one translation unit, so this is 
+   // effectively per translation unit.
+   static std::map<std::vector<uint8_t>, _entry> _entries;
+   
+   static _entry& _get_entry(const std::vector<uint8_t>& table) {
+      auto it = _entries.find(table);
+      if (it != _entries.end())
+         return it->second;
+      
+      auto& entry = _entries[table];
+      entry.id = _entries.size() - 1;
+      return entry;
+   }
+   
+   static gw::value _u8(uint8_t v) {
+      const auto& ty = gw::builtin_types::get();
+      return gw::constant::integer(ty.uint8, v);
+   }
+   
+   static gw::decl::variable _make_table(const std::string& name, const std::vector<uint8_t>& values) {
+      const auto& ty = gw::builtin_types::get();
+      
+      auto array_type = ty.uint8.add_const().add_array_extent(values.size());
+      
+      std::vector<gw::value> elements;
+      for(auto v : values)
+         elements.push_back(_u8(v));
+      
+      gw::decl::variable var(name, array_type);
+      var.make_artificial();
+      var.set_initial_value(gw::constructor(array_type, elements));
+      var.make_read_only();
+      var.make_file_scope_extern();
+      var.set_is_externally_accessible(false);
+      var.set_is_defined_elsewhere(false);
+      return var;
+   }
+   
+   // static const uint8_t __lu_bitpack_charset_0[] = { ... };
+   static gw::decl::variable _get_character_table(const std::vector<uint8_t>& table) {
+      auto& entry = _get_entry(table);
+      if (!entry.characters)
+         entry.characters = _make_table(lu::stringf("__lu_bitpack_charset_%u", (int)entry.id), table);
+      return *entry.characters;
+   }
+   
+   // static const uint8_t __lu_bitpack_charset_0_codes[256] = { ... };
+   // Characters that aren't in the table map to code 0, and so read back as 
+   // the table's first character.
+   static gw::decl::variable _get_code_table(const std::vector<uint8_t>& table) {
+      auto& entry = _get_entry(table);
+      if (!entry.codes) {
+         std::vector<uint8_t> codes(256, 0);
+         for(size_t i = 0; i < table.size(); ++i)
+            codes[table[i]] = (uint8_t)i;
+         entry.codes = _make_table(lu::stringf("__lu_bitpack_charset_%u_codes", (int)entry.id), codes);
+      }
+      return *entry.codes;
+   }
+   
+   // *checksum = func_checksum_update(*checksum, code, bitcount);
+   static gw::expr::base _update_checksum(gw::value checksum_ptr, gw::value code, size_t bitcount) {
+      const auto& ty     = gw::builtin_types::get();
+      const auto& global = basic_global_state::get().global_options;
+      assert(!!global.functions.checksum_update);
+      
+      auto checksum = checksum_ptr.dereference();
+      return gw::expr::assign(
+         checksum,
+         gw::expr::call(
+            *global.functions.checksum_update,
+            // args:
+            checksum,
+            code.convert_to_integer(ty.uint32),
+            gw::constant::integer(ty.uint8, bitcount)
+         )
+      );
+   }
+   
+   static gw::decl::variable _declare_local(gw::statement_list& statements, lu::strings::zview name, gw::type::base type) {
+      gw::decl::variable decl(name, type);
+      decl.make_artificial();
+      decl.make_used();
+      statements.append(decl.make_declare_expr());
+      return decl;
+   }
+   
+   // Loops over a string's characters, computing the code that a save would 
+   // write for each one, and hands each code to `per_code` to build the rest 
+   // of the loop body.
+   static gw::expr::base _for_each_code_to_save(
+      const typed_options::string& options,
+      gw::value                    array,
+      std::function<void(gw::statement_list&, gw::value code)> per_code
+   ) {
+      const auto& ty = gw::builtin_types::get();
+      
+      gw::expr::local_block block;
+      auto statements = block.statements();
+      
+      auto ch = _declare_local(statements, "__lu_bitpack_char", ty.uint8).as_value();
+      
+      gw::optional_value ended;
+      if (!options.nonstring) {
+         ended = _declare_local(statements, "__lu_bitpack_ended", ty.uint8).as_value();
+         statements.append(gw::expr::assign(*ended, _u8(0)));
+      }
+      
+      gw::flow::simple_for_loop loop(ty.basic_int);
+      loop.counter_bounds = {
+         .start     = 0,
+         .last      = (uintmax_t)(options.length - 1),
+         .increment = 1,
+      };
+      
+      gw::statement_list loop_body;
+      loop_body.append(gw::expr::assign(
+         ch,
+         array.access_array_element(loop.counter.as_value()).convert_to_integer(ty.uint8)
+      ));
+      if (ended) {
+         //
+         // Everything after the terminator is saved as the terminator.
+         //
+         gw::flow::simple_if_else_set branches;
+         branches.add_branch(
+            ended->cmp_is_not_equal(_u8(0)),
+            gw::expr::assign(ch, _u8(0))
+         );
+         branches.add_branch(
+            ch.cmp_is_equal(_u8(0)),
+            gw::expr::assign(*ended, _u8(1))
+         );
+         loop_body.append(*branches.result);
+      }
+      
+      gw::value code = ch;
+      if (!options.charset.empty()) {
+         code = _get_code_table(options.charset).as_value().access_array_element(ch);
+      } else if (options.char_bits < 8) {
+         //
+         // Characters are their own codes, so long as they fit.
+         //
+         gw::flow::simple_if_else_set branches;
+         branches.add_branch(
+            ch.cmp_is_greater_or_equal(_u8(1 << options.char_bits)),
+            gw::expr::assign(ch, _u8(0))
+         );
+         loop_body.append(*branches.result);
+      }
+      per_code(loop_body, code);
+      
+      loop.bake(std::move(loop_body));
+      statements.append(loop.enclosing);
+      return block;
+   }
+   
+   extern expr_pair generate(
+      const typed_options::string&                   options,
+      const optional_value_pair&                     array,
+      const instructions::utils::generation_context& ctxt
+   ) {
+      const auto& ty     = gw::builtin_types::get();
+      const auto& global = basic_global_state::get().global_options;
+      assert(!!global.functions.read.u8);
+      assert(!!global.functions.save.u8);
+      
+      auto ic_bitcount = gw::constant::integer(ty.uint8, options.char_bits);
+      
+      gw::expr::local_block block_read;
+      {
+         auto statements = block_read.statements();
+         auto array_read = *array.read;
+         auto char_type  = array_read.value_type().as_array().value_type().with_all_qualifiers_stripped().as_integral();
+         auto code       = _declare_local(statements, "__lu_bitpack_code", ty.uint8).as_value();
+         
+         gw::flow::simple_for_loop loop(ty.basic_int);
+         loop.counter_bounds = {
+            .start     = 0,
+            .last      = (uintmax_t)(options.length - 1),
+            .increment = 1,
+         };
+         
+         gw::statement_list loop_body;
+         loop_body.append(gw::expr::assign(
+            code,
+            gw::expr::call(
+               *global.functions.read.u8,
+               // args:
+               *ctxt.state_ptr.read,
+               ic_bitcount
+            )
+         ));
+         if (ctxt.checksum_ptr.read) {
+            loop_body.append(_update_checksum(*ctxt.checksum_ptr.read, code, options.char_bits));
+         }
+         
+         gw::value ch = code;
+         if (!options.charset.empty()) {
+            auto index = code;
+            if (options.charset.size() < (size_t(1) << options.char_bits)) {
+               //
+               // Codes past the end of the table can only come from corrupt 
+               // data. Don't index past the end of the table.
+               //
+               index = index.min(_u8(options.charset.size() - 1));
+            }
+            ch = _get_character_table(options.charset).as_value().access_array_element(index);
+         }
+         loop_body.append(gw::expr::assign(
+            array_read.access_array_element(loop.counter.as_value()),
+            ch.convert_to_integer(char_type)
+         ));
+         
+         loop.bake(std::move(loop_body));
+         statements.append(loop.enclosing);
+         
+         if (!options.nonstring) {
+            statements.append(gw::expr::assign(
+               array_read.access_array_element(gw::constant::integer(ty.basic_int, options.length)),
+               gw::constant::integer(char_type, 0)
+            ));
+         }
+      }
+      
+      auto block_save = _for_each_code_to_save(options, *array.save, [&](gw::statement_list& body, gw::value code) {
+         if (ctxt.checksum_ptr.save) {
+            body.append(_update_checksum(*ctxt.checksum_ptr.save, code, options.char_bits));
+         }
+         body.append(gw::expr::call(
+            *global.functions.save.u8,
+            // args:
+            *ctxt.state_ptr.save,
+            code,
+            ic_bitcount
+         ));
+      });
+      
+      return expr_pair(block_read, block_save);
+   }
+   
+   extern gw::expr::base generate_dirty_check(
+      const typed_options::string&                   options,
+      gw::value                                      array,
+      const instructions::utils::generation_context& ctxt
+   ) {
+      const auto& ty     = gw::builtin_types::get();
+      const auto& global = basic_global_state::get().global_options;
+      assert(!!global.functions.read.u8);
+      
+      return _for_each_code_to_save(options, array, [&](gw::statement_list& body, gw::value code) {
+         gw::value packed = gw::expr::call(
+            *global.functions.read.u8,
+            // args:
+            *ctxt.state_ptr.read,
+            gw::constant::integer(ty.uint8, options.char_bits)
+         );
+         body.append(ctxt.make_dirty_check_return_if(packed.cmp_is_not_equal(code)));
+      });
+   }
+}
\ No newline at end of file
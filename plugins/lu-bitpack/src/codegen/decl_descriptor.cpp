@@ -3,6 +3,7 @@
 #include <memory> // GCC headers fuck up string-related STL identifiers that <memory> depends on
 #include "codegen/decl_descriptor.h"
 #include "codegen/decl_dictionary.h"
+#include "codegen/mixed_radix.h"
 #include "gcc_wrappers/constant/string.h"
 #include "gcc_wrappers/type/array.h"
 #include "gcc_wrappers/type/container.h"
@@ -29,12 +30,16 @@ namespace codegen {
             is_string = true;
          }
       }
-      if (is_string) {
+      bool is_delta = this->options.is<typed_options::delta>() && !this->options.is_omitted;
+      if (is_string || is_delta) {
          assert(this->types.basic_type.is_array());
          //
          // For strings, we strip all array ranks except for the innermost one, 
          // and we consider the innermost array rank a "string." For example, 
-         // the type `char foo[5][8]` is an array of five strings.
+         // the type `char foo[5][8]` is an array of five strings. Delta-encoded 
+         // arrays are treated the same way, since each element is encoded 
+         // relative to the one before it (unless they're omitted, in which 
+         // case defaults apply to each element as usual).
          //
          auto array_type = this->types.basic_type.as_array();
          auto value_type = array_type.value_type();
@@ -163,16 +168,33 @@ namespace codegen {
       if (this->options.is<typed_options::buffer>())
          return this->options.as<typed_options::buffer>().bytecount * 8;
       
+      if (this->options.is<typed_options::delta>())
+         return this->options.as<typed_options::delta>().bitcount();
+      
       if (this->options.is<typed_options::integral>())
          return this->options.as<typed_options::integral>().bitcount;
       
-      if (this->options.is<typed_options::pointer>())
+      if (this->options.is<typed_options::pointer>()) {
+         const auto& ptr_opt = this->options.as<typed_options::pointer>();
+         if (ptr_opt.into)
+            return ptr_opt.bitcount;
          return this->types.serialized->size_in_bits();
+      }
+      
+      if (this->options.is<typed_options::quantized>())
+         return this->options.as<typed_options::quantized>().bitcount;
       
-      if (this->options.is<typed_options::string>())
-         return this->options.as<typed_options::string>().length * 8;
+      if (this->options.is<typed_options::string>()) {
+         const auto& str_opt = this->options.as<typed_options::string>();
+         return str_opt.length * str_opt.char_bits;
+      }
       
       auto type = *this->types.serialized;
+      if (mixed_radix::is_mixed_radix(*this)) {
+         auto layout = mixed_radix::compute_layout(type.as_record());
+         if (layout)
+            return layout->bitcount;
+      }
       if (type.is_record()) {
          size_t total = 0;
          for(auto* desc : this->members_of_serialized()) {
@@ -223,14 +245,26 @@ namespace codegen {
          if (transformed_type_options.is<typed_options::buffer>())
             return transformed_type_options.as<typed_options::buffer>().bytecount * 8;
          
+         if (transformed_type_options.is<typed_options::delta>())
+            return transformed_type_options.as<typed_options::delta>().bitcount();
+         
          if (transformed_type_options.is<typed_options::integral>())
             return transformed_type_options.as<typed_options::integral>().bitcount;
          
-         if (transformed_type_options.is<typed_options::pointer>())
+         if (transformed_type_options.is<typed_options::pointer>()) {
+            const auto& ptr_opt = transformed_type_options.as<typed_options::pointer>();
+            if (ptr_opt.into)
+               return ptr_opt.bitcount;
             return type.size_in_bits();
+         }
          
-         if (transformed_type_options.is<typed_options::string>())
-            return transformed_type_options.as<typed_options::string>().length * 8;
+         if (transformed_type_options.is<typed_options::quantized>())
+            return transformed_type_options.as<typed_options::quantized>().bitcount;
+         
+         if (transformed_type_options.is<typed_options::string>()) {
+            const auto& str_opt = transformed_type_options.as<typed_options::string>();
+            return str_opt.length * str_opt.char_bits;
+         }
       }
       
       assert(this->options.is_omitted && "We don't know the serialized size of this value. If it's not omitted, we're in trouble!");
@@ -0,0 +1,250 @@
+#include "codegen/delta.h"
+#include <cassert>
+#include <functional>
+#include "lu/strings/zview.h"
+#include "bitpacking/data_options/typed.h"
+#include "bitpacking/global_options.h"
+#include "basic_global_state.h"
+#include "codegen/instructions/utils/generation_context.h"
+#include "gcc_wrappers/constant/integer.h"
+#include "gcc_wrappers/decl/variable.h"
+#include "gcc_wrappers/expr/assign.h"
+#include "gcc_wrappers/expr/call.h"
+#include "gcc_wrappers/expr/local_block.h"
+#include "gcc_wrappers/flow/simple_for_loop.h"
+#include "gcc_wrappers/type/array.h"
+#include "gcc_wrappers/type/integral.h"
+#include "gcc_wrappers/builtin_types.h"
+#include "gcc_wrappers/statement_list.h"
+#include <fold-const.h> // fold_build3
+namespace gw {
+   using namespace gcc_wrappers;
+}
+namespace typed_options {
+   using namespace bitpacking::typed_data_options::computed;
+}
+
+namespace codegen::delta {
+   // `gw::constant::integer` can only be built from an `int`, which can't 
+   // hold every 32-bit maximum.
+   static gw::value _int(gw::type::integral type, uintmax_t v) {
+      return gw::constant::integer::wrap(build_int_cst(type.unwrap(), (HOST_WIDE_INT)v));
+   }
+   
+   // `condition ? a : b`, where the operands are values rather than 
+   // statements.
+   static gw::value _select(gw::type::base type, gw::value condition, gw::value a, gw::value b) {
+      return gw::value::wrap(fold_build3(
+         COND_EXPR,
+         type.unwrap(),
+         condition.unwrap(),
+         a.unwrap(),
+         b.unwrap()
+      ));
+   }
+   
+   static uintmax_t _max_for_bitcount(size_t bitcount) {
+      return (uintmax_t(1) << bitcount) - 1;
+   }
+   
+   // Do the math in unsigned types, so that corrupt data wraps rather than 
+   // overflowing.
+   static gw::type::integral _work_type_for(gw::type::base element_type) {
+      const auto& ty = gw::builtin_types::get();
+      if (element_type.size_in_bits() > 32)
+         return ty.uint64;
+      return ty.uint32;
+   }
+   
+   // *checksum = func_checksum_update(*checksum, bits, bitcount);
+   static gw::expr::base _update_checksum(gw::value checksum_ptr, gw::value bits, size_t bitcount) {
+      const auto& ty     = gw::builtin_types::get();
+      const auto& global = basic_global_state::get().global_options;
+      assert(!!global.functions.checksum_update);
+      
+      auto checksum = checksum_ptr.dereference();
+      return gw::expr::assign(
+         checksum,
+         gw::expr::call(
+            *global.functions.checksum_update,
+            // args:
+            checksum,
+            bits.convert_to_integer(ty.uint32),
+            gw::constant::integer(ty.uint8, bitcount)
+         )
+      );
+   }
+   
+   static gw::decl::variable _declare_local(gw::statement_list& statements, lu::strings::zview name, gw::type::base type) {
+      gw::decl::variable decl(name, type);
+      decl.make_artificial();
+      decl.make_used();
+      statements.append(decl.make_declare_expr());
+      return decl;
+   }
+   
+   static gw::flow::simple_for_loop _make_loop(const typed_options::delta& options) {
+      const auto& ty = gw::builtin_types::get();
+      
+      gw::flow::simple_for_loop loop(ty.basic_int);
+      loop.counter_bounds = {
+         .start     = 1,
+         .last      = (uintmax_t)(options.length - 1),
+         .increment = 1,
+      };
+      return loop;
+   }
+   
+   // Walks an array's elements, computing the bits that a save would write 
+   // for each one, and hands them to `per_value` along with their bitcount, 
+   // to build the rest of the code that handles them.
+   static gw::expr::base _for_each_value_to_save(
+      const typed_options::delta& options,
+      gw::value                   array,
+      std::function<void(gw::statement_list&, gw::value bits, size_t bitcount)> per_value
+   ) {
+      const auto& ty = gw::builtin_types::get();
+      
+      auto element_type = array.value_type().as_array().value_type().with_all_qualifiers_stripped().as_integral();
+      auto work_type    = _work_type_for(element_type);
+      
+      gw::expr::local_block block;
+      auto statements = block.statements();
+      
+      auto total = _declare_local(statements, "__lu_bitpack_delta_total", work_type).as_value();
+      auto value = _declare_local(statements, "__lu_bitpack_delta_value", work_type).as_value();
+      auto bits  = _declare_local(statements, "__lu_bitpack_delta_bits", work_type).as_value();
+      
+      auto _element = [&array, &element_type, &work_type](gw::value index) -> gw::value {
+         auto v = array.access_array_element(index);
+         if (element_type.is_signed())
+            v = v.max(gw::constant::integer(element_type, 0));
+         return v.convert_to_integer(work_type);
+      };
+      
+      //
+      // The first element is saved whole.
+      //
+      statements.append(gw::expr::assign(
+         total,
+         _element(gw::constant::integer(ty.basic_int, 0)).min(_int(work_type, _max_for_bitcount(options.first_bits)))
+      ));
+      per_value(statements, total, options.first_bits);
+      
+      if (options.length > 1) {
+         auto loop = _make_loop(options);
+         
+         gw::statement_list loop_body;
+         loop_body.append(gw::expr::assign(value, _element(loop.counter.as_value())));
+         loop_body.append(gw::expr::assign(
+            bits,
+            _select(
+               work_type,
+               value.cmp_is_greater(total),
+               value.sub(total),
+               _int(work_type, 0)
+            ).min(_int(work_type, _max_for_bitcount(options.delta_bits)))
+         ));
+         per_value(loop_body, bits, options.delta_bits);
+         loop_body.append(gw::expr::assign(total, total.add(bits)));
+         
+         loop.bake(std::move(loop_body));
+         statements.append(loop.enclosing);
+      }
+      return block;
+   }
+   
+   extern expr_pair generate(
+      const typed_options::delta&                    options,
+      const optional_value_pair&                     array,
+      const instructions::utils::generation_context& ctxt
+   ) {
+      const auto& ty     = gw::builtin_types::get();
+      const auto& global = basic_global_state::get().global_options;
+      assert(!!global.functions.read.u32);
+      assert(!!global.functions.save.u32);
+      
+      gw::expr::local_block block_read;
+      {
+         auto statements   = block_read.statements();
+         auto array_read   = *array.read;
+         auto element_type = array_read.value_type().as_array().value_type().with_all_qualifiers_stripped().as_integral();
+         auto work_type    = _work_type_for(element_type);
+         
+         auto total = _declare_local(statements, "__lu_bitpack_delta_total", work_type).as_value();
+         auto bits  = _declare_local(statements, "__lu_bitpack_delta_bits", ty.uint32).as_value();
+         
+         auto _read = [&](gw::statement_list& dst, size_t bitcount) {
+            dst.append(gw::expr::assign(
+               bits,
+               gw::expr::call(
+                  *global.functions.read.u32,
+                  // args:
+                  *ctxt.state_ptr.read,
+                  gw::constant::integer(ty.uint8, bitcount)
+               )
+            ));
+            if (ctxt.checksum_ptr.read) {
+               dst.append(_update_checksum(*ctxt.checksum_ptr.read, bits, bitcount));
+            }
+         };
+         
+         _read(statements, options.first_bits);
+         statements.append(gw::expr::assign(total, bits.convert_to_integer(work_type)));
+         statements.append(gw::expr::assign(
+            array_read.access_array_element(gw::constant::integer(ty.basic_int, 0)),
+            total.convert_to_integer(element_type)
+         ));
+         
+         if (options.length > 1) {
+            auto loop = _make_loop(options);
+            
+            gw::statement_list loop_body;
+            _read(loop_body, options.delta_bits);
+            loop_body.append(gw::expr::assign(total, total.add(bits.convert_to_integer(work_type))));
+            loop_body.append(gw::expr::assign(
+               array_read.access_array_element(loop.counter.as_value()),
+               total.convert_to_integer(element_type)
+            ));
+            
+            loop.bake(std::move(loop_body));
+            statements.append(loop.enclosing);
+         }
+      }
+      
+      auto block_save = _for_each_value_to_save(options, *array.save, [&](gw::statement_list& body, gw::value bits, size_t bitcount) {
+         if (ctxt.checksum_ptr.save) {
+            body.append(_update_checksum(*ctxt.checksum_ptr.save, bits, bitcount));
+         }
+         body.append(gw::expr::call(
+            *global.functions.save.u32,
+            // args:
+            *ctxt.state_ptr.save,
+            bits.convert_to_integer(ty.uint32),
+            gw::constant::integer(ty.uint8, bitcount)
+         ));
+      });
+      
+      return expr_pair(block_read, block_save);
+   }
+   
+   extern gw::expr::base generate_dirty_check(
+      const typed_options::delta&                    options,
+      gw::value                                      array,
+      const instructions::utils::generation_context& ctxt
+   ) {
+      const auto& ty     = gw::builtin_types::get();
+      const auto& global = basic_global_state::get().global_options;
+      assert(!!global.functions.read.u32);
+      
+      return _for_each_value_to_save(options, array, [&](gw::statement_list& body, gw::value bits, size_t bitcount) {
+         gw::value packed = gw::expr::call(
+            *global.functions.read.u32,
+            // args:
+            *ctxt.state_ptr.read,
+            gw::constant::integer(ty.uint8, bitcount)
+         );
+         body.append(ctxt.make_dirty_check_return_if(packed.cmp_is_not_equal(bits.convert_to_integer(ty.uint32))));
+      });
+   }
+}
\ No newline at end of file
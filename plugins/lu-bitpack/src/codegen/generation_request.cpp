@@ -4,6 +4,7 @@
 #include "gcc_wrappers/scope.h"
 #include <c-family/c-common.h> // lookup_name
 #include <stringpool.h> // get_identifier
+#include <attribs.h> // canonicalize_attr_name
 #include <diagnostic.h>
 #include "gcc_helpers/c/at_file_scope.h"
 namespace gw {
@@ -15,6 +16,98 @@ constexpr const char* pragma_name = "#pragma lu_bitpack generate_functions";
 constexpr const char* key_for_read_func = "read_name";
 constexpr const char* key_for_save_func = "save_name";
 
+//
+// Parses a string like `section(".iwram"),target("arm"),noinline` into a 
+// list of attributes, as if it had been written within `__attribute__((...))`. 
+// Arguments may be string literals, integer literals, or identifiers.
+//
+static std::optional<gw::attribute_list> _parse_function_attributes(std::string_view text, location_t loc) {
+   size_t i = 0;
+   
+   auto _skip_whitespace = [&text, &i]() {
+      while (i < text.size() && ISSPACE(text[i]))
+         ++i;
+   };
+   auto _take_name = [&text, &i]() -> std::string {
+      size_t start = i;
+      while (i < text.size() && (ISALNUM(text[i]) || text[i] == '_'))
+         ++i;
+      return std::string(text.substr(start, i - start));
+   };
+   auto _fail = [loc](const char* what) -> std::optional<gw::attribute_list> {
+      error_at(loc, "%qs: malformed value for key %qs: %s", pragma_name, "function_attributes", what);
+      return {};
+   };
+   
+   tree list = NULL_TREE;
+   while (true) {
+      _skip_whitespace();
+      if (i >= text.size())
+         break;
+      if (!ISIDST(text[i]))
+         return _fail("expected an attribute name");
+      auto name = _take_name();
+      
+      tree args = NULL_TREE;
+      _skip_whitespace();
+      if (i < text.size() && text[i] == '(') {
+         ++i;
+         while (true) {
+            _skip_whitespace();
+            if (i >= text.size())
+               return _fail("expected an attribute argument");
+            
+            tree arg = NULL_TREE;
+            if (text[i] == '"') {
+               std::string str;
+               for(++i; i < text.size() && text[i] != '"'; ++i) {
+                  if (text[i] == '\\' && i + 1 < text.size())
+                     ++i;
+                  str += text[i];
+               }
+               if (i >= text.size())
+                  return _fail("unterminated string literal");
+               ++i;
+               arg = fix_string_type(build_string(str.size() + 1, str.c_str()));
+            } else if (ISDIGIT(text[i])) {
+               auto digits = _take_name();
+               char* end   = nullptr;
+               auto  value = strtoll(digits.c_str(), &end, 0);
+               if (*end != '\0')
+                  return _fail("bad integer literal");
+               arg = build_int_cst(integer_type_node, value);
+            } else if (ISIDST(text[i])) {
+               arg = get_identifier(_take_name().c_str());
+            } else {
+               return _fail("expected an attribute argument");
+            }
+            args = tree_cons(NULL_TREE, arg, args);
+            
+            _skip_whitespace();
+            if (i < text.size() && text[i] == ',') {
+               ++i;
+               continue;
+            }
+            if (i < text.size() && text[i] == ')') {
+               ++i;
+               break;
+            }
+            return _fail("expected a comma or closing parenthesis after an attribute argument");
+         }
+         args = nreverse(args);
+      }
+      list = tree_cons(canonicalize_attr_name(get_identifier(name.c_str())), args, list);
+      
+      _skip_whitespace();
+      if (i >= text.size())
+         break;
+      if (text[i] != ',')
+         return _fail("expected a comma between attributes");
+      ++i;
+   }
+   return gw::attribute_list::wrap(nreverse(list));
+}
+
 namespace codegen {
    bool generation_request::from_pragma_parser(cpp_reader& parser) {
       location_t loc;
@@ -49,7 +142,7 @@ namespace codegen {
          // last accepted token. Code after the branch acts on the last 
          // grabbed token.
          //
-         if (key == "enable_debug_output") {
+         if (key == "enable_debug_output" || key == "generate_dirty_checks" || key == "generate_identifier_reads" || key == "emit_shared" || key == "split_scalars_across_sectors" || key == "split_buffers_across_sectors" || key == "split_unions_across_sectors") {
             int value = 0;
             switch (pragma_lex(&data, &loc)) {
                case CPP_NAME:
@@ -75,7 +168,88 @@ namespace codegen {
                   error_at(loc, "%qs: expected integer literal or identifiers %<true%> or %<false%> as value for key %qs", pragma_name, key.data());
                   return false;
             }
-            this->settings.enable_debug_output = value != 0;
+            if (key == "enable_debug_output") {
+               this->settings.enable_debug_output = value != 0;
+            } else if (key == "generate_dirty_checks") {
+               this->settings.generate_dirty_checks = value != 0;
+            } else if (key == "emit_shared") {
+               this->settings.emit_shared = value != 0;
+            } else if (key == "split_scalars_across_sectors") {
+               this->settings.split_scalars_across_sectors = value != 0;
+            } else if (key == "split_buffers_across_sectors") {
+               this->settings.split_buffers_across_sectors = value != 0;
+            } else if (key == "split_unions_across_sectors") {
+               this->settings.split_unions_across_sectors = value != 0;
+            } else {
+               this->settings.generate_identifier_reads = value != 0;
+            }
+            
+            token = pragma_lex(&data, &loc);
+         } else if (key == "resumable_step_size" || key == "max_statements_per_function") {
+            if (pragma_lex(&data, &loc) != CPP_NUMBER || TREE_CODE(data) != INTEGER_CST) {
+               error_at(loc, "%qs: expected integer literal as value for key %qs", pragma_name, key.data());
+               return false;
+            }
+            if (key == "resumable_step_size") {
+               this->settings.resumable_step_size = TREE_INT_CST_LOW(data);
+            } else {
+               this->settings.max_statements_per_function = TREE_INT_CST_LOW(data);
+            }
+            
+            token = pragma_lex(&data, &loc);
+         } else if (key == "sectors") {
+            //
+            // Either a single sector index, or an inclusive range `a-b`.
+            //
+            if (pragma_lex(&data, &loc) != CPP_NUMBER || TREE_CODE(data) != INTEGER_CST) {
+               error_at(loc, "%qs: expected integer literal or range %<a-b%> as value for key %qs", pragma_name, key.data());
+               return false;
+            }
+            size_t first = TREE_INT_CST_LOW(data);
+            size_t last  = first;
+            
+            token = pragma_lex(&data, &loc);
+            if (token == CPP_MINUS) {
+               if (pragma_lex(&data, &loc) != CPP_NUMBER || TREE_CODE(data) != INTEGER_CST) {
+                  error_at(loc, "%qs: expected integer literal after %<-%>, as part of value for key %qs", pragma_name, key.data());
+                  return false;
+               }
+               last = TREE_INT_CST_LOW(data);
+               if (last < first) {
+                  error_at(loc, "%qs: the range given for key %qs ends before it begins", pragma_name, key.data());
+                  return false;
+               }
+               token = pragma_lex(&data, &loc);
+            }
+            this->settings.sectors.first = first;
+            this->settings.sectors.last  = last;
+         } else if (key == "codegen_mode") {
+            if (pragma_lex(&data, &loc) != CPP_NAME) {
+               error_at(loc, "%qs: expected identifiers %<code%>, %<table%>, or %<auto%> as value for key %qs", pragma_name, key.data());
+               return false;
+            }
+            std::string_view name = IDENTIFIER_POINTER(data);
+            if (name == "code") {
+               this->settings.mode = codegen_mode::code;
+            } else if (name == "table") {
+               this->settings.mode = codegen_mode::table;
+            } else if (name == "auto") {
+               this->settings.mode = codegen_mode::automatic;
+            } else {
+               error_at(loc, "%qs: expected identifiers %<code%>, %<table%>, or %<auto%> as value for key %qs", pragma_name, key.data());
+               return false;
+            }
+            
+            token = pragma_lex(&data, &loc);
+         } else if (key == "function_attributes") {
+            if (pragma_lex(&data, &loc) != CPP_STRING) {
+               error_at(loc, "%qs: expected string literal as value for key %qs", pragma_name, key.data());
+               return false;
+            }
+            auto list = _parse_function_attributes(TREE_STRING_POINTER(data), loc);
+            if (!list)
+               return false;
+            this->settings.function_attributes = *list;
             
             token = pragma_lex(&data, &loc);
          } else if (key == key_for_read_func || key == key_for_save_func) {
@@ -171,6 +345,10 @@ namespace codegen {
       return true;
    }
    
+   bool generation_request::defines_sector(size_t i) const {
+      return i >= this->settings.sectors.first && i <= this->settings.sectors.last;
+   }
+   
    bool generation_request::are_identifiers_valid(bool complain) {
       for (auto& group : this->identifier_groups) {
          for(auto& entry : group) {
@@ -1,37 +1,274 @@
 #include "lu/stringf.h"
 #include "codegen/generation_result.h"
 #include "codegen/generation_request.h"
+#include "bitpacking/data_options.h"
 #include "basic_global_state.h"
 #include "gcc_wrappers/constant/integer.h"
 #include "gcc_wrappers/decl/function.h"
+#include "gcc_wrappers/decl/result.h"
 #include "gcc_wrappers/decl/variable.h"
+#include "gcc_wrappers/expr/assign.h"
 #include "gcc_wrappers/expr/call.h"
 #include "gcc_wrappers/expr/local_block.h"
+#include "gcc_wrappers/expr/return_result.h"
 #include "gcc_wrappers/expr/ternary.h"
+#include "gcc_wrappers/environment/c/constexpr_supported.h"
+#include "gcc_wrappers/environment/c/dialect.h"
 #include "gcc_wrappers/type/function.h"
+#include "gcc_wrappers/type/pointer.h"
 #include "gcc_wrappers/flow/simple_if_else_set.h"
 #include "gcc_wrappers/builtin_types.h"
+#include "gcc_wrappers/identifier.h"
 #include "gcc_wrappers/statement_list.h"
 #include "gcc_wrappers/value.h"
 namespace gw {
    using namespace gcc_wrappers;
 }
+namespace typed_options {
+   using namespace bitpacking::typed_data_options::computed;
+}
 #include "codegen/instructions/utils/generation_context.h"
+#include "codegen/instructions/utils/walk.h"
+#include "codegen/instructions/single.h"
 #include "codegen/expr_pair.h"
 #include "codegen/optional_value_pair.h"
+#include "codegen/sector_byte_containing.h"
+#include "codegen/table_codec.h"
 #include <c-family/c-common.h> // lookup_name
 #include <diagnostic.h>
 
 namespace codegen {
+   // Dirty checks and identifier reads are meant to be called by user code, 
+   // which may have declared them ahead of time. Returns an empty optional if 
+   // the user already defined the function.
+   static gw::decl::optional_function _get_or_declare_user_facing(lu::strings::zview name, gw::type::function type) {
+      gw::identifier    id   = gw::identifier(name);
+      gw::optional_node node = lookup_name(id.unwrap());
+      if (node) {
+         if (!node->is<gw::decl::function>()) {
+            error("cannot generate function %qE, as that identifier is already in use by something else", id.unwrap());
+            return {};
+         }
+         auto decl = node->as<gw::decl::function>();
+         if (decl.has_body()) {
+            error("cannot generate a definition for function %qE, as it already has a definition", id.unwrap());
+            return {};
+         }
+         return decl;
+      }
+      return gw::decl::function(name, type);
+   }
+   
+   bool generation_result::_defines_sector(size_t i) const {
+      return i >= this->emitting.first_sector && i <= this->emitting.last_sector;
+   }
+   
+   void generation_result::_generate_whole_struct_functions_used_by(const instructions::base& root, bool dirty_checks) {
+      auto ctxt = codegen::instructions::utils::generation_context(this->whole_struct);
+      ctxt.function_attributes = this->function_attributes;
+      ctxt.define_whole_struct_functions = this->emitting.shared;
+      
+      instructions::utils::walk(
+         [&ctxt, dirty_checks](const instructions::base& node) {
+            auto* casted = node.as<instructions::single>();
+            if (!casted)
+               return;
+            const auto& options = casted->value.bitpacking_options();
+            if (options.is_omitted || !options.is<typed_options::structure>())
+               return;
+            
+            auto type = casted->value.as_value_pair().read->value_type();
+            if (!type.is_record())
+               return;
+            if (dirty_checks)
+               ctxt.get_whole_struct_dirty_check_for(type.as_record());
+            else
+               ctxt.get_whole_struct_functions_for(type.as_record());
+         },
+         root
+      );
+   }
+   
+   static size_t _count_nodes(const instructions::base& root) {
+      size_t count = 0;
+      instructions::utils::walk(
+         [&count](const instructions::base&) {
+            ++count;
+         },
+         root
+      );
+      return count;
+   }
+   
+   // Lists the nodes that a sector can be split between, looking through any 
+   // plain containers. Other nodes (array slices, transforms, and unions) 
+   // can't be split further, since their children share loop counters or 
+   // other state.
+   static void _gather_splittable_nodes(const instructions::base& node, std::vector<const instructions::base*>& out) {
+      if (node.get_type() == instructions::type::container) {
+         for(const auto& child_ptr : node.as<instructions::container>()->instructions)
+            _gather_splittable_nodes(*child_ptr, out);
+         return;
+      }
+      out.push_back(&node);
+   }
+   
+   expr_pair generation_result::_generate_sector_in_parts(
+      size_t sector_index,
+      const instructions::base& root,
+      gw::type::function per_sector_function_type,
+      size_t max_statements,
+      const instructions::utils::generation_context& sector_context
+   ) {
+      const auto& gs = basic_global_state::get_fast();
+      const auto& ty = gw::builtin_types::get_fast();
+      
+      bool checksums = gs.global_options.checksums_enabled();
+      
+      //
+      // Divide the nodes into runs of up to the maximum size. A node that's 
+      // too large on its own gets a run to itself.
+      //
+      std::vector<std::vector<const instructions::base*>> parts;
+      {
+         std::vector<const instructions::base*> nodes;
+         _gather_splittable_nodes(root, nodes);
+         
+         size_t current = 0;
+         for(const auto* node : nodes) {
+            size_t size = _count_nodes(*node);
+            if (parts.empty() || (current > 0 && current + size > max_statements)) {
+               parts.emplace_back();
+               current = 0;
+            }
+            parts.back().push_back(node);
+            current += size;
+         }
+      }
+      
+      gw::expr::local_block block_read;
+      gw::expr::local_block block_save;
+      for(size_t i = 0; i < parts.size(); ++i) {
+         auto pair = func_pair(
+            gw::decl::function(
+               lu::stringf("__lu_bitpack_read_sector_%u_part_%u", (int)sector_index, (int)i),
+               per_sector_function_type
+            ),
+            gw::decl::function(
+               lu::stringf("__lu_bitpack_save_sector_%u_part_%u", (int)sector_index, (int)i),
+               per_sector_function_type
+            )
+         );
+         pair.read.apply_attributes(this->function_attributes);
+         pair.save.apply_attributes(this->function_attributes);
+         pair.read.as_modifiable().set_result_decl(gw::decl::result(ty.basic_void));
+         pair.save.as_modifiable().set_result_decl(gw::decl::result(ty.basic_void));
+         
+         pair.read.nth_parameter(0).make_used();
+         pair.save.nth_parameter(0).make_used();
+         if (checksums) {
+            pair.read.nth_parameter(1).make_used();
+            pair.save.nth_parameter(1).make_used();
+         }
+         
+         auto ctxt = codegen::instructions::utils::generation_context(this->whole_struct);
+         ctxt.function_attributes = this->function_attributes;
+         ctxt.define_whole_struct_functions = this->emitting.shared;
+         ctxt.state_ptr = codegen::optional_value_pair(
+            pair.read.nth_parameter(0).as_value(),
+            pair.save.nth_parameter(0).as_value()
+         );
+         if (checksums) {
+            ctxt.checksum_ptr = codegen::optional_value_pair(
+               pair.read.nth_parameter(1).as_value(),
+               pair.save.nth_parameter(1).as_value()
+            );
+         }
+         
+         gw::expr::local_block part_read;
+         gw::expr::local_block part_save;
+         for(const auto* node : parts[i]) {
+            auto expr = node->generate(ctxt);
+            part_read.statements().append(expr.read);
+            part_save.statements().append(expr.save);
+         }
+         
+         pair.read.set_is_defined_elsewhere(false);
+         pair.save.set_is_defined_elsewhere(false);
+         pair.read.as_modifiable().set_root_block(part_read);
+         pair.save.as_modifiable().set_root_block(part_save);
+         
+         // expose these identifiers so we can inspect them with our debug-dump pragmas.
+         pair.read.introduce_to_current_scope();
+         pair.save.introduce_to_current_scope();
+         
+         this->per_sector_parts.push_back(pair);
+         
+         //
+         // Call the part from the sector's functions, passing along the state 
+         // (and checksum) pointers that they received.
+         //
+         if (checksums) {
+            block_read.statements().append(gw::expr::call(
+               pair.read,
+               // args:
+               *sector_context.state_ptr.read,
+               *sector_context.checksum_ptr.read
+            ));
+            block_save.statements().append(gw::expr::call(
+               pair.save,
+               // args:
+               *sector_context.state_ptr.save,
+               *sector_context.checksum_ptr.save
+            ));
+         } else {
+            block_read.statements().append(gw::expr::call(
+               pair.read,
+               // args:
+               *sector_context.state_ptr.read
+            ));
+            block_save.statements().append(gw::expr::call(
+               pair.save,
+               // args:
+               *sector_context.state_ptr.save
+            ));
+         }
+      }
+      return expr_pair(block_read, block_save);
+   }
+   
    void generation_result::_generate_per_sector_functions(const generation_request& request, const std::vector<std::unique_ptr<instructions::base>>& instructions_by_sector) {
       const auto& gs = basic_global_state::get_fast();
       const auto& ty = gw::builtin_types::get_fast();
       
+      bool checksums = gs.global_options.checksums_enabled();
+      
+      auto mode = request.settings.mode;
+      if (checksums && mode != generation_request::codegen_mode::code) {
+         //
+         // The table interpreter doesn't update checksums.
+         //
+         warning_at(request.start_location, 0, "tables can%'t be used when checksums are enabled; all sectors will be generated as code");
+         mode = generation_request::codegen_mode::code;
+      }
+      
+      //
+      // If checksums are enabled, then the top-level function's running 
+      // checksum is passed in as an additional argument.
+      //
       auto per_sector_function_type = gw::type::function(
          ty.basic_void,
          // args:
          *gs.global_options.types.bitstream_state_ptr
       );
+      if (checksums) {
+         per_sector_function_type = gw::type::function(
+            ty.basic_void,
+            // args:
+            *gs.global_options.types.bitstream_state_ptr,
+            *gs.global_options.types.checksum_ptr
+         );
+      }
       
       for(size_t i = 0; i < instructions_by_sector.size(); ++i) {
          auto pair = func_pair(
@@ -44,18 +281,81 @@ namespace codegen {
                per_sector_function_type
             )
          );
+         pair.read.apply_attributes(this->function_attributes);
+         pair.save.apply_attributes(this->function_attributes);
          pair.read.as_modifiable().set_result_decl(gw::decl::result(ty.basic_void));
          pair.save.as_modifiable().set_result_decl(gw::decl::result(ty.basic_void));
          
          pair.read.nth_parameter(0).make_used();
          pair.save.nth_parameter(0).make_used();
+         if (checksums) {
+            pair.read.nth_parameter(1).make_used();
+            pair.save.nth_parameter(1).make_used();
+         }
          
          auto ctxt = codegen::instructions::utils::generation_context(this->whole_struct);
+         ctxt.function_attributes = this->function_attributes;
+         ctxt.define_whole_struct_functions = this->emitting.shared;
          ctxt.state_ptr = codegen::optional_value_pair(
             pair.read.nth_parameter(0).as_value(),
             pair.save.nth_parameter(0).as_value()
          );
-         auto expr = instructions_by_sector[i]->generate(ctxt);
+         if (checksums) {
+            ctxt.checksum_ptr = codegen::optional_value_pair(
+               pair.read.nth_parameter(1).as_value(),
+               pair.save.nth_parameter(1).as_value()
+            );
+         }
+         
+         //
+         // Decide whether to encode this sector as a table. In automatic mode, 
+         // we only do so if the table is estimated to be smaller than the code 
+         // we'd otherwise generate.
+         //
+         const auto& instructions = *instructions_by_sector[i];
+         std::optional<std::vector<table_codec::op>> table;
+         if (mode != generation_request::codegen_mode::code) {
+            table = table_codec::compile(instructions, ctxt);
+            if (table && mode == generation_request::codegen_mode::automatic) {
+               if (table_codec::estimate_table_size(*table) >= table_codec::estimate_code_size(instructions))
+                  table.reset();
+            }
+         }
+         if (table) {
+            if (!this->table_interpreter.read) {
+               if (this->emitting.shared)
+                  this->table_interpreter = table_codec::generate_interpreter();
+               else
+                  this->table_interpreter = table_codec::declare_interpreter();
+               this->table_interpreter.read->apply_attributes(this->function_attributes);
+               this->table_interpreter.save->apply_attributes(this->function_attributes);
+            }
+            this->table_sectors.push_back(i);
+         }
+         
+         if (!this->_defines_sector(i)) {
+            //
+            // Another translation unit defines this sector's functions, so we 
+            // only declare them. If we're defining the shared functions, though, 
+            // then we have to define the whole-struct functions that this sector 
+            // calls.
+            //
+            if (this->emitting.shared)
+               this->_generate_whole_struct_functions_used_by(instructions, false);
+            pair.read.introduce_to_current_scope();
+            pair.save.introduce_to_current_scope();
+            this->per_sector.push_back(pair);
+            continue;
+         }
+         
+         auto _generate_body = [&]() -> expr_pair {
+            if (table)
+               return table_codec::generate_table_call(i, *table, this->table_interpreter, ctxt.state_ptr);
+            if (size_t max = request.settings.max_statements_per_function; max > 0 && _count_nodes(instructions) > max)
+               return this->_generate_sector_in_parts(i, instructions, per_sector_function_type, max, ctxt);
+            return instructions.generate(ctxt);
+         };
+         auto expr = _generate_body();
          
          if (!expr.read.is<gw::expr::local_block>()) {
             gw::expr::local_block block;
@@ -92,6 +392,26 @@ namespace codegen {
       const auto& ty = gw::builtin_types::get_fast();
       
       auto& pair = this->top_level;
+      //
+      // If checksums are enabled, then the functions return the checksum of 
+      // the sector they read or saved.
+      //
+      gw::type::base return_type = ty.basic_void;
+      if (gs.global_options.checksums_enabled())
+         return_type = *gs.global_options.types.checksum;
+      
+      auto _check_return_type = [&return_type](gw::identifier id, gw::decl::function decl) {
+         if (decl.function_type().return_type() != return_type) {
+            error(
+               "cannot generate a definition for function %qE, as its return type is not %<%s%>",
+               id.unwrap(),
+               return_type.name().data()
+            );
+            return false;
+         }
+         return true;
+      };
+      
       //
       // Get-or-create the functions; then create their bodies.
       //
@@ -105,12 +425,14 @@ namespace codegen {
             if (decl.has_body()) {
                error("cannot generate a definition for function %qE, as it already has a definition", id.unwrap());
                can_generate_bodies = false;
+            } else if (!_check_return_type(id, decl)) {
+               can_generate_bodies = false;
             }
          } else {
             pair.read = gw::decl::function(
                id.name().data(),
                gw::type::function(
-                  ty.basic_void,
+                  return_type,
                   // args:
                   gs.global_options.types.buffer_byte_ptr->remove_pointer().add_const().add_pointer(),
                   ty.basic_int // int sectorID
@@ -128,12 +450,14 @@ namespace codegen {
             if (decl.has_body()) {
                error("cannot generate a definition for function %qE, as it already has a definition", id.unwrap());
                can_generate_bodies = false;
+            } else if (!_check_return_type(id, decl)) {
+               can_generate_bodies = false;
             }
          } else {
             pair.save = gw::decl::function(
                id.name().data(),
                gw::type::function(
-                  ty.basic_void,
+                  return_type,
                   // args:
                   *gs.global_options.types.buffer_byte_ptr,
                   ty.basic_int // int sectorID
@@ -151,6 +475,7 @@ namespace codegen {
       
       auto func     = *(is_read ? this->top_level.read : this->top_level.save);
       auto func_mod = func.as_modifiable();
+      func.apply_attributes(this->function_attributes);
       
       gw::expr::local_block root_block;
       gw::statement_list    statements = root_block.statements();
@@ -185,11 +510,30 @@ namespace codegen {
          );
       }
    
+      gw::decl::optional_variable checksum_decl;
+      if (gs.global_options.checksums_enabled()) {
+         checksum_decl = gw::decl::variable("__lu_bitpack_checksum", *gs.global_options.types.checksum);
+         checksum_decl->make_artificial();
+         checksum_decl->make_used();
+         checksum_decl->set_initial_value(gw::constant::integer(gs.global_options.types.checksum->as_integral(), 0));
+         statements.append(checksum_decl->make_declare_expr());
+      }
+   
       std::vector<gw::expr::call> calls;
       calls.reserve(sector_count);
       for(size_t i = 0; i < sector_count; ++i) {
+         auto callee = is_read ? this->per_sector[i].read : this->per_sector[i].save;
+         if (checksum_decl) {
+            calls.push_back(gw::expr::call(
+               callee,
+               // args:
+               state_decl.as_value().address_of(),
+               checksum_decl->as_value().address_of()
+            ));
+            continue;
+         }
          calls.push_back(gw::expr::call(
-            is_read ? this->per_sector[i].read : this->per_sector[i].save,
+            callee,
             // args:
             state_decl.as_value().address_of()
          ));
@@ -208,7 +552,18 @@ namespace codegen {
          statements.append(*branches.result);
       
       func.set_is_defined_elsewhere(false);
-      func_mod.set_result_decl(gw::decl::result(ty.basic_void));
+      if (checksum_decl) {
+         //
+         // return __lu_bitpack_checksum;
+         //
+         auto result_decl = gw::decl::result(*gs.global_options.types.checksum);
+         func_mod.set_result_decl(result_decl);
+         statements.append(gw::expr::return_result(
+            gw::expr::assign(result_decl.as_value(), checksum_decl->as_value())
+         ));
+      } else {
+         func_mod.set_result_decl(gw::decl::result(ty.basic_void));
+      }
       func_mod.set_root_block(root_block);
       
       // expose these identifiers so we can inspect them with our debug-dump pragmas.
@@ -218,11 +573,557 @@ namespace codegen {
    }
    
    bool generation_result::generate(const generation_request& request, const std::vector<std::unique_ptr<instructions::base>>& instructions_by_sector) {
+      this->function_attributes   = request.settings.function_attributes;
+      this->emitting.first_sector = request.settings.sectors.first;
+      this->emitting.last_sector  = request.settings.sectors.last;
+      this->emitting.shared       = request.settings.emit_shared;
       this->_generate_per_sector_functions(request, instructions_by_sector);
+      if (!this->emitting.shared)
+         return true;
       if (!this->_get_or_declare_top_level_functions(request))
          return false;
       this->_generate_top_level_function(request, instructions_by_sector.size(), true);
       this->_generate_top_level_function(request, instructions_by_sector.size(), false);
       return true;
    }
+   
+   void generation_result::generate_dirty_checks(const std::vector<std::unique_ptr<instructions::base>>& instructions_by_sector) {
+      const auto& gs = basic_global_state::get_fast();
+      const auto& ty = gw::builtin_types::get_fast();
+      
+      auto per_sector_function_type = gw::type::function(
+         ty.basic_int,
+         // args:
+         gs.global_options.types.buffer_byte_ptr->remove_pointer().add_const().add_pointer()
+      );
+      
+      for(size_t i = 0; i < instructions_by_sector.size(); ++i) {
+         auto name = lu::stringf("__lu_bitpack_sector_is_dirty_%u", (int)i);
+         auto decl = _get_or_declare_user_facing(name, per_sector_function_type);
+         if (!decl)
+            return;
+         auto func = *decl;
+         func.apply_attributes(this->function_attributes);
+         
+         if (!this->_defines_sector(i)) {
+            if (this->emitting.shared)
+               this->_generate_whole_struct_functions_used_by(*instructions_by_sector[i], true);
+            func.introduce_to_current_scope();
+            this->dirty_check_per_sector.push_back(func);
+            continue;
+         }
+         
+         auto result_decl = gw::decl::result(ty.basic_int);
+         func.as_modifiable().set_result_decl(result_decl);
+         func.nth_parameter(0).make_used();
+         
+         gw::expr::local_block root_block;
+         gw::statement_list    statements = root_block.statements();
+         
+         auto state_decl = gw::decl::variable("__lu_bitstream_state", *gs.global_options.types.bitstream_state);
+         state_decl.make_artificial();
+         state_decl.make_used();
+         statements.append(state_decl.make_declare_expr());
+         {  // lu_BitstreamInitialize(&state, src);
+            //
+            // Cast away const-ness, as when reading: we only use "read" calls 
+            // on the bitstream, so the buffer won't be modified.
+            //
+            auto src_arg = func.nth_parameter(0).as_value();
+            src_arg = src_arg.conversion_sans_bytecode(*gs.global_options.types.buffer_byte_ptr);
+            statements.append(
+               gw::expr::call(
+                  *gs.global_options.functions.stream_state_init,
+                  // args:
+                  state_decl.as_value().address_of(), // &state
+                  src_arg // src
+               )
+            );
+         }
+         
+         auto ctxt = codegen::instructions::utils::generation_context(this->whole_struct);
+         ctxt.function_attributes = this->function_attributes;
+         ctxt.define_whole_struct_functions = this->emitting.shared;
+         ctxt.state_ptr = codegen::optional_value_pair(
+            state_decl.as_value().address_of(),
+            state_decl.as_value().address_of()
+         );
+         ctxt.dirty_check_result = result_decl;
+         statements.append(instructions_by_sector[i]->generate_dirty_check(ctxt));
+         
+         // return 0;
+         statements.append(gw::expr::return_result(
+            gw::expr::assign(result_decl.as_value(), gw::constant::integer(ty.basic_int, 0))
+         ));
+         
+         func.set_is_defined_elsewhere(false);
+         func.as_modifiable().set_root_block(root_block);
+         
+         // expose these identifiers so we can inspect them with our debug-dump pragmas.
+         func.introduce_to_current_scope();
+         
+         this->dirty_check_per_sector.push_back(func);
+      }
+      if (this->emitting.shared)
+         this->_generate_top_level_dirty_check();
+   }
+   
+   void generation_result::_generate_top_level_dirty_check() {
+      const auto& gs = basic_global_state::get_fast();
+      const auto& ty = gw::builtin_types::get_fast();
+      
+      auto decl = _get_or_declare_user_facing(
+         "__lu_bitpack_sector_is_dirty",
+         gw::type::function(
+            ty.basic_int,
+            // args:
+            gs.global_options.types.buffer_byte_ptr->remove_pointer().add_const().add_pointer(),
+            ty.basic_int // int sectorID
+         )
+      );
+      if (!decl)
+         return;
+      auto func = *decl;
+      func.apply_attributes(this->function_attributes);
+      
+      auto result_decl = gw::decl::result(ty.basic_int);
+      func.as_modifiable().set_result_decl(result_decl);
+      func.nth_parameter(0).make_used();
+      func.nth_parameter(1).make_used();
+      
+      gw::expr::local_block root_block;
+      gw::statement_list    statements = root_block.statements();
+      
+      gw::flow::simple_if_else_set branches;
+      for(size_t i = 0; i < this->dirty_check_per_sector.size(); ++i) {
+         branches.add_branch(
+            func.nth_parameter(1).as_value().cmp_is_equal(
+               gw::constant::integer(ty.basic_int, i)
+            ),
+            gw::expr::return_result(
+               gw::expr::assign(
+                  result_decl.as_value(),
+                  gw::expr::call(
+                     this->dirty_check_per_sector[i],
+                     // args:
+                     func.nth_parameter(0).as_value()
+                  )
+               )
+            )
+         );
+      }
+      if (branches.result)
+         statements.append(*branches.result);
+         
+      //
+      // Sectors past the end have no data, so saving them is a no-op and they 
+      // are never dirty.
+      //
+      statements.append(gw::expr::return_result(
+         gw::expr::assign(result_decl.as_value(), gw::constant::integer(ty.basic_int, 0))
+      ));
+      
+      func.set_is_defined_elsewhere(false);
+      func.as_modifiable().set_root_block(root_block);
+      func.introduce_to_current_scope();
+      
+      this->dirty_check_top_level = func;
+   }
+   
+   void generation_result::generate_identifier_read(std::string_view identifier_name, const std::vector<identifier_span>& spans) {
+      const auto& gs = basic_global_state::get_fast();
+      const auto& ty = gw::builtin_types::get_fast();
+      
+      if (spans.empty())
+         return;
+      if (!this->emitting.shared)
+         //
+         // Identifier reads aren't specific to any one sector, so they're 
+         // defined alongside the other shared functions.
+         //
+         return;
+      
+      auto src_type      = gs.global_options.types.buffer_byte_ptr->remove_pointer().add_const().add_pointer();
+      auto callback_type = gw::type::function(
+         src_type,
+         // args:
+         ty.basic_int // int sectorID
+      ).add_pointer();
+      
+      auto decl = _get_or_declare_user_facing(
+         lu::stringf("__lu_bitpack_read_%s", identifier_name.data()),
+         gw::type::function(
+            ty.basic_void,
+            // args:
+            callback_type
+         )
+      );
+      if (!decl)
+         return;
+      auto func = *decl;
+      func.apply_attributes(this->function_attributes);
+      
+      {  // __lu_bitpack_first_sector_of_foo, __lu_bitpack_sector_count_of_foo
+         //
+         // An identifier's items are never interleaved with other identifiers' 
+         // items, so the sectors it spans are always contiguous, and can be 
+         // described by a first index and a count.
+         //
+         auto const_size_type = ty.size.add_const();
+         auto _define_constant = [&const_size_type, &ty](const std::string& name, size_t value) {
+            gw::decl::variable var(name, const_size_type);
+            var.make_artificial();
+            var.set_initial_value(gw::constant::integer(ty.size, value));
+            var.make_read_only();
+            var.make_file_scope_extern();
+            var.set_is_defined_elsewhere(false);
+            if constexpr (gw::environment::c::constexpr_supported) {
+               if (gw::environment::c::current_dialect() >= gw::environment::c::dialect::c23) {
+                  var.make_declared_constexpr();
+               }
+            }
+         };
+         size_t first = spans.front().sector_index;
+         size_t last  = spans.back().sector_index;
+         _define_constant(lu::stringf("__lu_bitpack_first_sector_of_%s", identifier_name.data()), first);
+         _define_constant(lu::stringf("__lu_bitpack_sector_count_of_%s", identifier_name.data()), last - first + 1);
+      }
+      
+      func.as_modifiable().set_result_decl(gw::decl::result(ty.basic_void));
+      func.nth_parameter(0).make_used();
+      
+      gw::expr::local_block root_block;
+      gw::statement_list    statements = root_block.statements();
+      
+      auto state_decl = gw::decl::variable("__lu_bitstream_state", *gs.global_options.types.bitstream_state);
+      state_decl.make_artificial();
+      state_decl.make_used();
+      statements.append(state_decl.make_declare_expr());
+      
+      gw::decl::optional_variable checksum_decl;
+      if (gs.global_options.checksums_enabled()) {
+         //
+         // Whole-struct functions take a running checksum as an argument. We 
+         // only read part of each sector, so we can't verify the checksum, and 
+         // we give them a scratch variable instead.
+         //
+         checksum_decl = gw::decl::variable("__lu_bitpack_checksum", *gs.global_options.types.checksum);
+         checksum_decl->make_artificial();
+         checksum_decl->make_used();
+         checksum_decl->set_initial_value(gw::constant::integer(gs.global_options.types.checksum->as_integral(), 0));
+         statements.append(checksum_decl->make_declare_expr());
+      }
+      
+      for(const auto& span : spans) {
+         {  // lu_BitstreamInitialize(&state, (buffer_byte_type*)&((const uint8_t*)get_sector(n))[offset / 8]);
+            //
+            // Cast away const-ness, as when reading: we only use "read" calls 
+            // on the bitstream, so the buffer won't be modified.
+            //
+            auto sector = gw::expr::call(
+               func.nth_parameter(0).as_value(),
+               // args:
+               gw::constant::integer(ty.basic_int, span.sector_index)
+            );
+            statements.append(
+               gw::expr::call(
+                  *gs.global_options.functions.stream_state_init,
+                  // args:
+                  state_decl.as_value().address_of(), // &state
+                  sector_byte_containing(sector, span.offset) // src
+               )
+            );
+         }
+         if (size_t bits = span.offset % 8; bits > 0) {
+            //
+            // Skip past the bits that precede the identifier's data within its 
+            // first byte.
+            //
+            statements.append(
+               gw::expr::call(
+                  *gs.global_options.functions.read.u8,
+                  // args:
+                  state_decl.as_value().address_of(),
+                  gw::constant::integer(ty.uint8, bits)
+               )
+            );
+         }
+         
+         auto ctxt = codegen::instructions::utils::generation_context(this->whole_struct);
+         ctxt.function_attributes = this->function_attributes;
+         ctxt.define_whole_struct_functions = this->emitting.shared;
+         ctxt.state_ptr = codegen::optional_value_pair(
+            state_decl.as_value().address_of(),
+            state_decl.as_value().address_of()
+         );
+         if (checksum_decl) {
+            ctxt.checksum_ptr = codegen::optional_value_pair(
+               checksum_decl->as_value().address_of(),
+               checksum_decl->as_value().address_of()
+            );
+         }
+         statements.append(span.instructions->generate(ctxt).read);
+      }
+      
+      func.set_is_defined_elsewhere(false);
+      func.as_modifiable().set_root_block(root_block);
+      func.introduce_to_current_scope();
+      
+      this->per_identifier_read.push_back(func);
+   }
+   
+   void generation_result::generate_resumable_steps(const std::vector<std::vector<resumable_step>>& steps_by_sector) {
+      const auto& gs = basic_global_state::get_fast();
+      const auto& ty = gw::builtin_types::get_fast();
+      
+      bool checksums = gs.global_options.checksums_enabled();
+      
+      //
+      // The caller owns the bitstream state and the cursor, and keeps them 
+      // alive between calls; this is what makes the functions resumable. If 
+      // checksums are enabled, the caller owns the running checksum as well.
+      //
+      auto cursor_type = ty.basic_int.add_pointer();
+      auto per_sector_function_type = gw::type::function(
+         ty.basic_int,
+         // args:
+         *gs.global_options.types.bitstream_state_ptr,
+         cursor_type,
+         ty.basic_int // int bit_budget
+      );
+      if (checksums) {
+         per_sector_function_type = gw::type::function(
+            ty.basic_int,
+            // args:
+            *gs.global_options.types.bitstream_state_ptr,
+            cursor_type,
+            ty.basic_int, // int bit_budget
+            *gs.global_options.types.checksum_ptr
+         );
+      }
+      
+      for(size_t i = 0; i < steps_by_sector.size(); ++i) {
+         const auto& steps = steps_by_sector[i];
+         
+         auto pair = func_pair(
+            gw::decl::function(
+               lu::stringf("__lu_bitpack_read_step_sector_%u", (int)i),
+               per_sector_function_type
+            ),
+            gw::decl::function(
+               lu::stringf("__lu_bitpack_save_step_sector_%u", (int)i),
+               per_sector_function_type
+            )
+         );
+         pair.read.apply_attributes(this->function_attributes);
+         pair.save.apply_attributes(this->function_attributes);
+         for(size_t j = 0; j < (checksums ? 4 : 3); ++j) {
+            pair.read.nth_parameter(j).make_used();
+            pair.save.nth_parameter(j).make_used();
+         }
+         
+         if (!this->_defines_sector(i)) {
+            pair.read.introduce_to_current_scope();
+            pair.save.introduce_to_current_scope();
+            this->step_per_sector.push_back(pair);
+            continue;
+         }
+         
+         auto ctxt = codegen::instructions::utils::generation_context(this->whole_struct);
+         ctxt.function_attributes = this->function_attributes;
+         ctxt.define_whole_struct_functions = this->emitting.shared;
+         ctxt.state_ptr = codegen::optional_value_pair(
+            pair.read.nth_parameter(0).as_value(),
+            pair.save.nth_parameter(0).as_value()
+         );
+         if (checksums) {
+            ctxt.checksum_ptr = codegen::optional_value_pair(
+               pair.read.nth_parameter(3).as_value(),
+               pair.save.nth_parameter(3).as_value()
+            );
+         }
+         std::vector<expr_pair> step_exprs;
+         for(const auto& step : steps)
+            step_exprs.push_back(step.instructions->generate(ctxt));
+         
+         for(int k = 0; k < 2; ++k) {
+            bool is_read = k == 0;
+            auto func    = is_read ? pair.read : pair.save;
+            
+            auto result_decl = gw::decl::result(ty.basic_int);
+            func.as_modifiable().set_result_decl(result_decl);
+            
+            gw::expr::local_block root_block;
+            gw::statement_list    statements = root_block.statements();
+            
+            auto spent_decl = gw::decl::variable("__lu_bitpack_bits_spent", ty.basic_int);
+            spent_decl.make_artificial();
+            spent_decl.make_used();
+            spent_decl.set_initial_value(gw::constant::integer(ty.basic_int, 0));
+            statements.append(spent_decl.make_declare_expr());
+            
+            auto cursor = func.nth_parameter(1).as_value().dereference();
+            auto budget = func.nth_parameter(2).as_value();
+            auto spent  = spent_decl.as_value();
+            
+            //
+            // Each step runs only if the cursor is on it, and then advances the 
+            // cursor, so consecutive steps run in one call until the budget is 
+            // spent. The first step of each call always runs, even if it alone 
+            // exceeds the budget, so that every call makes progress:
+            //
+            //    if (*cursor == n) {
+            //       if (spent != 0 && spent + step_size > bit_budget)
+            //          return 0;
+            //       // step code
+            //       spent += step_size;
+            //       *cursor = n + 1;
+            //    }
+            //
+            for(size_t n = 0; n < steps.size(); ++n) {
+               auto step_size = gw::constant::integer(ty.basic_int, steps[n].size);
+               
+               gw::expr::local_block block;
+               auto step_statements = block.statements();
+               {
+                  gw::flow::simple_if_else_set branches;
+                  branches.add_branch(
+                     spent.cmp_is_not_equal(gw::constant::integer(ty.basic_int, 0)).logical_and(
+                        spent.add(step_size).cmp_is_greater(budget)
+                     ),
+                     gw::expr::return_result(
+                        gw::expr::assign(result_decl.as_value(), gw::constant::integer(ty.basic_int, 0))
+                     )
+                  );
+                  step_statements.append(*branches.result);
+               }
+               step_statements.append(is_read ? step_exprs[n].read : step_exprs[n].save);
+               step_statements.append(gw::expr::assign(spent, spent.add(step_size)));
+               step_statements.append(gw::expr::assign(cursor, gw::constant::integer(ty.basic_int, n + 1)));
+               
+               gw::flow::simple_if_else_set branches;
+               branches.add_branch(
+                  cursor.cmp_is_equal(gw::constant::integer(ty.basic_int, n)),
+                  block
+               );
+               statements.append(*branches.result);
+            }
+            
+            //
+            // Done with the sector. Reset the cursor, so that the caller can 
+            // reuse it for the next sector.
+            //
+            statements.append(gw::expr::assign(cursor, gw::constant::integer(ty.basic_int, 0)));
+            statements.append(gw::expr::return_result(
+               gw::expr::assign(result_decl.as_value(), gw::constant::integer(ty.basic_int, 1))
+            ));
+            
+            func.set_is_defined_elsewhere(false);
+            func.as_modifiable().set_root_block(root_block);
+            
+            // expose these identifiers so we can inspect them with our debug-dump pragmas.
+            func.introduce_to_current_scope();
+         }
+         
+         this->step_per_sector.push_back(pair);
+      }
+      if (this->emitting.shared) {
+         this->_generate_top_level_step_function(true);
+         this->_generate_top_level_step_function(false);
+      }
+   }
+   
+   void generation_result::_generate_top_level_step_function(bool is_read) {
+      const auto& gs = basic_global_state::get_fast();
+      const auto& ty = gw::builtin_types::get_fast();
+      
+      bool checksums = gs.global_options.checksums_enabled();
+      
+      auto cursor_type   = ty.basic_int.add_pointer();
+      auto function_type = gw::type::function(
+         ty.basic_int,
+         // args:
+         *gs.global_options.types.bitstream_state_ptr,
+         ty.basic_int, // int sector_id
+         cursor_type,
+         ty.basic_int  // int bit_budget
+      );
+      if (checksums) {
+         function_type = gw::type::function(
+            ty.basic_int,
+            // args:
+            *gs.global_options.types.bitstream_state_ptr,
+            ty.basic_int, // int sector_id
+            cursor_type,
+            ty.basic_int, // int bit_budget
+            *gs.global_options.types.checksum_ptr
+         );
+      }
+      
+      auto decl = _get_or_declare_user_facing(
+         is_read ? "__lu_bitpack_read_step" : "__lu_bitpack_save_step",
+         function_type
+      );
+      if (!decl)
+         return;
+      auto func = *decl;
+      func.apply_attributes(this->function_attributes);
+      
+      auto result_decl = gw::decl::result(ty.basic_int);
+      func.as_modifiable().set_result_decl(result_decl);
+      for(size_t j = 0; j < (checksums ? 5 : 4); ++j)
+         func.nth_parameter(j).make_used();
+      
+      gw::expr::local_block root_block;
+      gw::statement_list    statements = root_block.statements();
+      
+      gw::flow::simple_if_else_set branches;
+      for(size_t i = 0; i < this->step_per_sector.size(); ++i) {
+         auto callee = is_read ? this->step_per_sector[i].read : this->step_per_sector[i].save;
+         
+         auto call_expr = gw::expr::call(
+            callee,
+            // args:
+            func.nth_parameter(0).as_value(),
+            func.nth_parameter(2).as_value(),
+            func.nth_parameter(3).as_value()
+         );
+         if (checksums) {
+            call_expr = gw::expr::call(
+               callee,
+               // args:
+               func.nth_parameter(0).as_value(),
+               func.nth_parameter(2).as_value(),
+               func.nth_parameter(3).as_value(),
+               func.nth_parameter(4).as_value()
+            );
+         }
+         branches.add_branch(
+            func.nth_parameter(1).as_value().cmp_is_equal(
+               gw::constant::integer(ty.basic_int, i)
+            ),
+            gw::expr::return_result(
+               gw::expr::assign(result_decl.as_value(), call_expr)
+            )
+         );
+      }
+      if (branches.result)
+         statements.append(*branches.result);
+      
+      //
+      // Sectors past the end have no data, so they're always finished.
+      //
+      statements.append(gw::expr::return_result(
+         gw::expr::assign(result_decl.as_value(), gw::constant::integer(ty.basic_int, 1))
+      ));
+      
+      func.set_is_defined_elsewhere(false);
+      func.as_modifiable().set_root_block(root_block);
+      func.introduce_to_current_scope();
+      
+      if (is_read)
+         this->step_top_level.read = func;
+      else
+         this->step_top_level.save = func;
+   }
 }
\ No newline at end of file
@@ -70,4 +70,27 @@ namespace codegen::instructions {
       
       return expr_pair(read_loop.enclosing, save_loop.enclosing);
    }
+   
+   /*virtual*/ gw::expr::base array_slice::generate_dirty_check(const utils::generation_context& ctxt) const {
+      const auto& ty = gw::builtin_types::get();
+      
+      gw::flow::simple_for_loop loop(ty.basic_int);
+      loop.counter_bounds = {
+         .start     = (intmax_t)this->array.start,
+         .last      = (uintmax_t)(this->array.start + this->array.count - 1),
+         .increment = 1,
+      };
+      //
+      // Dirty checks access values via the "save" side of their paths.
+      //
+      loop.counter = this->loop_index.variables.save;
+      
+      gw::statement_list loop_body;
+      for(auto& child_ptr : this->instructions) {
+         loop_body.append(child_ptr->generate_dirty_check(ctxt));
+      }
+      loop.bake(std::move(loop_body));
+      
+      return loop.enclosing;
+   }
 }
\ No newline at end of file
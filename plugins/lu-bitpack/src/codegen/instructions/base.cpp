@@ -23,4 +23,18 @@ namespace codegen::instructions {
       }
       return expr_pair(block_read, block_save);
    }
+   
+   /*virtual*/ gw::expr::base container::generate_dirty_check(const utils::generation_context& ctxt) const {
+      if (this->instructions.size() == 1) {
+         return this->instructions.front()->generate_dirty_check(ctxt);
+      }
+      gw::expr::local_block block;
+      {
+         auto statements = block.statements();
+         for(auto& child_ptr : this->instructions) {
+            statements.append(child_ptr->generate_dirty_check(ctxt));
+         }
+      }
+      return block;
+   }
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "gcc_wrappers/expr/call.h"
 #include "gcc_wrappers/expr/local_block.h"
 #include "gcc_wrappers/builtin_types.h"
+#include "gcc_wrappers/value.h"
 #include "bitpacking/global_options.h"
 #include "basic_global_state.h"
 namespace gw {
@@ -75,4 +76,44 @@ namespace codegen::instructions {
       }
       return expr_pair(block_read, block_save);
    }
+   
+   /*virtual*/ gw::expr::base padding::generate_dirty_check(const utils::generation_context& ctxt) const {
+      const auto& ty     = gw::builtin_types::get();
+      const auto& global = basic_global_state::get().global_options;
+      
+      //
+      // Padding is always saved as zero bits, so a sector whose padding isn't 
+      // zero would be changed by a save.
+      //
+      gw::expr::local_block block;
+      auto statements = block.statements();
+      
+      size_t remaining = this->bitcount;
+      while (remaining > 0) {
+         gw::decl::optional_function read_func;
+         
+         size_t consumed = (std::min)(remaining, (size_t)32);
+         if (remaining <= 8) {
+            read_func = global.functions.read.u8;
+         } else if (remaining <= 16) {
+            read_func = global.functions.read.u16;
+         } else {
+            read_func = global.functions.read.u32;
+         }
+         assert(!!read_func);
+         
+         remaining -= consumed;
+         
+         gw::value packed = gw::expr::call(
+            *read_func,
+            // args:
+            *ctxt.state_ptr.read,
+            gw::constant::integer(ty.uint8, consumed)
+         );
+         statements.append(ctxt.make_dirty_check_return_if(
+            packed.cmp_is_not_equal(gw::constant::integer(packed.value_type().as_integral(), 0))
+         ));
+      }
+      return block;
+   }
 }
\ No newline at end of file
@@ -2,13 +2,22 @@
 #include <cassert>
 #include "attribute_handlers/helpers/type_transitively_has_attribute.h"
 #include "codegen/instructions/utils/generation_context.h"
+#include "codegen/charset.h"
+#include "codegen/delta.h"
+#include "codegen/pointer_into.h"
+#include "codegen/quantize.h"
+#include "codegen/value_set.h"
 #include "gcc_wrappers/constant/floating_point.h"
 #include "gcc_wrappers/constant/integer.h"
 #include "gcc_wrappers/constant/string.h"
 #include "gcc_wrappers/decl/function.h"
+#include "gcc_wrappers/decl/variable.h"
 #include "gcc_wrappers/expr/assign.h"
 #include "gcc_wrappers/expr/call.h"
+#include "gcc_wrappers/expr/go_to_label.h"
 #include "gcc_wrappers/expr/local_block.h"
+#include "gcc_wrappers/flow/simple_for_loop.h"
+#include "gcc_wrappers/flow/simple_if_else_set.h"
 #include "gcc_wrappers/type/array.h"
 #include "gcc_wrappers/type/base.h"
 #include "gcc_wrappers/attribute.h"
@@ -104,7 +113,293 @@ namespace codegen::instructions {
       return block;
    }
    
+   // Picks the bitstream functions to use for an integral value of the given 
+   // type.
+   static void _get_integral_functions_for(
+      gw::type::base               type,
+      gw::decl::optional_function& read_func,
+      gw::decl::optional_function& save_func
+   ) {
+      const auto& ty     = gw::builtin_types::get();
+      const auto& global = basic_global_state::get().global_options;
+      
+      auto vt_canonical = type.canonical();
+      //
+      // Because we add a `min` to the value before serializing, 
+      // we should basically never use the signed functions.
+      //
+      /*//
+      if (vt_canonical == ty.uint8 || vt_canonical == ty.basic_char) {
+         read_func = global.functions.read.u8;
+         save_func = global.functions.save.u8;
+      } else if (vt_canonical == ty.uint16) {
+         read_func = global.functions.read.u16;
+         save_func = global.functions.save.u16;
+      } else if (vt_canonical == ty.uint32) {
+         read_func = global.functions.read.u32;
+         save_func = global.functions.save.u32;
+      } else if (vt_canonical == ty.int8) {
+         read_func = global.functions.read.s8;
+         save_func = global.functions.save.s8;
+      } else if (vt_canonical == ty.int16) {
+         read_func = global.functions.read.s16;
+         save_func = global.functions.save.s16;
+      } else if (vt_canonical == ty.int32) {
+         read_func = global.functions.read.s32;
+         save_func = global.functions.save.s32;
+      }
+      //*/
+      size_t bitcount = 0;
+      if (vt_canonical == ty.uint8 || vt_canonical == ty.int8 || vt_canonical == ty.basic_char) {
+         bitcount = 8;
+      } else if (vt_canonical == ty.uint16 || vt_canonical == ty.int16) {
+         bitcount = 16;
+      } else if (vt_canonical == ty.uint32 || vt_canonical == ty.int32) {
+         bitcount = 32;
+      } else if (vt_canonical == ty.basic_int) {
+         bitcount = ty.basic_int.bitcount();
+      } else {
+         //
+         // Bitfield type or unsupported type.
+         //
+         bitcount = vt_canonical.size_in_bits();
+      }
+      if (bitcount <= 8) {
+         read_func = global.functions.read.u8;
+         save_func = global.functions.save.u8;
+      } else if (bitcount <= 16) {
+         read_func = global.functions.read.u16;
+         save_func = global.functions.save.u16;
+      } else if (bitcount <= 32) {
+         read_func = global.functions.read.u32;
+         save_func = global.functions.save.u32;
+      } else {
+         assert(bitcount != 0 && "Unknown integral type!");
+         assert(false && "The `int` type has an unexpected/unsupported bitcount!");
+      }
+   }
+   
+   // The bits that a save would write for an integral value, as the type that 
+   // the read function returns.
+   static gw::value _packed_bits_of(
+      gw::value                        value,
+      const typed_options::integral&   options,
+      gw::type::integral               packed_type,
+      const utils::generation_context& ctxt
+   ) {
+      if (!options.value_set.empty()) {
+         return value_set::index_of(options.value_set, value, ctxt).conversion_sans_bytecode(packed_type);
+      }
+      if (options.min != 0 && options.min != typed_options::integral::no_minimum) {
+         auto type = value.value_type().with_all_qualifiers_stripped().as_integral();
+         value = value.sub(gw::constant::integer(type, options.min));
+      }
+      value = value.conversion_sans_bytecode(packed_type);
+      if (options.bitcount < packed_type.bitcount()) {
+         auto mask = (uintmax_t(1) << options.bitcount) - 1;
+         value = value.bitwise_and(gw::constant::integer(packed_type, mask));
+      }
+      return value;
+   }
+   
+   // Given the bits that a save would write for a value (see above), extracts 
+   // one slice of them, shifted down to the least significant bit.
+   static gw::value _sliced_bits_of(gw::value packed, const bit_slice_info& slice) {
+      const auto& ty = gw::builtin_types::get();
+      
+      auto packed_type = packed.value_type().as_integral();
+      if (slice.start > 0)
+         packed = packed.shift_right(gw::constant::integer(ty.basic_int, slice.start));
+      auto mask = (uintmax_t(1) << slice.count) - 1;
+      return packed.bitwise_and(gw::constant::integer(packed_type, mask));
+   }
+   
+   // Views some of a value's bytes as an array of `uint8_t`, for buffers and 
+   // strings that are split across sectors.
+   static gw::value _byte_range_of(gw::value value, const array_access_info& range) {
+      const auto& ty = gw::builtin_types::get();
+      
+      auto whole = value.address_of().conversion_sans_bytecode(
+         ty.uint8.add_array_extent(range.start + range.count).add_pointer()
+      ).dereference();
+      auto first = whole.access_array_element(gw::constant::integer(ty.basic_int, range.start));
+      return first.address_of().conversion_sans_bytecode(
+         ty.uint8.add_array_extent(range.count).add_pointer()
+      ).dereference();
+   }
+   
+   // *checksum = func_checksum_update(*checksum, word, bitcount);
+   static gw::expr::base _update_checksum(gw::value checksum_ptr, gw::value word, size_t bitcount) {
+      const auto& ty     = gw::builtin_types::get();
+      const auto& global = basic_global_state::get().global_options;
+      assert(!!global.functions.checksum_update);
+      
+      auto checksum = checksum_ptr.dereference();
+      return gw::expr::assign(
+         checksum,
+         gw::expr::call(
+            *global.functions.checksum_update,
+            // args:
+            checksum,
+            word.convert_to_integer(ty.uint32),
+            gw::constant::integer(ty.uint8, bitcount)
+         )
+      );
+   }
+   
+   // Feeds each byte of an array into the checksum. If the array holds a 
+   // string that requires a terminator, then we stop at the terminator: the 
+   // string functions don't preserve whatever follows it.
+   static gw::expr::base _update_checksum_bytewise(gw::value checksum_ptr, gw::value array, bool stop_at_terminator) {
+      const auto& ty = gw::builtin_types::get();
+      
+      auto array_type = array.value_type().as_array();
+      assert(array_type.extent().has_value());
+      
+      gw::flow::simple_for_loop loop(ty.basic_int);
+      loop.counter_bounds = {
+         .start     = 0,
+         .last      = (uintmax_t)(*array_type.extent() - 1),
+         .increment = 1,
+      };
+      
+      auto byte = array.access_array_element(loop.counter.as_value()).convert_to_integer(ty.uint8);
+      
+      gw::statement_list loop_body;
+      if (stop_at_terminator) {
+         gw::flow::simple_if_else_set branches;
+         branches.add_branch(
+            byte.cmp_is_equal(gw::constant::integer(ty.uint8, 0)),
+            gw::expr::go_to_label(loop.label_break)
+         );
+         loop_body.append(*branches.result);
+      }
+      loop_body.append(_update_checksum(checksum_ptr, byte, 8));
+      loop.bake(std::move(loop_body));
+      
+      return loop.enclosing;
+   }
+   
+   // Feeds a value that has just been read, or is about to be saved, into the 
+   // checksum. Both operations feed the same words for the same serialized 
+   // data, so that the checksums match.
+   static gw::expr::optional_base _update_checksum_for(
+      const bitpacking::data_options&         options,
+      gw::value                               checksum_ptr,
+      gw::value                               value,
+      const std::optional<bit_slice_info>&    slice,
+      const std::optional<array_access_info>& byte_slice,
+      const utils::generation_context&        ctxt
+   ) {
+      const auto& ty = gw::builtin_types::get();
+      
+      if (options.is<typed_options::boolean>()) {
+         return _update_checksum(checksum_ptr, value.convert_to_truth_value(), 1);
+      }
+      
+      if (options.is<typed_options::buffer>()) {
+         if (byte_slice.has_value()) {
+            return _update_checksum_bytewise(checksum_ptr, _byte_range_of(value, *byte_slice), false);
+         }
+         auto bytecount = options.as<typed_options::buffer>().bytecount;
+         auto bytes     = value.address_of().conversion_sans_bytecode(
+            ty.uint8.add_const().add_array_extent(bytecount).add_pointer()
+         ).dereference();
+         return _update_checksum_bytewise(checksum_ptr, bytes, false);
+      }
+      
+      if (options.is<typed_options::delta>()) {
+         //
+         // The transfer loop feeds each serialized value into the checksum 
+         // itself.
+         //
+         return {};
+      }
+      
+      if (options.is<typed_options::integral>()) {
+         auto& int_opt = options.as<typed_options::integral>();
+         
+         gw::decl::optional_function read_func;
+         gw::decl::optional_function save_func;
+         _get_integral_functions_for(value.value_type(), read_func, save_func);
+         assert(!!read_func);
+         
+         auto packed_type = read_func->function_type().return_type().as_integral();
+         auto packed      = _packed_bits_of(value, int_opt, packed_type, ctxt);
+         if (slice.has_value()) {
+            return _update_checksum(checksum_ptr, _sliced_bits_of(packed, *slice), slice->count);
+         }
+         return _update_checksum(checksum_ptr, packed, int_opt.bitcount);
+      }
+      
+      if (options.is<typed_options::quantized>()) {
+         auto& q_opt = options.as<typed_options::quantized>();
+         return _update_checksum(checksum_ptr, quantize::packed_bits_of(q_opt, value), q_opt.bitcount);
+      }
+      
+      if (options.is<typed_options::pointer>()) {
+         auto& ptr_opt = options.as<typed_options::pointer>();
+         if (ptr_opt.into) {
+            return _update_checksum(checksum_ptr, pointer_into::packed_bits_of(ptr_opt, value), ptr_opt.bitcount);
+         }
+         
+         auto bitcount = value.value_type().size_in_bits();
+         return _update_checksum(
+            checksum_ptr,
+            value.conversion_sans_bytecode(ty.smallest_integral_for(bitcount, false)),
+            bitcount
+         );
+      }
+      
+      if (options.is<typed_options::string>()) {
+         auto& str_opt = options.as<typed_options::string>();
+         if (str_opt.uses_charset()) {
+            //
+            // The transfer loop feeds each character's code into the checksum 
+            // itself.
+            //
+            return {};
+         }
+         if (byte_slice.has_value()) {
+            assert(str_opt.nonstring);
+            return _update_checksum_bytewise(checksum_ptr, _byte_range_of(value, *byte_slice), false);
+         }
+         return _update_checksum_bytewise(checksum_ptr, value, !str_opt.nonstring);
+      }
+      
+      //
+      // Whole-struct functions update the checksum themselves.
+      //
+      return {};
+   }
+   
    /*virtual*/ expr_pair single::generate(const utils::generation_context& ctxt) const {
+      auto pair = this->_generate_transfer(ctxt);
+      if (!ctxt.checksum_ptr.read)
+         return pair;
+      
+      const auto& options = this->value.bitpacking_options();
+      if (options.is_omitted)
+         return pair;
+      
+      auto value = this->value.as_value_pair();
+      auto read  = _update_checksum_for(options, *ctxt.checksum_ptr.read, *value.read, this->bit_slice, this->byte_slice, ctxt);
+      auto save  = _update_checksum_for(options, *ctxt.checksum_ptr.save, *value.save, this->bit_slice, this->byte_slice, ctxt);
+      if (!read) {
+         assert(!save);
+         return pair;
+      }
+      
+      gw::expr::local_block block_read;
+      gw::expr::local_block block_save;
+      block_read.statements().append(pair.read);
+      block_read.statements().append(*read);
+      block_save.statements().append(*save);
+      block_save.statements().append(pair.save);
+      return expr_pair(block_read, block_save);
+   }
+   
+   expr_pair single::_generate_transfer(const utils::generation_context& ctxt) const {
       const auto& ty = gw::builtin_types::get();
       
       auto        value   = this->value.as_value_pair();
@@ -174,25 +469,40 @@ namespace codegen::instructions {
       
       if (options.is<typed_options::buffer>()) {
          auto bytecount = options.as<typed_options::buffer>().bytecount;
-         auto size_arg  = gw::constant::integer(ty.uint16, bytecount);
+         auto ptr_read  = value.read->address_of();
+         auto ptr_save  = value.save->address_of();
+         if (this->byte_slice.has_value()) {
+            //
+            // The buffer is split across sectors; transfer only the bytes that 
+            // are in this one.
+            //
+            bytecount = this->byte_slice->count;
+            ptr_read  = _byte_range_of(*value.read, *this->byte_slice).convert_array_to_pointer();
+            ptr_save  = _byte_range_of(*value.save, *this->byte_slice).convert_array_to_pointer();
+         }
+         auto size_arg = gw::constant::integer(ty.uint16, bytecount);
          return expr_pair(
             gw::expr::call(
                *global.functions.read.buffer,
                // args:
                *ctxt.state_ptr.read,
-               value.read->address_of(),
+               ptr_read,
                size_arg
             ),
             gw::expr::call(
                *global.functions.save.buffer,
                // args:
                *ctxt.state_ptr.save,
-               value.save->address_of(),
+               ptr_save,
                size_arg
             )
          );
       }
       
+      if (options.is<typed_options::delta>()) {
+         return delta::generate(options.as<typed_options::delta>(), value, ctxt);
+      }
+      
       if (options.is<typed_options::integral>()) {
          auto& int_opt = options.as<typed_options::integral>();
          
@@ -203,67 +513,80 @@ namespace codegen::instructions {
          }
          gw::decl::optional_function read_func;
          gw::decl::optional_function save_func;
-         {
-            auto vt_canonical = type.canonical();
-            //
-            // Because we add a `min` to the value before serializing, 
-            // we should basically never use the signed functions.
-            //
-            /*//
-            if (vt_canonical == ty.uint8 || vt_canonical == ty.basic_char) {
-               read_func = global.functions.read.u8;
-               save_func = global.functions.save.u8;
-            } else if (vt_canonical == ty.uint16) {
-               read_func = global.functions.read.u16;
-               save_func = global.functions.save.u16;
-            } else if (vt_canonical == ty.uint32) {
-               read_func = global.functions.read.u32;
-               save_func = global.functions.save.u32;
-            } else if (vt_canonical == ty.int8) {
-               read_func = global.functions.read.s8;
-               save_func = global.functions.save.s8;
-            } else if (vt_canonical == ty.int16) {
-               read_func = global.functions.read.s16;
-               save_func = global.functions.save.s16;
-            } else if (vt_canonical == ty.int32) {
-               read_func = global.functions.read.s32;
-               save_func = global.functions.save.s32;
-            }
-            //*/
-            size_t bitcount = 0;
-            if (vt_canonical == ty.uint8 || vt_canonical == ty.int8 || vt_canonical == ty.basic_char) {
-               bitcount = 8;
-            } else if (vt_canonical == ty.uint16 || vt_canonical == ty.int16) {
-               bitcount = 16;
-            } else if (vt_canonical == ty.uint32 || vt_canonical == ty.int32) {
-               bitcount = 32;
-            } else if (vt_canonical == ty.basic_int) {
-               bitcount = ty.basic_int.bitcount();
-            } else {
-               //
-               // Bitfield type or unsupported type.
-               //
-               bitcount = vt_canonical.size_in_bits();
-            }
-            if (bitcount <= 8) {
-               read_func = global.functions.read.u8;
-               save_func = global.functions.save.u8;
-            } else if (bitcount <= 16) {
-               read_func = global.functions.read.u16;
-               save_func = global.functions.save.u16;
-            } else if (bitcount <= 32) {
-               read_func = global.functions.read.u32;
-               save_func = global.functions.save.u32;
-            } else {
-               assert(bitcount != 0 && "Unknown integral type!");
-               assert(false && "The `int` type has an unexpected/unsupported bitcount!");
-            }
-         }
+         _get_integral_functions_for(type, read_func, save_func);
          assert(!!read_func);
          assert(!!save_func);
          
          auto ic_bitcount = gw::constant::integer(ty.uint8,           int_opt.bitcount);
          auto ic_min      = gw::constant::integer(type.as_integral(), int_opt.min);
+         bool has_min     = int_opt.min != 0 && int_opt.min != typed_options::integral::no_minimum;
+         
+         if (this->bit_slice.has_value()) {
+            //
+            // The value is split across sectors, and we're only transferring 
+            // some of its bits. Sectors can be read in any order, so when we 
+            // read, we repack the value as it stands (keeping any bits that 
+            // were read from other sectors) and replace just this slice's 
+            // bits, as with transformed values split across sectors.
+            //
+            assert(int_opt.value_set.empty());
+            const auto& slice       = *this->bit_slice;
+            auto        packed_type = read_func->function_type().return_type().as_integral();
+            auto        ic_count    = gw::constant::integer(ty.uint8, slice.count);
+            
+            uintmax_t slice_mask = ((uintmax_t(1) << slice.count) - 1) << slice.start;
+            uintmax_t whole_mask = (uintmax_t(1) << int_opt.bitcount) - 1;
+            
+            gw::value bits = gw::expr::call(
+               *read_func,
+               // args:
+               *ctxt.state_ptr.read,
+               ic_count
+            );
+            if (slice.start > 0)
+               bits = bits.shift_left(gw::constant::integer(ty.basic_int, slice.start));
+            
+            gw::value to_assign = _packed_bits_of(*value.read, int_opt, packed_type, ctxt)
+               .bitwise_and(gw::constant::integer(packed_type, whole_mask & ~slice_mask))
+               .bitwise_or(bits);
+            if (has_min)
+               to_assign = to_assign.add(ic_min);
+            
+            return expr_pair(
+               gw::expr::assign(*value.read, to_assign),
+               gw::expr::call(
+                  *save_func,
+                  // args:
+                  *ctxt.state_ptr.save,
+                  _sliced_bits_of(_packed_bits_of(*value.save, int_opt, packed_type, ctxt), slice),
+                  ic_count
+               )
+            );
+         }
+         
+         if (!int_opt.value_set.empty()) {
+            //
+            // Serialize the value's index within its value set, rather than 
+            // the value itself.
+            //
+            gw::value index = gw::expr::call(
+               *read_func,
+               // args:
+               *ctxt.state_ptr.read,
+               ic_bitcount
+            );
+            auto packed_type = save_func->function_type().nth_argument_type(1).as_integral();
+            return expr_pair(
+               gw::expr::assign(*value.read, value_set::value_at(int_opt.value_set, index)),
+               gw::expr::call(
+                  *save_func,
+                  // args:
+                  *ctxt.state_ptr.save,
+                  value_set::index_of(int_opt.value_set, *value.save, ctxt).convert_to_integer(packed_type),
+                  ic_bitcount
+               )
+            );
+         }
          
          optional_expr_pair out;
          {  // Read
@@ -273,7 +596,7 @@ namespace codegen::instructions {
                *ctxt.state_ptr.read,
                ic_bitcount
             );
-            if (int_opt.min != 0 && int_opt.min != typed_options::integral::no_minimum) {
+            if (has_min) {
                //
                // If a field's range of valid values is [a, b], then serialize it as (v - a), 
                // and then unpack it as (v + a). This means we don't need a sign bit when we 
@@ -286,7 +609,7 @@ namespace codegen::instructions {
          }
          {  // Save
             auto to_save = *value.save;
-            if (int_opt.min != 0 && int_opt.min != typed_options::integral::no_minimum)
+            if (has_min)
                to_save = to_save.sub(ic_min);
             out.save = gw::expr::call(
                *save_func,
@@ -299,8 +622,63 @@ namespace codegen::instructions {
          return out;
       }
       
+      if (options.is<typed_options::quantized>()) {
+         auto& q_opt = options.as<typed_options::quantized>();
+         
+         auto ic_bitcount = gw::constant::integer(ty.uint8, q_opt.bitcount);
+         return expr_pair(
+            gw::expr::assign(
+               *value.read,
+               quantize::unpacked_value_of(
+                  q_opt,
+                  gw::expr::call(
+                     *global.functions.read.u32,
+                     // args:
+                     *ctxt.state_ptr.read,
+                     ic_bitcount
+                  ),
+                  value.read->value_type()
+               )
+            ),
+            gw::expr::call(
+               *global.functions.save.u32,
+               // args:
+               *ctxt.state_ptr.save,
+               quantize::packed_bits_of(q_opt, *value.save),
+               ic_bitcount
+            )
+         );
+      }
+      
       if (options.is<typed_options::pointer>()) {
-         auto type = value.read->value_type();
+         auto& ptr_opt = options.as<typed_options::pointer>();
+         auto  type    = value.read->value_type();
+         if (ptr_opt.into) {
+            auto ic_bitcount = gw::constant::integer(ty.uint8, ptr_opt.bitcount);
+            return expr_pair(
+               gw::expr::assign(
+                  *value.read,
+                  pointer_into::unpacked_value_of(
+                     ptr_opt,
+                     gw::expr::call(
+                        *global.functions.read.u32,
+                        // args:
+                        *ctxt.state_ptr.read,
+                        ic_bitcount
+                     ),
+                     type
+                  )
+               ),
+               gw::expr::call(
+                  *global.functions.save.u32,
+                  // args:
+                  *ctxt.state_ptr.save,
+                  pointer_into::packed_bits_of(ptr_opt, *value.save),
+                  ic_bitcount
+               )
+            );
+         }
+         
          gw::decl::optional_function read_func;
          gw::decl::optional_function save_func;
          switch (type.size_in_bits()) {
@@ -346,6 +724,9 @@ namespace codegen::instructions {
       
       if (options.is<typed_options::string>()) {
          auto& str_opt = options.as<typed_options::string>();
+         if (str_opt.uses_charset()) {
+            return charset::generate(str_opt, value, ctxt);
+         }
          
          gw::decl::optional_function read_func;
          gw::decl::optional_function save_func;
@@ -359,20 +740,33 @@ namespace codegen::instructions {
          assert(!!read_func);
          assert(!!save_func);
          
-         auto length_arg = gw::constant::integer(ty.uint16, str_opt.length);
+         size_t length   = str_opt.length;
+         auto   ptr_read = value.read->convert_array_to_pointer();
+         auto   ptr_save = value.save->convert_array_to_pointer();
+         if (this->byte_slice.has_value()) {
+            //
+            // The string is split across sectors; transfer only the characters 
+            // that are in this one. (Only unterminated strings are split.)
+            //
+            assert(str_opt.nonstring);
+            length   = this->byte_slice->count;
+            ptr_read = _byte_range_of(*value.read, *this->byte_slice).convert_array_to_pointer();
+            ptr_save = _byte_range_of(*value.save, *this->byte_slice).convert_array_to_pointer();
+         }
+         auto length_arg = gw::constant::integer(ty.uint16, length);
          return expr_pair(
             gw::expr::call(
                *read_func,
                // args:
                *ctxt.state_ptr.read,
-               value.read->convert_array_to_pointer(),
+               ptr_read,
                length_arg
             ),
             gw::expr::call(
                *save_func,
                // args:
                *ctxt.state_ptr.save,
-               value.save->convert_array_to_pointer(),
+               ptr_save,
                length_arg
             )
          );
@@ -384,6 +778,24 @@ namespace codegen::instructions {
          
          auto func = ctxt.get_whole_struct_functions_for(type.as_record());
          
+         if (ctxt.checksum_ptr.read) {
+            return expr_pair(
+               gw::expr::call(
+                  func.read,
+                  // args:
+                  *ctxt.state_ptr.read,
+                  value.read->address_of(),
+                  *ctxt.checksum_ptr.read
+               ),
+               gw::expr::call(
+                  func.save,
+                  // args:
+                  *ctxt.state_ptr.save,
+                  value.save->address_of(),
+                  *ctxt.checksum_ptr.save
+               )
+            );
+         }
          return expr_pair(
             gw::expr::call(
                func.read,
@@ -402,4 +814,265 @@ namespace codegen::instructions {
       
       assert(false && "unreachable");
    }
+   
+   /*virtual*/ gw::expr::base single::generate_dirty_check(const utils::generation_context& ctxt) const {
+      const auto& ty = gw::builtin_types::get();
+      auto&       bgs = basic_global_state::get();
+      
+      auto        value   = this->value.as_value_pair();
+      const auto& options = this->value.bitpacking_options();
+      const auto& global  = bgs.global_options;
+      
+      //
+      // Omitted values aren't in the sector at all, so they can't make it 
+      // dirty.
+      //
+      if (options.is_omitted) {
+         return gw::expr::base::wrap(build_empty_stmt(UNKNOWN_LOCATION));
+      }
+      
+      gw::value live = *value.save;
+      
+      if (options.is<typed_options::boolean>()) {
+         gw::value packed = gw::expr::call(
+            *global.functions.read.boolean,
+            // args:
+            *ctxt.state_ptr.read
+         );
+         return ctxt.make_dirty_check_return_if(packed.logical_xor(live));
+      }
+      
+      if (options.is<typed_options::buffer>()) {
+         assert(!!bgs.builtin_functions.memcmp);
+         auto bytecount = options.as<typed_options::buffer>().bytecount;
+         
+         //
+         // If the buffer is split across sectors, then only check the bytes 
+         // that are in this one.
+         //
+         if (this->byte_slice.has_value()) {
+            bytecount = this->byte_slice->count;
+            live      = _byte_range_of(live, *this->byte_slice);
+         }
+         
+         gw::expr::local_block block;
+         auto statements = block.statements();
+         
+         //
+         // The live value may be const (i.e. a member of a struct we received 
+         // by const pointer), so don't use its type for our scratch space.
+         //
+         auto temp = gw::decl::variable("__dirty_check_buffer", ty.uint8.add_array_extent(bytecount));
+         temp.make_artificial();
+         statements.append(temp.make_declare_expr());
+         statements.append(gw::expr::call(
+            *global.functions.read.buffer,
+            // args:
+            *ctxt.state_ptr.read,
+            temp.as_value().convert_array_to_pointer(),
+            gw::constant::integer(ty.uint16, bytecount)
+         ));
+         gw::value differs = gw::expr::call(
+            *bgs.builtin_functions.memcmp,
+            // args:
+            temp.as_value().convert_array_to_pointer().conversion_sans_bytecode(ty.const_void_ptr),
+            live.address_of().conversion_sans_bytecode(ty.const_void_ptr),
+            gw::constant::integer(ty.size, bytecount)
+         );
+         statements.append(ctxt.make_dirty_check_return_if(
+            differs.cmp_is_not_equal(gw::constant::integer(ty.basic_int, 0))
+         ));
+         return block;
+      }
+      
+      if (options.is<typed_options::delta>()) {
+         return delta::generate_dirty_check(options.as<typed_options::delta>(), live, ctxt);
+      }
+      
+      if (options.is<typed_options::integral>()) {
+         auto& int_opt = options.as<typed_options::integral>();
+         
+         auto type = live.value_type();
+         gw::decl::optional_function read_func;
+         gw::decl::optional_function save_func;
+         _get_integral_functions_for(type, read_func, save_func);
+         assert(!!read_func);
+         
+         //
+         // If the value is split across sectors, then only check the bits 
+         // that are in this one.
+         //
+         size_t bitcount = int_opt.bitcount;
+         if (this->bit_slice.has_value())
+            bitcount = this->bit_slice->count;
+         
+         gw::value packed = gw::expr::call(
+            *read_func,
+            // args:
+            *ctxt.state_ptr.read,
+            gw::constant::integer(ty.uint8, bitcount)
+         );
+         auto packed_type = packed.value_type().as_integral();
+         //
+         // Compare the bits that a save would write, rather than the value 
+         // that a read would produce; a value that's out of range will never 
+         // survive a round-trip, but re-saving it won't change the sector.
+         //
+         auto expected = _packed_bits_of(live, int_opt, packed_type, ctxt);
+         if (this->bit_slice.has_value())
+            expected = _sliced_bits_of(expected, *this->bit_slice);
+         return ctxt.make_dirty_check_return_if(packed.cmp_is_not_equal(expected));
+      }
+      
+      if (options.is<typed_options::quantized>()) {
+         auto& q_opt = options.as<typed_options::quantized>();
+         
+         gw::value packed = gw::expr::call(
+            *global.functions.read.u32,
+            // args:
+            *ctxt.state_ptr.read,
+            gw::constant::integer(ty.uint8, q_opt.bitcount)
+         );
+         //
+         // As with integrals, compare the bits that a save would write; most 
+         // values don't survive a round-trip exactly.
+         //
+         return ctxt.make_dirty_check_return_if(
+            packed.cmp_is_not_equal(quantize::packed_bits_of(q_opt, live))
+         );
+      }
+      
+      if (options.is<typed_options::pointer>()) {
+         auto& ptr_opt = options.as<typed_options::pointer>();
+         if (ptr_opt.into) {
+            gw::value packed = gw::expr::call(
+               *global.functions.read.u32,
+               // args:
+               *ctxt.state_ptr.read,
+               gw::constant::integer(ty.uint8, ptr_opt.bitcount)
+            );
+            return ctxt.make_dirty_check_return_if(
+               packed.cmp_is_not_equal(pointer_into::packed_bits_of(ptr_opt, live))
+            );
+         }
+         
+         auto type = live.value_type();
+         gw::decl::optional_function read_func;
+         switch (type.size_in_bits()) {
+            case 8:
+               read_func = global.functions.read.u8;
+               break;
+            case 16:
+               read_func = global.functions.read.u16;
+               break;
+            case 32:
+               read_func = global.functions.read.u32;
+               break;
+            default:
+               assert(false && "unsupported pointer size");
+         }
+         assert(!!read_func);
+         
+         gw::value packed = gw::expr::call(
+            *read_func,
+            // args:
+            *ctxt.state_ptr.read,
+            gw::constant::integer(ty.uint8, type.size_in_bits())
+         );
+         return ctxt.make_dirty_check_return_if(
+            packed.cmp_is_not_equal(live.conversion_sans_bytecode(packed.value_type()))
+         );
+      }
+      
+      if (options.is<typed_options::string>()) {
+         auto& str_opt = options.as<typed_options::string>();
+         if (str_opt.uses_charset()) {
+            return charset::generate_dirty_check(str_opt, live, ctxt);
+         }
+         
+         gw::decl::optional_function read_func;
+         if (str_opt.nonstring) {
+            assert(!!bgs.builtin_functions.memcmp);
+            read_func = global.functions.read.string_ut;
+         } else {
+            assert(!!bgs.builtin_functions.strncmp);
+            read_func = global.functions.read.string_nt;
+         }
+         assert(!!read_func);
+         
+         size_t length     = str_opt.length;
+         auto   array_type = live.value_type().as_array();
+         auto   char_type  = array_type.value_type().with_all_qualifiers_stripped();
+         size_t extent     = *array_type.extent();
+         if (this->byte_slice.has_value()) {
+            //
+            // The string is split across sectors; only check the characters 
+            // that are in this one. Only unterminated strings can be split, 
+            // and those compare with memcmp below: a slice can hold a NUL 
+            // with live bytes after it.
+            //
+            assert(str_opt.nonstring);
+            length = extent = this->byte_slice->count;
+            live   = _byte_range_of(live, *this->byte_slice);
+         }
+         
+         gw::expr::local_block block;
+         auto statements = block.statements();
+         
+         auto temp = gw::decl::variable(
+            "__dirty_check_string",
+            char_type.add_array_extent(extent)
+         );
+         temp.make_artificial();
+         statements.append(temp.make_declare_expr());
+         statements.append(gw::expr::call(
+            *read_func,
+            // args:
+            *ctxt.state_ptr.read,
+            temp.as_value().convert_array_to_pointer(),
+            gw::constant::integer(ty.uint16, length)
+         ));
+         //
+         // Null-terminated strings compare as strings: whatever follows the 
+         // terminator isn't part of the value. Unterminated strings are read 
+         // and saved byte-for-byte, including anything after an embedded 
+         // NUL, so they have to compare that way too.
+         //
+         auto compare  = bgs.builtin_functions.strncmp;
+         auto ptr_type = ty.const_char_ptr;
+         if (str_opt.nonstring) {
+            compare  = bgs.builtin_functions.memcmp;
+            ptr_type = ty.const_void_ptr;
+         }
+         gw::value differs = gw::expr::call(
+            *compare,
+            // args:
+            temp.as_value().convert_array_to_pointer().conversion_sans_bytecode(ptr_type),
+            live.convert_array_to_pointer().conversion_sans_bytecode(ptr_type),
+            gw::constant::integer(ty.size, length)
+         );
+         statements.append(ctxt.make_dirty_check_return_if(
+            differs.cmp_is_not_equal(gw::constant::integer(ty.basic_int, 0))
+         ));
+         return block;
+      }
+      
+      if (options.is<typed_options::structure>()) {
+         auto type = live.value_type();
+         assert(type.is_record());
+         
+         auto func = ctxt.get_whole_struct_dirty_check_for(type.as_record());
+         gw::value differs = gw::expr::call(
+            func,
+            // args:
+            *ctxt.state_ptr.read,
+            live.address_of()
+         );
+         return ctxt.make_dirty_check_return_if(
+            differs.cmp_is_not_equal(gw::constant::integer(ty.basic_int, 0))
+         );
+      }
+      
+      assert(false && "unreachable");
+   }
 }
\ No newline at end of file
@@ -222,6 +222,55 @@ namespace codegen::instructions {
       return expr_pair(block_read, block_save);
    }
    
+   /*virtual*/ gw::expr::base transform::generate_dirty_check(const utils::generation_context& ctxt) const {
+      auto& decl_dict = decl_dictionary::get();
+      
+      gw::expr::local_block block;
+      assert(!this->types.empty());
+      
+      auto statements = block.statements();
+      
+      //
+      // Pack the live value the same way a save would, and then check the 
+      // final transformed value against the sector.
+      //
+      gw::value in_situ = *this->to_be_transformed_value.as_value_pair().save;
+      const decl_descriptor* prev_desc = nullptr;
+      for(size_t i = 0; i < types.size(); ++i) {
+         auto type = this->types[i];
+         
+         gw::decl::optional_variable var;
+         if (i == this->types.size() - 1) {
+            var = this->transformed.variables.save;
+         } else {
+            auto name = lu::stringf("__transformed_check_as_%s", type.name().data());
+            var = gw::decl::variable(name.c_str(), type);
+         }
+         statements.append(var->make_declare_expr());
+         
+         const auto& options = (
+            i == 0 ?
+               this->to_be_transformed_value.bitpacking_options()
+            :
+               prev_desc->options
+         ).as<typed_options::transformed>();
+         statements.append(gw::expr::call(
+            *options.pre_pack,
+            // args:
+            in_situ.address_of(), // in situ
+            var->as_value().address_of() // transformed
+         ));
+         
+         prev_desc = &decl_dict.describe(*var);
+         in_situ   = var->as_value();
+      }
+      for(auto& child_ptr : this->instructions) {
+         statements.append(child_ptr->generate_dirty_check(ctxt));
+      }
+      
+      return block;
+   }
+   
    bool transform::is_probably_split() const {
       if (this->instructions.empty())
          return false;
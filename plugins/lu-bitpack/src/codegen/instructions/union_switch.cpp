@@ -48,4 +48,33 @@ namespace codegen::instructions {
       }
       return expr_pair(*branches_read.result, *branches_save.result);
    }
+   
+   /*virtual*/ gw::expr::base union_switch::generate_dirty_check(const utils::generation_context& ctxt) const {
+      if (this->cases.empty()) {
+         return gw::expr::base::wrap(build_empty_stmt(UNKNOWN_LOCATION));
+      }
+      
+      //
+      // Branch on the live tag. If the packed tag differs from it, then we'll 
+      // have already noticed that when checking the tag itself; and if the tag 
+      // lives in an earlier sector, then all that matters for this sector is 
+      // whether it holds what we'd write for the live tag.
+      //
+      auto operand      = *this->condition_operand.as_value_pair().save;
+      auto operand_type = operand.value_type();
+      assert(operand_type.is_boolean() || operand_type.is_enum() || operand_type.is_integer());
+      
+      gw::flow::simple_if_else_set branches;
+      for(auto& pair : this->cases) {
+         auto pair_rhs = gw::constant::integer(operand_type.as_integral(), pair.first);
+         branches.add_branch(
+            operand.cmp_is_equal(pair_rhs),
+            pair.second->generate_dirty_check(ctxt)
+         );
+      }
+      if (this->else_case.get()) {
+         branches.set_else_branch(this->else_case->generate_dirty_check(ctxt));
+      }
+      return *branches.result;
+   }
 }
\ No newline at end of file
@@ -1,14 +1,19 @@
 #include "lu/stringf.h"
 #include <memory> // GCC headers fuck up string-related STL identifiers that <memory> depends on
 #include "codegen/instructions/utils/generation_context.h"
+#include "gcc_wrappers/constant/integer.h"
 #include "gcc_wrappers/decl/field.h"
 #include "gcc_wrappers/decl/function.h"
 #include "gcc_wrappers/decl/result.h"
+#include "gcc_wrappers/expr/assign.h"
 #include "gcc_wrappers/expr/local_block.h"
+#include "gcc_wrappers/expr/return_result.h"
+#include "gcc_wrappers/flow/simple_if_else_set.h"
 #include "gcc_wrappers/type/function.h"
 #include "gcc_wrappers/builtin_types.h"
 #include "bitpacking/global_options.h"
 #include "basic_global_state.h"
+#include "time_report.h"
 #include "codegen/instructions/utils/walk.h"
 #include "codegen/instructions/array_slice.h"
 #include "codegen/instructions/base.h"
@@ -20,6 +25,7 @@
 #include "codegen/serialization_item_list_ops/force_expand_omitted_and_defaulted.h"
 #include "codegen/decl_descriptor.h"
 #include "codegen/decl_dictionary.h"
+#include "codegen/mixed_radix.h"
 #include "codegen/rechunked/item.h"
 #include "codegen/rechunked/items_to_instruction_tree.h"
 #include "codegen/serialization_item.h"
@@ -30,30 +36,78 @@ namespace gw {
 }
 
 namespace codegen::instructions::utils {
+   std::unique_ptr<instructions::base> make_instruction_tree_for(const decl_descriptor& desc, bool whole_struct) {
+      std::vector<serialization_item> si;
+      {
+         serialization_item item;
+         auto& segm = item.segments.emplace_back();
+         auto& data = segm.data.emplace<serialization_items::basic_segment>();
+         data.desc = &desc;
+         //
+         // Mixed-radix structs can't be expanded when they appear within 
+         // other values, but when we're generating their own whole-struct 
+         // functions, we still want a tree of their members.
+         //
+         if (item.can_expand() || (whole_struct && mixed_radix::is_mixed_radix(desc)))
+            si = item.expanded();
+         else
+            si.push_back(item);
+         
+         serialization_item_list_ops::fold_sequential_array_elements(si);
+         serialization_item_list_ops::force_expand_unions_and_anonymous(si);
+         serialization_item_list_ops::force_expand_omitted_and_defaulted(si);
+      }
+      std::vector<rechunked::item> ri;
+      {
+         size_t size = si.size();
+         ri.resize(size);
+         for(size_t i = 0; i < size; ++i)
+            ri[i] = rechunked::item(si[i]);
+      }
+      return rechunked::items_to_instruction_tree(ri);
+   }
+   
    whole_struct_function_info generation_context::_make_whole_struct_functions_for(gw::type::record type) const {
       const auto& ty = gw::builtin_types::get_fast();
+      const auto& global = basic_global_state::get().global_options;
       auto& decl_dict = decl_dictionary::get();
       
+      //
+      // If checksums are enabled, then the caller's running checksum is passed 
+      // in as an additional argument:
+      //
+      // void __lu_bitpack_read_StructName(struct lu_BitstreamState*, StructName*, checksum_type*);
+      //
+      auto _make_function_type = [&global, &ty](gw::type::base struct_ptr_type) {
+         if (global.checksums_enabled()) {
+            return gw::type::function(
+               ty.basic_void,
+               // args:
+               *global.types.bitstream_state_ptr,
+               struct_ptr_type,
+               *global.types.checksum_ptr
+            );
+         }
+         return gw::type::function(
+            ty.basic_void,
+            // args:
+            *global.types.bitstream_state_ptr,
+            struct_ptr_type
+         );
+      };
+      
       auto result = func_pair(
          gw::decl::function(
             lu::strings::zview(lu::stringf("__lu_bitpack_read_%s", type.name().data())),
-            gw::type::function(
-               ty.basic_void,
-               // args:
-               *basic_global_state::get().global_options.types.bitstream_state_ptr,
-               type.add_pointer()
-            )
+            _make_function_type(type.add_pointer())
          ),
          gw::decl::function(
             lu::strings::zview(lu::stringf("__lu_bitpack_save_%s", type.name().data())),
-            gw::type::function(
-               ty.basic_void,
-               // args:
-               *basic_global_state::get().global_options.types.bitstream_state_ptr,
-               type.add_const().add_pointer()
-            )
+            _make_function_type(type.add_const().add_pointer())
          )
       );
+      result.read.apply_attributes(this->function_attributes);
+      result.save.apply_attributes(this->function_attributes);
       result.read.as_modifiable().set_result_decl(gw::decl::result(ty.basic_void));
       result.save.as_modifiable().set_result_decl(gw::decl::result(ty.basic_void));
       
@@ -61,35 +115,17 @@ namespace codegen::instructions::utils {
       result.save.nth_parameter(0).make_used();
       result.read.nth_parameter(1).make_used();
       result.save.nth_parameter(1).make_used();
+      if (global.checksums_enabled()) {
+         result.read.nth_parameter(2).make_used();
+         result.save.nth_parameter(2).make_used();
+      }
       
-      std::unique_ptr<instructions::base> root;
       //
       // Generate the tree of nodes for reads based on the PARM_DECL for the 
       // "read" function's in-struct argument. Then, update the tree's "save" 
       // descriptor pointers to poit to the PARM_DECL for "save."
       //
-      {
-         std::vector<serialization_item> si;
-         {
-            serialization_item item;
-            auto& segm = item.segments.emplace_back();
-            auto& data = segm.data.emplace<serialization_items::basic_segment>();
-            data.desc = &decl_dict.dereference_and_describe(result.read.nth_parameter(1));
-            si = item.expanded();
-            
-            serialization_item_list_ops::fold_sequential_array_elements(si);
-            serialization_item_list_ops::force_expand_unions_and_anonymous(si);
-            serialization_item_list_ops::force_expand_omitted_and_defaulted(si);
-         }
-         std::vector<rechunked::item> ri;
-         {
-            size_t size = si.size();
-            ri.resize(size);
-            for(size_t i = 0; i < size; ++i)
-               ri[i] = rechunked::item(si[i]);
-         }
-         root = rechunked::items_to_instruction_tree(ri);
-      }
+      auto root = make_instruction_tree_for(decl_dict.dereference_and_describe(result.read.nth_parameter(1)), true);
       //
       // Do the update.
       //
@@ -130,6 +166,26 @@ namespace codegen::instructions::utils {
          );
       }
       
+      //
+      // Mixed-radix structs are packed as combined integers rather than by 
+      // walking the node tree. Check them even if we're only declaring 
+      // their functions, so that errors are reported in every translation 
+      // unit.
+      //
+      std::optional<mixed_radix::layout> radix_layout;
+      if (mixed_radix::is_mixed_radix(decl_dict.dereference_and_describe(result.read.nth_parameter(1))))
+         radix_layout = mixed_radix::compute_layout(type, true);
+      
+      if (!this->define_whole_struct_functions) {
+         result.read.introduce_to_current_scope();
+         result.save.introduce_to_current_scope();
+         
+         whole_struct_function_info info;
+         info.functions         = result;
+         info.instructions_root = std::move(root);
+         return info;
+      }
+      
       //
       // Now we can actually generate code from that node hierarchy.
       //
@@ -138,7 +194,25 @@ namespace codegen::instructions::utils {
          result.read.nth_parameter(0).as_value(),
          result.save.nth_parameter(0).as_value()
       );
-      auto root_expr = root->generate(context);
+      if (global.checksums_enabled()) {
+         context.checksum_ptr = optional_value_pair(
+            result.read.nth_parameter(2).as_value(),
+            result.save.nth_parameter(2).as_value()
+         );
+      }
+      auto root_expr =
+         radix_layout ?
+            mixed_radix::generate(
+               *radix_layout,
+               optional_value_pair(
+                  result.read.nth_parameter(1).as_value().dereference(),
+                  result.save.nth_parameter(1).as_value().dereference()
+               ),
+               context
+            )
+         :
+            root->generate(context)
+      ;
       
       if (!root_expr.read.is<gw::expr::local_block>()) {
          gw::expr::local_block block;
@@ -176,6 +250,7 @@ namespace codegen::instructions::utils {
       auto pair = this->whole_struct_functions.get_functions_for(type);
       if (!pair.read) {
          assert(!pair.save);
+         time_report::scoped_phase phase_timing(time_report::phase::whole_struct);
          auto info = this->_make_whole_struct_functions_for(type);
          pair = info.functions;
          this->whole_struct_functions.add_functions_for(type, std::move(info));
@@ -184,4 +259,107 @@ namespace codegen::instructions::utils {
       }
       return pair;
    }
+   
+   void generation_context::_make_whole_struct_dirty_check_for(gw::type::record type) const {
+      const auto& ty = gw::builtin_types::get_fast();
+      auto& decl_dict = decl_dictionary::get();
+      
+      // int __lu_bitpack_is_dirty_StructName(struct lu_BitstreamState*, const StructName*);
+      auto func = gw::decl::function(
+         lu::strings::zview(lu::stringf("__lu_bitpack_is_dirty_%s", type.name().data())),
+         gw::type::function(
+            ty.basic_int,
+            // args:
+            *basic_global_state::get().global_options.types.bitstream_state_ptr,
+            type.add_const().add_pointer()
+         )
+      );
+      func.apply_attributes(this->function_attributes);
+      auto result_decl = gw::decl::result(ty.basic_int);
+      func.as_modifiable().set_result_decl(result_decl);
+      
+      func.nth_parameter(0).make_used();
+      func.nth_parameter(1).make_used();
+      
+      //
+      // The tree is built from the struct argument, so its "read" and "save" 
+      // descriptors are one and the same; no fix-up is needed.
+      //
+      const auto& root_desc = decl_dict.dereference_and_describe(func.nth_parameter(1));
+      auto root = make_instruction_tree_for(root_desc, true);
+      
+      std::optional<mixed_radix::layout> radix_layout;
+      if (mixed_radix::is_mixed_radix(root_desc))
+         radix_layout = mixed_radix::compute_layout(type);
+      
+      if (!this->define_whole_struct_functions) {
+         func.introduce_to_current_scope();
+         this->whole_struct_functions.add_dirty_check_for(type, func, std::move(root));
+         return;
+      }
+      
+      generation_context context = *this;
+      context.state_ptr = optional_value_pair(
+         func.nth_parameter(0).as_value(),
+         func.nth_parameter(0).as_value()
+      );
+      context.checksum_ptr       = optional_value_pair();
+      context.dirty_check_result = result_decl;
+      
+      gw::expr::local_block root_block;
+      {
+         auto statements = root_block.statements();
+         if (radix_layout) {
+            statements.append(mixed_radix::generate_dirty_check(
+               *radix_layout,
+               func.nth_parameter(1).as_value().dereference(),
+               context
+            ));
+         } else {
+            statements.append(root->generate_dirty_check(context));
+         }
+         statements.append(gw::expr::return_result(
+            gw::expr::assign(result_decl.as_value(), gw::constant::integer(ty.basic_int, 0))
+         ));
+      }
+      
+      func.set_is_defined_elsewhere(false);
+      func.as_modifiable().set_root_block(root_block);
+      
+      // expose this identifier so we can inspect it with our debug-dump pragmas.
+      func.introduce_to_current_scope();
+      
+      this->whole_struct_functions.add_dirty_check_for(type, func, std::move(root));
+   }
+   
+   gw::decl::function generation_context::get_whole_struct_dirty_check_for(gw::type::record type) const {
+      //
+      // Make sure the struct has an entry in the dictionary first.
+      //
+      this->get_whole_struct_functions_for(type);
+      
+      auto func = this->whole_struct_functions.get_dirty_check_for(type);
+      if (!func) {
+         time_report::scoped_phase phase_timing(time_report::phase::whole_struct);
+         this->_make_whole_struct_dirty_check_for(type);
+         func = this->whole_struct_functions.get_dirty_check_for(type);
+         assert(!!func);
+      }
+      return *func;
+   }
+   
+   gw::expr::base generation_context::make_dirty_check_return_if(gw::value condition) const {
+      const auto& ty = gw::builtin_types::get_fast();
+      assert(!!this->dirty_check_result);
+      gw::decl::result result_decl = *this->dirty_check_result;
+      
+      gw::flow::simple_if_else_set branches;
+      branches.add_branch(
+         condition,
+         gw::expr::return_result(
+            gw::expr::assign(result_decl.as_value(), gw::constant::integer(ty.basic_int, 1))
+         )
+      );
+      return *branches.result;
+   }
 }
\ No newline at end of file
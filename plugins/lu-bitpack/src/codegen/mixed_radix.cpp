@@ -0,0 +1,357 @@
+#include "codegen/mixed_radix.h"
+#include <bit>
+#include <cassert>
+#include "bitpacking/data_options.h"
+#include "bitpacking/global_options.h"
+#include "basic_global_state.h"
+#include "codegen/instructions/utils/generation_context.h"
+#include "codegen/decl_descriptor.h"
+#include "codegen/decl_dictionary.h"
+#include "codegen/value_set.h"
+#include "gcc_wrappers/constant/integer.h"
+#include "gcc_wrappers/decl/field.h"
+#include "gcc_wrappers/decl/variable.h"
+#include "gcc_wrappers/expr/assign.h"
+#include "gcc_wrappers/expr/call.h"
+#include "gcc_wrappers/expr/local_block.h"
+#include "gcc_wrappers/builtin_types.h"
+#include <diagnostic.h>
+namespace gw {
+   using namespace gcc_wrappers;
+}
+namespace typed_options {
+   using namespace bitpacking::typed_data_options::computed;
+}
+
+namespace codegen::mixed_radix {
+   // A group is read or saved with one call to the 32-bit bitstream functions.
+   static constexpr const uintmax_t max_group_range = uintmax_t(1) << 32;
+   
+   extern bool is_mixed_radix(const bitpacking::data_options& options, gw::type::base serialized_type) {
+      if (!options.is<typed_options::structure>())
+         return false;
+      if (!options.as<typed_options::structure>().mixed_radix)
+         return false;
+      return serialized_type.is_record() && !serialized_type.name().empty();
+   }
+   extern bool is_mixed_radix(const decl_descriptor& desc) {
+      if (!desc.types.serialized)
+         return false;
+      return is_mixed_radix(desc.options, *desc.types.serialized);
+   }
+   
+   extern std::optional<layout> compute_layout(gw::type::record type, bool report_errors) {
+      auto& dictionary = decl_dictionary::get_fast();
+      
+      std::vector<digit> digits;
+      size_t unpacked = 0;
+      bool   failed   = false;
+      
+      auto _fail = [&failed, report_errors, type](gw::decl::field decl, const char* reason) {
+         failed = true;
+         if (!report_errors)
+            return;
+         auto name = type.name();
+         error_at(decl.source_location(), "struct %<%s%> is marked for mixed-radix packing, but member %qE %s", name.c_str(), decl.unwrap(), reason);
+      };
+      
+      type.for_each_referenceable_field([&](gw::decl::field decl) {
+         const auto& desc = dictionary.describe(decl);
+         if (desc.options.is_omitted) {
+            if (desc.is_or_contains_defaulted())
+               _fail(decl, "is omitted and defaulted; defaulted members are not supported");
+            return;
+         }
+         
+         digit  proto;
+         size_t bitcount = 0;
+         proto.member = &desc;
+         if (desc.options.is<typed_options::boolean>()) {
+            proto.radix = 2;
+            bitcount    = 1;
+         } else if (desc.options.is<typed_options::integral>()) {
+            const auto& int_opt = desc.options.as<typed_options::integral>();
+            bitcount = int_opt.bitcount;
+            if (bitcount > 32) {
+               _fail(decl, "is wider than 32 bits");
+               return;
+            }
+            if (!int_opt.value_set.empty()) {
+               //
+               // The digit is the value's index within its value set.
+               //
+               proto.radix = int_opt.value_set.size();
+            } else if (int_opt.min != typed_options::integral::no_minimum && int_opt.max != typed_options::integral::no_maximum) {
+               proto.min   = int_opt.min;
+               proto.radix = (uintmax_t)(int_opt.max - int_opt.min) + 1;
+               if (proto.radix > max_group_range) {
+                  _fail(decl, "has a range wider than 32 bits");
+                  return;
+               }
+            } else {
+               if (int_opt.min != typed_options::integral::no_minimum)
+                  proto.min = int_opt.min;
+               proto.radix = uintmax_t(1) << bitcount;
+            }
+         } else {
+            _fail(decl, "is not an integer or boolean");
+            return;
+         }
+         
+         size_t count = 1;
+         for(auto e : desc.array.extents) {
+            if (e == decl_descriptor::vla_extent) {
+               _fail(decl, "is a variable-length array");
+               return;
+            }
+            count *= e;
+         }
+         unpacked += bitcount * count;
+         
+         //
+         // Each element of an array is its own digit, in the order that 
+         // the elements are laid out in memory.
+         //
+         std::vector<size_t> indices(desc.array.extents.size(), 0);
+         for(size_t i = 0; i < count; ++i) {
+            auto& item = digits.emplace_back(proto);
+            item.indices = indices;
+            for(size_t r = indices.size(); r-- > 0; ) {
+               if (++indices[r] < desc.array.extents[r])
+                  break;
+               indices[r] = 0;
+            }
+         }
+      });
+      if (failed)
+         return {};
+      
+      layout out;
+      out.unpacked_bitcount = unpacked;
+      for(auto& item : digits) {
+         if (out.groups.empty() || out.groups.back().range > max_group_range / item.radix)
+            out.groups.emplace_back();
+         auto& dst = out.groups.back();
+         dst.range *= item.radix;
+         dst.digits.push_back(std::move(item));
+      }
+      for(auto& group : out.groups) {
+         group.bitcount = std::bit_width(group.range - 1);
+         out.bitcount  += group.bitcount;
+      }
+      return out;
+   }
+   
+   static const std::vector<intmax_t>* _value_set_of(const digit& item) {
+      const auto& options = item.member->options;
+      if (!options.is<typed_options::integral>())
+         return nullptr;
+      const auto& set = options.as<typed_options::integral>().value_set;
+      if (set.empty())
+         return nullptr;
+      return &set;
+   }
+   
+   static gw::value _u32(uintmax_t v) {
+      const auto& ty = gw::builtin_types::get();
+      return gw::constant::integer(ty.uint32, (uint32_t)v);
+   }
+   
+   static gw::value _access_digit(gw::value structure, const digit& item) {
+      const auto& ty = gw::builtin_types::get();
+      
+      auto value = structure.access_member(item.member->decl.name().data());
+      for(auto i : item.indices)
+         value = value.access_array_element(gw::constant::integer(ty.basic_int, i));
+      return value;
+   }
+   
+   // The value that a save would write for a group: each digit offset by its 
+   // minimum and clamped to its radix, accumulated most significant first. 
+   // Unsigned arithmetic wraps, so offsetting by a negative minimum works.
+   static gw::value _packed_word_of(const group& group, gw::value structure, const instructions::utils::generation_context& ctxt) {
+      const auto& ty = gw::builtin_types::get();
+      
+      gw::optional_value word;
+      for(auto it = group.digits.rbegin(); it != group.digits.rend(); ++it) {
+         const auto& item = *it;
+         if (item.radix <= 1)
+            continue;
+         
+         auto value = _access_digit(structure, item);
+         if (const auto* set = _value_set_of(item)) {
+            value = value_set::index_of(*set, value, ctxt);
+         } else if (item.member->options.is<typed_options::boolean>()) {
+            value = value.convert_to_truth_value();
+         }
+         value = value.convert_to_integer(ty.uint32);
+         if (item.min != 0)
+            value = value.sub(_u32(item.min));
+         if (item.radix < max_group_range)
+            value = value.min(_u32(item.radix - 1));
+         
+         if (word) {
+            word = word->mul(_u32(item.radix)).add(value);
+         } else {
+            word = value;
+         }
+      }
+      if (!word)
+         return _u32(0);
+      return *word;
+   }
+   
+   // *checksum = func_checksum_update(*checksum, word, bitcount);
+   static gw::expr::base _update_checksum(gw::value checksum_ptr, gw::value word, size_t bitcount) {
+      const auto& ty     = gw::builtin_types::get();
+      const auto& global = basic_global_state::get().global_options;
+      assert(!!global.functions.checksum_update);
+      
+      auto checksum = checksum_ptr.dereference();
+      return gw::expr::assign(
+         checksum,
+         gw::expr::call(
+            *global.functions.checksum_update,
+            // args:
+            checksum,
+            word,
+            gw::constant::integer(ty.uint8, bitcount)
+         )
+      );
+   }
+   
+   static gw::expr::base _generate_read(const group& group, gw::value structure, const instructions::utils::generation_context& ctxt) {
+      const auto& ty     = gw::builtin_types::get();
+      const auto& global = basic_global_state::get().global_options;
+      
+      gw::expr::local_block block;
+      auto statements = block.statements();
+      
+      gw::decl::optional_variable word;
+      if (group.bitcount > 0) {
+         word = gw::decl::variable("__lu_bitpack_mixed_radix", ty.uint32);
+         word->make_artificial();
+         word->make_used();
+         word->set_initial_value(gw::expr::call(
+            *global.functions.read.u32,
+            // args:
+            *ctxt.state_ptr.read,
+            gw::constant::integer(ty.uint8, group.bitcount)
+         ));
+         statements.append(word->make_declare_expr());
+         if (ctxt.checksum_ptr.read) {
+            statements.append(_update_checksum(*ctxt.checksum_ptr.read, word->as_value(), group.bitcount));
+         }
+      }
+      
+      //
+      // Peel digits off the least significant end. The last digit with a 
+      // radix is whatever remains, so it needs no division.
+      //
+      size_t last = group.digits.size();
+      for(size_t i = 0; i < group.digits.size(); ++i)
+         if (group.digits[i].radix > 1)
+            last = i;
+      
+      for(size_t i = 0; i < group.digits.size(); ++i) {
+         const auto& item = group.digits[i];
+         
+         gw::value value = _u32(0);
+         if (item.radix > 1) {
+            assert(!!word);
+            value = word->as_value();
+            if (i != last)
+               value = value.mod(_u32(item.radix));
+         }
+         if (const auto* set = _value_set_of(item)) {
+            //
+            // The last digit is whatever remains of the word, and may be 
+            // out of range if the data is corrupt. Don't index past the 
+            // end of the table.
+            //
+            if (i == last)
+               value = value.min(_u32(item.radix - 1));
+            value = value_set::value_at(*set, value);
+         }
+         if (item.min != 0)
+            value = value.add(_u32(item.min));
+         statements.append(gw::expr::assign(_access_digit(structure, item), value));
+         
+         if (item.radix > 1 && i != last) {
+            statements.append(gw::expr::assign(
+               word->as_value(),
+               word->as_value().div(_u32(item.radix))
+            ));
+         }
+      }
+      return block;
+   }
+   
+   static gw::expr::base _generate_save(const group& group, gw::value structure, const instructions::utils::generation_context& ctxt) {
+      const auto& ty     = gw::builtin_types::get();
+      const auto& global = basic_global_state::get().global_options;
+      
+      if (group.bitcount == 0)
+         return gw::expr::base::wrap(build_empty_stmt(UNKNOWN_LOCATION));
+      
+      gw::expr::local_block block;
+      auto statements = block.statements();
+      
+      auto word = gw::decl::variable("__lu_bitpack_mixed_radix", ty.uint32);
+      word.make_artificial();
+      word.make_used();
+      word.set_initial_value(_packed_word_of(group, structure, ctxt));
+      statements.append(word.make_declare_expr());
+      if (ctxt.checksum_ptr.save) {
+         statements.append(_update_checksum(*ctxt.checksum_ptr.save, word.as_value(), group.bitcount));
+      }
+      statements.append(gw::expr::call(
+         *global.functions.save.u32,
+         // args:
+         *ctxt.state_ptr.save,
+         word.as_value(),
+         gw::constant::integer(ty.uint8, group.bitcount)
+      ));
+      return block;
+   }
+   
+   extern expr_pair generate(
+      const layout&                                  layout,
+      const optional_value_pair&                     structure,
+      const instructions::utils::generation_context& ctxt
+   ) {
+      gw::expr::local_block block_read;
+      gw::expr::local_block block_save;
+      for(const auto& group : layout.groups) {
+         block_read.statements().append(_generate_read(group, *structure.read, ctxt));
+         block_save.statements().append(_generate_save(group, *structure.save, ctxt));
+      }
+      return expr_pair(block_read, block_save);
+   }
+   
+   extern gw::expr::base generate_dirty_check(
+      const layout&                                  layout,
+      gw::value                                      structure,
+      const instructions::utils::generation_context& ctxt
+   ) {
+      const auto& ty     = gw::builtin_types::get();
+      const auto& global = basic_global_state::get().global_options;
+      
+      gw::expr::local_block block;
+      auto statements = block.statements();
+      for(const auto& group : layout.groups) {
+         if (group.bitcount == 0)
+            continue;
+         gw::value packed = gw::expr::call(
+            *global.functions.read.u32,
+            // args:
+            *ctxt.state_ptr.read,
+            gw::constant::integer(ty.uint8, group.bitcount)
+         );
+         statements.append(ctxt.make_dirty_check_return_if(
+            packed.cmp_is_not_equal(_packed_word_of(group, structure, ctxt))
+         ));
+      }
+      return block;
+   }
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "codegen/pointer_into.h"
+#include <cassert>
+#include "bitpacking/data_options/typed.h"
+#include "gcc_wrappers/constant/integer.h"
+#include "gcc_wrappers/decl/variable.h"
+#include "gcc_wrappers/type/array.h"
+#include "gcc_wrappers/type/integral.h"
+#include "gcc_wrappers/builtin_types.h"
+#include <fold-const.h> // fold_build3
+namespace gw {
+   using namespace gcc_wrappers;
+}
+namespace typed_options {
+   using namespace bitpacking::typed_data_options::computed;
+}
+
+namespace codegen::pointer_into {
+   // `gw::constant::integer` can only be built from an `int`, which can't 
+   // hold every array length.
+   static gw::value _int(gw::type::integral type, uintmax_t v) {
+      return gw::constant::integer::wrap(build_int_cst(type.unwrap(), (HOST_WIDE_INT)v));
+   }
+   
+   // `condition ? a : b`, where the operands are values rather than 
+   // statements.
+   static gw::value _select(gw::type::base type, gw::value condition, gw::value a, gw::value b) {
+      return gw::value::wrap(fold_build3(
+         COND_EXPR,
+         type.unwrap(),
+         condition.unwrap(),
+         a.unwrap(),
+         b.unwrap()
+      ));
+   }
+   
+   extern gw::value packed_bits_of(const typed_options::pointer& options, gw::value value) {
+      assert(!!options.into);
+      const auto& ty = gw::builtin_types::get();
+      
+      gw::decl::variable into = *options.into;
+      
+      auto array   = into.as_value();
+      auto element = array.value_type().as_array().value_type();
+      auto address = ty.smallest_integral_for(value.value_type().size_in_bits(), false);
+      
+      //
+      // Do the math on addresses as unsigned integers. A null pointer, or 
+      // any pointer before the start of the array, then wraps around to an 
+      // offset past its end: the array can't extend past the end of the 
+      // address space, so its length is less than that offset.
+      //
+      auto offset = value.conversion_sans_bytecode(address)
+         .sub(array.convert_array_to_pointer().conversion_sans_bytecode(address))
+         .div(_int(address, element.size_in_bytes()));
+      offset = gw::value::wrap(save_expr(offset.unwrap()));
+      
+      return _select(
+         ty.uint32,
+         offset.cmp_is_less(_int(address, options.element_count)),
+         offset.add(_int(address, 1)).convert_to_integer(ty.uint32),
+         _int(ty.uint32, 0)
+      );
+   }
+   
+   extern gw::value unpacked_value_of(const typed_options::pointer& options, gw::value bits, gw::type::base pointer_type) {
+      assert(!!options.into);
+      const auto& ty = gw::builtin_types::get();
+      
+      //
+      // Zero (a null pointer) wraps around to an index past the end of the 
+      // array, so one comparison catches it along with any corrupt index.
+      //
+      auto index = bits.convert_to_integer(ty.uint32).sub(_int(ty.uint32, 1));
+      index = gw::value::wrap(save_expr(index.unwrap()));
+      
+      gw::decl::variable into = *options.into;
+      
+      auto element = into.as_value()
+         .access_array_element(index)
+         .address_of()
+         .conversion_sans_bytecode(pointer_type);
+      
+      return _select(
+         pointer_type,
+         index.cmp_is_less(_int(ty.uint32, options.element_count)),
+         element,
+         gw::value::wrap(build_int_cst(pointer_type.unwrap(), 0))
+      );
+   }
+}
\ No newline at end of file
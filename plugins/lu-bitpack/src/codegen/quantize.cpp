@@ -0,0 +1,101 @@
+#include "codegen/quantize.h"
+#include <cassert>
+#include "lu/stringf.h"
+#include "bitpacking/data_options/typed.h"
+#include "gcc_wrappers/constant/floating_point.h"
+#include "gcc_wrappers/constant/integer.h"
+#include "gcc_wrappers/type/floating_point.h"
+#include "gcc_wrappers/type/integral.h"
+#include "gcc_wrappers/builtin_types.h"
+namespace gw {
+   using namespace gcc_wrappers;
+}
+namespace typed_options {
+   using namespace bitpacking::typed_data_options::computed;
+}
+
+namespace codegen::quantize {
+   static uintmax_t _steps(const typed_options::quantized& options) {
+      return (uintmax_t(1) << options.bitcount) - 1;
+   }
+   
+   // Hexadecimal float literals are exact, so the constant is the host value 
+   // rounded to the type's precision, and no less precise than that.
+   static gw::value _real(gw::type::floating_point type, long double v) {
+      auto str = lu::stringf("%La", v);
+      return gw::constant::floating_point::from_string(type, str);
+   }
+   
+   // `gw::constant::integer` can only be built from an `int`, which would 
+   // truncate 64-bit bounds.
+   static gw::value _int(gw::type::integral type, uintmax_t v) {
+      return gw::constant::integer::wrap(build_int_cst(type.unwrap(), (HOST_WIDE_INT)v));
+   }
+   
+   // Do integer math in unsigned types, so that offsetting by a negative 
+   // minimum wraps rather than overflowing.
+   static gw::type::integral _work_type_for(gw::type::base type) {
+      const auto& ty = gw::builtin_types::get();
+      if (type.size_in_bits() > 32)
+         return ty.uint64;
+      return ty.uint32;
+   }
+   
+   extern gw::value packed_bits_of(const typed_options::quantized& options, gw::value value) {
+      const auto& ty = gw::builtin_types::get();
+      
+      auto type = value.value_type().with_all_qualifiers_stripped();
+      if (!options.is_integral) {
+         auto ft    = type.as_floating_point();
+         auto steps = _steps(options);
+         //
+         // Adding one half before truncating rounds to the nearest step. We 
+         // clamp before converting to an integer, since converting a value 
+         // that the integer can't hold is undefined.
+         //
+         value = value
+            .sub(_real(ft, options.min))
+            .mul(_real(ft, (long double)steps / (options.max - options.min)))
+            .add(_real(ft, 0.5L));
+         value = value.max(_real(ft, 0)).min(_real(ft, (long double)steps));
+         return value.convert_to_integer(ty.uint32);
+      }
+      
+      auto work   = _work_type_for(type);
+      auto min    = (intmax_t)options.min;
+      auto max    = (intmax_t)options.max;
+      auto bucket = (uintmax_t)options.step();
+      
+      //
+      // Clamp to the range before bucketing: the last bucket may extend past 
+      // the maximum, and we don't want values to read back above it.
+      //
+      value = value.max(_int(type.as_integral(), min)).min(_int(type.as_integral(), max));
+      value = value.convert_to_integer(work).sub(_int(work, min));
+      if (bucket > 1)
+         value = value.div(_int(work, bucket));
+      return value.convert_to_integer(ty.uint32);
+   }
+   
+   extern gw::value unpacked_value_of(const typed_options::quantized& options, gw::value bits, gw::type::base value_type) {
+      auto type = value_type.with_all_qualifiers_stripped();
+      if (!options.is_integral) {
+         auto ft = type.as_floating_point();
+         return bits
+            .convert_to_floating_point(ft)
+            .mul(_real(ft, options.step()))
+            .add(_real(ft, options.min));
+      }
+      
+      auto work   = _work_type_for(type);
+      auto min    = (intmax_t)options.min;
+      auto bucket = (uintmax_t)options.step();
+      
+      bits = bits.convert_to_integer(work);
+      if (bucket > 1)
+         bits = bits.mul(_int(work, bucket));
+      if (min != 0)
+         bits = bits.add(_int(work, min));
+      return bits.convert_to_integer(type.as_integral());
+   }
+}
\ No newline at end of file
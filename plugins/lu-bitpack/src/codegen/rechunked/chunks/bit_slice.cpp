@@ -0,0 +1,11 @@
+#include "codegen/rechunked/chunks/bit_slice.h"
+
+namespace codegen::rechunked::chunks {
+   /*virtual*/ bool bit_slice::compare(const base& other) const noexcept /*override*/ {
+      const auto* casted = other.as<bit_slice>();
+      if (!casted)
+         return false;
+      
+      return this->data == casted->data;
+   }
+}
\ No newline at end of file
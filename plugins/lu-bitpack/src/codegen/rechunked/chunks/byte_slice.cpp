@@ -0,0 +1,11 @@
+#include "codegen/rechunked/chunks/byte_slice.h"
+
+namespace codegen::rechunked::chunks {
+   /*virtual*/ bool byte_slice::compare(const base& other) const noexcept /*override*/ {
+      const auto* casted = other.as<byte_slice>();
+      if (!casted)
+         return false;
+      
+      return this->data == casted->data;
+   }
+}
\ No newline at end of file
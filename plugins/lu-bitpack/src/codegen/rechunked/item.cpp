@@ -1,6 +1,8 @@
 #include <memory> // GCC headers fuck up string-related STL identifiers that <memory> depends on
 #include "codegen/rechunked/item.h"
 #include "codegen/rechunked/chunks/array_slice.h"
+#include "codegen/rechunked/chunks/bit_slice.h"
+#include "codegen/rechunked/chunks/byte_slice.h"
 #include "codegen/rechunked/chunks/condition.h"
 #include "codegen/rechunked/chunks/padding.h"
 #include "codegen/rechunked/chunks/qualified_decl.h"
@@ -84,6 +86,16 @@ namespace codegen::rechunked {
             this->chunks.push_back(std::move(chunk_ptr));
          }
       }
+      if (src.bit_slice.has_value()) {
+         auto chunk_ptr = std::make_unique<chunks::bit_slice>();
+         chunk_ptr->data = *src.bit_slice;
+         this->chunks.push_back(std::move(chunk_ptr));
+      }
+      if (src.byte_slice.has_value()) {
+         auto chunk_ptr = std::make_unique<chunks::byte_slice>();
+         chunk_ptr->data = *src.byte_slice;
+         this->chunks.push_back(std::move(chunk_ptr));
+      }
    }
    
    bool item::is_omitted_and_defaulted() const {
@@ -5,6 +5,8 @@
 #include "codegen/decl_descriptor.h"
 #include "codegen/rechunked/chunks/base.h"
 #include "codegen/rechunked/chunks/array_slice.h"
+#include "codegen/rechunked/chunks/bit_slice.h"
+#include "codegen/rechunked/chunks/byte_slice.h"
 #include "codegen/rechunked/chunks/condition.h"
 #include "codegen/rechunked/chunks/qualified_decl.h"
 #include "codegen/rechunked/chunks/padding.h"
@@ -88,6 +90,16 @@ namespace codegen::rechunked {
             dst += lu::stringf("{pad:%u}", (int)casted->bitcount);
             continue;
          }
+         if (auto* casted = chunk_ptr->as<chunks::bit_slice>()) {
+            auto end = casted->data.start + casted->data.count;
+            dst += lu::stringf("{bits:%u:%u}", (int)casted->data.start, (int)end);
+            continue;
+         }
+         if (auto* casted = chunk_ptr->as<chunks::byte_slice>()) {
+            auto end = casted->data.start + casted->data.count;
+            dst += lu::stringf("{bytes:%u:%u}", (int)casted->data.start, (int)end);
+            continue;
+         }
          if (auto* casted = chunk_ptr->as<chunks::condition>()) {
             dst += '(';
             for(auto& chunk_ptr : casted->lhs.chunks) {
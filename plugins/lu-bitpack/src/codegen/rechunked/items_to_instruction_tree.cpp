@@ -8,6 +8,8 @@
 #include "codegen/instructions/union_switch.h"
 #include "codegen/instructions/union_case.h"
 #include "codegen/rechunked/chunks/array_slice.h"
+#include "codegen/rechunked/chunks/bit_slice.h"
+#include "codegen/rechunked/chunks/byte_slice.h"
 #include "codegen/rechunked/chunks/base.h"
 #include "codegen/rechunked/chunks/condition.h"
 #include "codegen/rechunked/chunks/padding.h"
@@ -376,6 +378,38 @@ namespace codegen::rechunked {
                }
                continue;
             }
+            if (auto* casted = chunk->as<rechunked::chunks::bit_slice>()) {
+               //
+               // A scalar split across sectors. The chunks before this one 
+               // led us to the value, but didn't create a leaf node for it, 
+               // since they weren't the last chunk.
+               //
+               assert(is_last_chunk);
+               auto node = std::make_unique<instructions::single>();
+               node->value     = value;
+               node->bit_slice = casted->data;
+               parent->as<instructions::container>()->instructions.push_back(std::move(node));
+               stack.push_back(stack_entry{
+                  .chunk = chunk,
+                  .node  = nullptr,
+               });
+               continue;
+            }
+            if (auto* casted = chunk->as<rechunked::chunks::byte_slice>()) {
+               //
+               // A buffer or string split across sectors. As above.
+               //
+               assert(is_last_chunk);
+               auto node = std::make_unique<instructions::single>();
+               node->value      = value;
+               node->byte_slice = casted->data;
+               parent->as<instructions::container>()->instructions.push_back(std::move(node));
+               stack.push_back(stack_entry{
+                  .chunk = chunk,
+                  .node  = nullptr,
+               });
+               continue;
+            }
             if (auto* casted = chunk->as<rechunked::chunks::padding>()) {
                assert(is_last_chunk);
                auto node = std::make_unique<instructions::padding>();
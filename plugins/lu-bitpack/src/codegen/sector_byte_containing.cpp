@@ -0,0 +1,26 @@
+#include "codegen/sector_byte_containing.h"
+#include "gcc_wrappers/constant/integer.h"
+#include "gcc_wrappers/type/array.h"
+#include "gcc_wrappers/builtin_types.h"
+#include "basic_global_state.h"
+namespace gw {
+   using namespace gcc_wrappers;
+}
+
+namespace codegen {
+   extern gw::value sector_byte_containing(gw::value sector, size_t bit_offset) {
+      const auto& gs = basic_global_state::get();
+      const auto& ty = gw::builtin_types::get();
+      
+      size_t byte_offset = bit_offset / 8;
+      if (byte_offset > 0) {
+         auto array_type = ty.uint8.add_const().add_array_extent(byte_offset + 1);
+         sector = sector
+            .conversion_sans_bytecode(array_type.add_pointer())
+            .dereference()
+            .access_array_element(gw::constant::integer(ty.basic_int, byte_offset))
+            .address_of();
+      }
+      return sector.conversion_sans_bytecode(*gs.global_options.types.buffer_byte_ptr);
+   }
+}
\ No newline at end of file
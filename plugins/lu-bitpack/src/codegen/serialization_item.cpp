@@ -5,6 +5,7 @@
 #include "lu/stringf.h"
 #include "gcc_wrappers/constant/string.h"
 #include "codegen/decl_descriptor.h"
+#include "codegen/mixed_radix.h"
 namespace gw {
    using namespace gcc_wrappers;
 }
@@ -33,6 +34,10 @@ namespace codegen {
    }
    
    size_t serialization_item::size_in_bits() const {
+      if (this->bit_slice.has_value())
+         return this->bit_slice->count;
+      if (this->byte_slice.has_value())
+         return this->byte_slice->count * 8;
       if (this->segments.empty())
          return 0;
       auto& segm = this->segments.back();
@@ -45,6 +50,10 @@ namespace codegen {
       return 0;
    }
    size_t serialization_item::single_size_in_bits() const {
+      if (this->bit_slice.has_value())
+         return this->bit_slice->count;
+      if (this->byte_slice.has_value())
+         return this->byte_slice->count * 8;
       if (this->segments.empty())
          return 0;
       auto& segm = this->segments.back();
@@ -82,6 +91,8 @@ namespace codegen {
    }
    
    bool serialization_item::can_expand() const {
+      if (this->bit_slice.has_value() || this->byte_slice.has_value())
+         return false;
       if (this->segments.empty())
          return false;
       auto& back = this->segments.back();
@@ -116,8 +127,8 @@ namespace codegen {
       
       if (desc.options.is<typed_options::buffer>()) {
          //
-         // TODO: If we want to allow splitting buffers, we'll need a special syntax 
-         // for that akin to `array_accesses`.
+         // Buffers can't be broken down into smaller values, but they can be 
+         // divided between sectors by byte ranges (see `split_bytes`).
          //
          return false;
       }
@@ -126,6 +137,13 @@ namespace codegen {
          if (casted.never_split_across_sectors)
             return false;
       }
+      if (mixed_radix::is_mixed_radix(desc)) {
+         //
+         // The struct's members are digits of combined integers, so none of 
+         // them can be serialized on its own.
+         //
+         return false;
+      }
       
       // Is struct or union?
       auto type = *desc.types.serialized;
@@ -139,9 +157,80 @@ namespace codegen {
       }
       
       //
-      // TODO: If we allow splitting strings, we'll need more logic here.
+      // Strings, like buffers, can only be divided by byte ranges.
+      //
+      
+      return false;
+   }
+   
+   bool serialization_item::can_split_bits() const {
+      if (this->is_omitted)
+         return false;
+      if (this->segments.empty())
+         return false;
+      auto& back = this->segments.back();
+      if (back.is_padding())
+         return false;
+      assert(back.is_basic());
+      for(auto& segm : this->segments) {
+         if (segm.condition.has_value())
+            return false;
+      }
+      
+      auto& segm = back.as_basic();
+      auto& desc = *segm.desc;
+      if (segm.is_array())
+         return false;
+      if (!desc.types.transformations.empty())
+         return false;
+      //
+      // We need to be able to recover the bits saved so far from the value 
+      // as it stands, and to rebuild the value from any combination of bits, 
+      // so for now, we only split plain integers. Value sets and other packed 
+      // representations are moved to the next sector whole.
       //
+      if (!desc.options.is<typed_options::integral>())
+         return false;
+      if (!desc.options.as<typed_options::integral>().value_set.empty())
+         return false;
+      
+      return this->size_in_bits() > 1;
+   }
+   
+   bool serialization_item::can_split_bytes() const {
+      if (this->is_omitted)
+         return false;
+      if (this->segments.empty())
+         return false;
+      auto& back = this->segments.back();
+      if (back.is_padding())
+         return false;
+      assert(back.is_basic());
+      for(auto& segm : this->segments) {
+         if (segm.condition.has_value())
+            return false;
+      }
+      
+      auto& segm = back.as_basic();
+      auto& desc = *segm.desc;
+      if (segm.is_array())
+         return false;
+      if (!desc.types.transformations.empty())
+         return false;
       
+      if (desc.options.is<typed_options::buffer>())
+         return this->size_in_bits() > 8;
+      if (desc.options.is<typed_options::string>()) {
+         //
+         // A string that requires a terminator is read as a whole, so that 
+         // everything after the terminator can be cleared; and a string with 
+         // a reduced charset isn't serialized as bytes.
+         //
+         const auto& options = desc.options.as<typed_options::string>();
+         if (!options.nonstring || options.uses_charset())
+            return false;
+         return this->size_in_bits() > 8;
+      }
       return false;
    }
    
@@ -463,8 +552,8 @@ namespace codegen {
       
       if (desc.options.is<typed_options::buffer>()) {
          //
-         // TODO: If we want to allow splitting buffers, we'll need to handle 
-         // that here.
+         // Buffers can't be broken down into smaller values. They can only be 
+         // divided into byte ranges; see `split_bytes`.
          //
          return out;
       }
@@ -485,6 +574,52 @@ namespace codegen {
       return out;
    }
    
+   std::pair<serialization_item, serialization_item> serialization_item::split_bits(size_t bitcount) const {
+      assert(this->can_split_bits());
+      
+      bit_slice_info whole;
+      if (this->bit_slice.has_value()) {
+         whole = *this->bit_slice;
+      } else {
+         whole.count = this->size_in_bits();
+      }
+      assert(bitcount > 0 && bitcount < whole.count);
+      
+      std::pair<serialization_item, serialization_item> out = { *this, *this };
+      out.first.bit_slice = bit_slice_info{
+         .start = whole.start,
+         .count = bitcount,
+      };
+      out.second.bit_slice = bit_slice_info{
+         .start = whole.start + bitcount,
+         .count = whole.count - bitcount,
+      };
+      return out;
+   }
+   
+   std::pair<serialization_item, serialization_item> serialization_item::split_bytes(size_t bytecount) const {
+      assert(this->can_split_bytes());
+      
+      array_access_info whole;
+      if (this->byte_slice.has_value()) {
+         whole = *this->byte_slice;
+      } else {
+         whole.count = this->size_in_bits() / 8;
+      }
+      assert(bytecount > 0 && bytecount < whole.count);
+      
+      std::pair<serialization_item, serialization_item> out = { *this, *this };
+      out.first.byte_slice = array_access_info{
+         .start = whole.start,
+         .count = bytecount,
+      };
+      out.second.byte_slice = array_access_info{
+         .start = whole.start + bytecount,
+         .count = whole.count - bytecount,
+      };
+      return out;
+   }
+   
    bool serialization_item::is_opaque_buffer() const {
       if (this->segments.empty())
          return false;
@@ -641,6 +776,16 @@ namespace codegen {
             }
          }
       }
+      if (this->bit_slice.has_value()) {
+         auto start = this->bit_slice->start;
+         auto end   = start + this->bit_slice->count;
+         out += lu::stringf(" bits(%u:%u)", (int)start, (int)end);
+      }
+      if (this->byte_slice.has_value()) {
+         auto start = this->byte_slice->start;
+         auto end   = start + this->byte_slice->count;
+         out += lu::stringf(" bytes(%u:%u)", (int)start, (int)end);
+      }
       
       return out;
    }
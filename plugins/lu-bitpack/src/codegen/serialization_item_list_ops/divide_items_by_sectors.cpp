@@ -1,5 +1,5 @@
 #include "codegen/serialization_item_list_ops/divide_items_by_sectors.h"
-#include <algorithm> // std::copy, std::min
+#include <algorithm> // std::copy, std::max, std::min
 #include <cassert>
 #include "codegen/decl_descriptor.h"
 
@@ -14,15 +14,31 @@ namespace {
    using segment_condition = codegen::serialization_items::condition_type;
 
    struct overall_state {
-      size_t      bits_per_sector = 0;
-      sector_list sectors;
+      std::vector<size_t> bits_per_sector; // the last size applies to all further sectors
+      sector_list         sectors;
+      
+      size_t bits_in(size_t sector) const {
+         assert(!this->bits_per_sector.empty());
+         if (sector < this->bits_per_sector.size())
+            return this->bits_per_sector[sector];
+         return this->bits_per_sector.back();
+      }
+      
+      // The size of the largest sector after the given one.
+      size_t most_bits_after(size_t sector) const {
+         assert(!this->bits_per_sector.empty());
+         size_t most = this->bits_per_sector.back();
+         for(size_t i = sector + 1; i < this->bits_per_sector.size(); ++i)
+            most = (std::max)(most, this->bits_per_sector[i]);
+         return most;
+      }
    };
 
    //
-   // Leftover from when we tried to implement sector splitting of unions. 
-   // Retained in case we think of a workable solution in the future. (See 
-   // Markdown-format documentation for problems.) Same basic design as 
-   // with `serialization_item_list_ops::get_offsets_and_sizes`.
+   // Tracks where we are as we place items into sectors. Each branch of a 
+   // union that's split across sectors is placed with its own state, starting 
+   // from where the union starts. Same basic design as with 
+   // `serialization_item_list_ops::get_offsets_and_sizes`.
    //
    struct branch_state {
       overall_state*    overall;
@@ -31,7 +47,7 @@ namespace {
       size_t current_sector = 0;
       
       branch_state() {} // needed for std::vector
-      branch_state(overall_state& o) : overall(&o), bits_remaining(o.bits_per_sector) {}
+      branch_state(overall_state& o) : overall(&o), bits_remaining(o.bits_in(0)) {}
       
       void insert(const codegen::serialization_item& item) {
          if (overall->sectors.size() <= this->current_sector)
@@ -43,7 +59,7 @@ namespace {
       }
       void next() {
          ++this->current_sector;
-         this->bits_remaining = overall->bits_per_sector;
+         this->bits_remaining = overall->bits_in(this->current_sector);
       }
       
       constexpr bool is_at_or_ahead_of(const branch_state& o) const noexcept {
@@ -63,34 +79,25 @@ namespace {
 }
 
 namespace codegen::serialization_item_list_ops {
-   extern std::vector<std::vector<serialization_item>> divide_items_by_sectors(
-      size_t sector_size_in_bits,
-      std::vector<serialization_item> src
-   ) {
-      overall_state overall;
-      overall.bits_per_sector = sector_size_in_bits;
-      assert(sector_size_in_bits > 0);
-      
-      branch_state root{overall};
-      std::vector<branch_state> branches;
+   static void _place_union(branch_state& state, const serialization_item& item, const division_options& options);
       
+   // Places items into sectors, starting from the given state, and leaves the 
+   // state just past the last item placed.
+   static void _place_items(branch_state& state, std::vector<serialization_item> src, const division_options& options) {
       size_t size = src.size();
       for(size_t i = 0; i < size; ++i) {
          const auto& item = src[i];
          assert(!item.segments.empty());
          
          //
-         // Union expansion and conditions are not supported w.r.t. sector 
-         // splitting. Unions must be expanded only as a post-process step, 
-         // not in advance. By extension, padding also cannot be split.
+         // Unions are expanded only as a post-process step, not in advance, 
+         // unless we're splitting them across sectors (see `_place_union`), 
+         // in which case we pad their branches ourselves. Either way, padding 
+         // never reaches this point.
          //
          assert(!item.is_padding());
-         for(auto& segment : item.segments) {
-            assert(!segment.condition.has_value());
-         }
          
-         auto& current_branch = branches.empty() ? root : branches.back();
-         const size_t remaining = current_branch.bits_remaining;
+         const size_t remaining = state.bits_remaining;
          
          if (item.is_omitted) {
             //
@@ -103,7 +110,7 @@ namespace codegen::serialization_item_list_ops {
             //
             if (!item.affects_output_in_any_way())
                continue;
-            current_branch.insert(item);
+            state.insert(item);
             continue;
          }
          
@@ -112,7 +119,7 @@ namespace codegen::serialization_item_list_ops {
             //
             // If the entire item can fit, then insert it unmodified.
             //
-            current_branch.insert(item);
+            state.insert(item);
             continue;
          }
          //
@@ -124,9 +131,13 @@ namespace codegen::serialization_item_list_ops {
             // the next sector (after we verify that it'll even fit there).
             //
             // NOTE: Splitting unions across sector boundaries involves some 
-            // very, very complicated logistics, so we refuse to do it.
+            // complicated logistics, so we only do it when asked to.
             //
-            if (item.can_expand() && !item.is_union()) {
+            if (options.split_unions && item.is_union() && item.can_expand() && !item.segments.back().as_basic().is_array()) {
+               _place_union(state, item, options);
+               continue;
+            }
+            if (item.can_expand() && (!item.is_union() || options.split_unions)) {
                auto   expanded       = item.expanded();
                size_t expanded_count = expanded.size();
                expanded.resize(size - i - 1 + expanded_count);
@@ -140,18 +151,170 @@ namespace codegen::serialization_item_list_ops {
                i    = -1;
                continue;
             }
+            if (options.split_scalars && item.can_split_bits()) {
+               //
+               // Fill the rest of this sector with the value's low bits, and 
+               // carry its high bits over into the next sector.
+               //
+               auto halves = item.split_bits(remaining);
+               state.insert(halves.first);
+               state.next();
+               src[i] = std::move(halves.second);
+               --i; // process the high bits as their own item
+               continue;
+            }
+            if (options.split_buffers && remaining >= 8 && item.can_split_bytes()) {
+               //
+               // Fill the rest of this sector with as many of the value's bytes 
+               // as will fit, and carry the rest over into the next sector.
+               //
+               auto halves = item.split_bytes(remaining / 8);
+               state.insert(halves.first);
+               state.next();
+               src[i] = std::move(halves.second);
+               --i; // process the remaining bytes as their own item
+               continue;
+            }
             //
-            // Cannot expand the item.
+            // Cannot expand or split the item here. (A buffer or union may still 
+            // be split once we move to the next sector, even if it's larger than 
+            // that sector. Otherwise, it has to fit in some later sector, though 
+            // not necessarily the next one, as sectors may differ in size.)
             //
-            if (bitcount > sector_size_in_bits) {
+            bool splits_later = (options.split_buffers && item.can_split_bytes()) || (options.split_unions && item.is_union());
+            if (bitcount > state.overall->most_bits_after(state.current_sector) && !splits_later) {
                throw std::runtime_error(std::string("found an element that is too large to fit in any sector: ") + item.to_string());
             }
          }
          
-         current_branch.next();
+         state.next();
          --i; // re-process current item
          continue;
       }
+   }
+   
+   //
+   // Places a tagged union that straddles a sector boundary. Each of the 
+   // union's branches is placed on its own, starting from where the union 
+   // starts, and so may be expanded or pushed to the next sector at its own 
+   // points. We then pad the branches so that, within each sector, they're 
+   // all the same length as the longest of them. This ensures that every 
+   // branch is present in every sector that the union spans (so that the 
+   // generated code never mistakes a tag value for the "else" branch), and 
+   // that whatever follows the union is at the same position regardless of 
+   // which branch was taken.
+   //
+   static void _place_union(branch_state& state, const serialization_item& item, const division_options& options) {
+      const size_t depth = item.segments.size();
+      
+      //
+      // An internally tagged union's header (i.e. the members that all of its 
+      // members share, up to and including the tag) is unconditional, and 
+      // comes before any of the branches.
+      //
+      struct branch {
+         segment_condition               condition;
+         std::vector<serialization_item> items;
+      };
+      std::vector<serialization_item> header;
+      std::vector<branch>             branches;
+      for(auto& sub : item.expanded()) {
+         assert(sub.segments.size() > depth);
+         const auto& cnd = sub.segments[depth].condition;
+         if (!cnd.has_value()) {
+            assert(branches.empty());
+            header.push_back(sub);
+            continue;
+         }
+         if (branches.empty() || branches.back().condition != *cnd)
+            branches.emplace_back().condition = *cnd;
+         if (sub.is_padding())
+            continue; // We'll pad the branches ourselves.
+         branches.back().items.push_back(sub);
+      }
+      _place_items(state, std::move(header), options);
+      
+      const size_t first_sector = state.current_sector;
+      
+      std::vector<overall_state> placed(branches.size());
+      branch_state furthest = state;
+      for(size_t i = 0; i < branches.size(); ++i) {
+         placed[i].bits_per_sector = state.overall->bits_per_sector;
+         
+         branch_state cursor{placed[i]};
+         cursor.condition = branches[i].condition;
+         cursor.catch_up_to(state);
+         _place_items(cursor, std::move(branches[i].items), options);
+         
+         if (cursor.is_at_or_ahead_of(furthest))
+            furthest.catch_up_to(cursor);
+      }
+      
+      //
+      // Measure how many bits each branch uses in each sector.
+      //
+      const size_t sector_count = furthest.current_sector - first_sector + 1;
+      
+      std::vector<std::vector<size_t>> used(branches.size(), std::vector<size_t>(sector_count, 0));
+      std::vector<size_t>              most_used(sector_count, 0);
+      for(size_t i = 0; i < branches.size(); ++i) {
+         auto& sectors = placed[i].sectors;
+         for(size_t j = 0; j < sector_count; ++j) {
+            size_t s = first_sector + j;
+            if (s >= sectors.size())
+               break;
+            for(const auto& sub : sectors[s])
+               if (!sub.is_omitted)
+                  used[i][j] += sub.size_in_bits();
+            most_used[j] = (std::max)(most_used[j], used[i][j]);
+         }
+      }
+      
+      //
+      // Copy each branch's items into the sectors, padding them as we go.
+      //
+      auto& sectors = state.overall->sectors;
+      if (sectors.size() < first_sector + sector_count)
+         sectors.resize(first_sector + sector_count);
+      for(size_t j = 0; j < sector_count; ++j) {
+         size_t s = first_sector + j;
+         for(size_t i = 0; i < branches.size(); ++i) {
+            if (s < placed[i].sectors.size()) {
+               auto& src = placed[i].sectors[s];
+               sectors[s].insert(sectors[s].end(), src.begin(), src.end());
+            }
+            if (used[i][j] < most_used[j]) {
+               serialization_item padding = item;
+               padding.is_defaulted = false;
+               padding.is_omitted   = false;
+               {
+                  auto& segm = padding.segments.emplace_back();
+                  auto& data = segm.data.emplace<serialization_items::padding_segment>();
+                  data.bitcount  = most_used[j] - used[i][j];
+                  segm.condition = branches[i].condition;
+               }
+               sectors[s].push_back(std::move(padding));
+            }
+         }
+      }
+      
+      state.catch_up_to(furthest);
+   }
+   
+   extern std::vector<std::vector<serialization_item>> divide_items_by_sectors(
+      std::vector<size_t> sector_sizes_in_bits,
+      std::vector<serialization_item> src,
+      const division_options& options
+   ) {
+      assert(!sector_sizes_in_bits.empty());
+      for(auto size : sector_sizes_in_bits)
+         assert(size > 0);
+      
+      overall_state overall;
+      overall.bits_per_sector = std::move(sector_sizes_in_bits);
+      
+      branch_state root{overall};
+      _place_items(root, std::move(src), options);
       
       //
       // POST-PROCESS: CONSECUTIVE ARRAY ELEMENTS TO ARRAY SLICES
@@ -168,8 +331,8 @@ namespace codegen::serialization_item_list_ops {
       //
       // POST-PROCESS: FORCE-EXPAND UNIONS, ANONYMOUS STRUCTS, AND ARRAYS THEREOF
       //
-      // We can't split unions, but we want them expanded after splitting is 
-      // done.
+      // Unions that weren't split across sectors are expanded only after 
+      // splitting is done.
       //
       for(auto& sector : overall.sectors) {
          serialization_item_list_ops::force_expand_unions_and_anonymous(sector);
@@ -21,6 +21,10 @@ namespace codegen::serialization_item_list_ops {
             continue;
          if (item.is_defaulted != prev.is_defaulted)
             continue;
+         if (item.bit_slice.has_value() || prev.bit_slice.has_value())
+            continue;
+         if (item.byte_slice.has_value() || prev.byte_slice.has_value())
+            continue;
          
          //
          // Check if all but the last path segment are identical.
@@ -0,0 +1,760 @@
+#include "codegen/table_codec.h"
+#include <cassert>
+#include <unordered_map>
+#include "lu/stringf.h"
+#include "bitpacking/global_options.h"
+#include "basic_global_state.h"
+#include "codegen/instructions/utils/generation_context.h"
+#include "codegen/instructions/array_slice.h"
+#include "codegen/instructions/single.h"
+#include "codegen/instructions/union_switch.h"
+#include "codegen/instructions/union_case.h"
+#include "codegen/decl_descriptor.h"
+#include "codegen/decl_dictionary.h"
+#include "codegen/mixed_radix.h"
+#include "codegen/value_path.h"
+#include "codegen/whole_struct_function_dictionary.h"
+#include "gcc_wrappers/constant/integer.h"
+#include "gcc_wrappers/decl/field.h"
+#include "gcc_wrappers/decl/function.h"
+#include "gcc_wrappers/decl/label.h"
+#include "gcc_wrappers/decl/param.h"
+#include "gcc_wrappers/decl/result.h"
+#include "gcc_wrappers/decl/variable.h"
+#include "gcc_wrappers/expr/assign.h"
+#include "gcc_wrappers/expr/call.h"
+#include "gcc_wrappers/expr/declare_label.h"
+#include "gcc_wrappers/expr/go_to_label.h"
+#include "gcc_wrappers/expr/local_block.h"
+#include "gcc_wrappers/expr/ternary.h"
+#include "gcc_wrappers/flow/simple_if_else_set.h"
+#include "gcc_wrappers/type/array.h"
+#include "gcc_wrappers/type/function.h"
+#include "gcc_wrappers/type/pointer.h"
+#include "gcc_wrappers/type/record.h"
+#include "gcc_wrappers/builtin_types.h"
+#include "gcc_wrappers/constructor.h"
+#include "gcc_wrappers/statement_list.h"
+#include "gcc_wrappers/value.h"
+#include <fold-const.h> // fold_build_pointer_plus, fold_build_pointer_plus_hwi
+namespace gw {
+   using namespace gcc_wrappers;
+}
+namespace typed_options {
+   using namespace bitpacking::typed_data_options::computed;
+}
+
+namespace codegen::table_codec {
+   constexpr const uint32_t word_bitcount_mask = 0x3F;
+   constexpr const size_t   word_kind_shift    = 6;
+   constexpr const uint32_t word_kind_mask     = 0x7;
+   constexpr const uint32_t word_has_min_bit   = 1 << 9;
+   constexpr const size_t   word_count_shift   = 10;
+   constexpr const size_t   max_op_count       = (1 << (32 - word_count_shift)) - 1;
+   
+   static bool _kind_has_length(op_kind kind) {
+      switch (kind) {
+         case op_kind::string_nt:
+         case op_kind::string_ut:
+         case op_kind::buffer:
+            return true;
+         default:
+            break;
+      }
+      return false;
+   }
+   
+   //
+   // Compiling node trees into operations.
+   //
+   
+   struct _stand_in {
+      gw::decl::variable root;
+      size_t             offset = 0;
+      gw::type::base     type;
+   };
+   
+   struct _compile_state {
+      const instructions::utils::generation_context& ctxt;
+      std::vector<op> ops;
+      
+      // The element that each array slice's loop counter is on, as we 
+      // unroll the loop.
+      std::unordered_map<const decl_descriptor*, size_t> loop_indices;
+      
+      // When we expand a whole-struct function's node tree in place, the 
+      // root of that tree (the function's dereferenced struct pointer) 
+      // stands in for the struct value that we're expanding.
+      std::unordered_map<const decl_descriptor*, _stand_in> stand_ins;
+   };
+   
+   // Finds the address of the value that a path refers to, as an offset from 
+   // a variable with static storage, along with the value's type. Returns 
+   // false if the value isn't at a fixed address.
+   static bool _locate(
+      const _compile_state&        state,
+      const value_path&            path,
+      gw::decl::optional_variable& root,
+      size_t&                      offset,
+      gw::type::optional_base&     type
+   ) {
+      for(size_t i = 0; i < path.segments.size(); ++i) {
+         const auto& segm = path.segments[i];
+         if (i == 0) {
+            const auto* desc = segm.member_descriptor().read;
+            assert(desc != nullptr);
+            if (auto it = state.stand_ins.find(desc); it != state.stand_ins.end()) {
+               root   = it->second.root;
+               offset = it->second.offset;
+               type   = it->second.type;
+               continue;
+            }
+            if (desc->variable.dereference_count > 0)
+               return false;
+            if (!desc->decl.is<gw::decl::variable>())
+               return false;
+            auto decl = desc->decl.as<gw::decl::variable>();
+            if (!TREE_STATIC(decl.unwrap()) && !DECL_EXTERNAL(decl.unwrap()))
+               return false;
+            root   = decl;
+            offset = 0;
+            type   = decl.value_type();
+            continue;
+         }
+         
+         if (segm.is_array_access()) {
+            size_t index = 0;
+            if (std::holds_alternative<size_t>(segm.data)) {
+               index = std::get<size_t>(segm.data);
+            } else {
+               auto it = state.loop_indices.find(segm.array_loop_counter_descriptor().read);
+               if (it == state.loop_indices.end())
+                  return false;
+               index = it->second;
+            }
+            if (!type->is_array())
+               return false;
+            type    = type->as_array().value_type();
+            offset += index * type->size_in_bytes();
+            continue;
+         }
+         
+         const auto* desc = segm.member_descriptor().read;
+         assert(desc != nullptr);
+         if (!desc->decl.is<gw::decl::field>())
+            return false;
+         auto field = desc->decl.as<gw::decl::field>();
+         if (field.is_bitfield())
+            return false;
+         offset += field.offset_in_bytes();
+         type    = field.value_type();
+      }
+      return !!root;
+   }
+   
+   // Appends an operation, merging it into the previous one if it transfers 
+   // another value of the same shape, one stride further along.
+   static void _push_op(std::vector<op>& ops, const op& item) {
+      if (!ops.empty()) {
+         auto& prev = ops.back();
+         bool  same =
+            prev.root     == item.root     &&
+            prev.kind     == item.kind     &&
+            prev.bitcount == item.bitcount &&
+            prev.min      == item.min      &&
+            prev.length   == item.length;
+         if (same && item.offset > prev.offset && prev.count < max_op_count) {
+            if (prev.count == 1) {
+               prev.stride = item.offset - prev.offset;
+               prev.count  = 2;
+               return;
+            }
+            if (item.offset == prev.offset + prev.count * prev.stride) {
+               ++prev.count;
+               return;
+            }
+         }
+      }
+      ops.push_back(item);
+   }
+   
+   static bool _compile_node(_compile_state&, const instructions::base&);
+   
+   static bool _compile_single(_compile_state& state, const instructions::single& node) {
+      const auto& options = node.value.bitpacking_options();
+      if (options.is_omitted) {
+         //
+         // Omitted values without defaults generate no code at all. Those 
+         // with defaults need code to assign the default on read, which a 
+         // table can't express.
+         //
+         return !options.default_value;
+      }
+      if (node.bit_slice.has_value() || node.byte_slice.has_value()) {
+         //
+         // Values split across sectors have to be combined with whatever was 
+         // read from the other sectors.
+         //
+         return false;
+      }
+      
+      gw::decl::optional_variable root;
+      size_t                      offset = 0;
+      gw::type::optional_base     type;
+      if (!_locate(state, node.value, root, offset, type))
+         return false;
+      
+      op item;
+      item.root   = root;
+      item.offset = offset;
+      
+      auto _kind_for_size = [&item](size_t bytecount) {
+         switch (bytecount) {
+            case 1:
+               item.kind = op_kind::u8;
+               return true;
+            case 2:
+               item.kind = op_kind::u16;
+               return true;
+            case 4:
+               item.kind = op_kind::u32;
+               return true;
+            default:
+               break;
+         }
+         return false;
+      };
+      
+      if (options.is<typed_options::boolean>()) {
+         if (type->size_in_bytes() != 1)
+            return false;
+         item.kind     = op_kind::boolean;
+         item.bitcount = 1;
+      } else if (options.is<typed_options::delta>()) {
+         //
+         // The interpreter has no way to accumulate differences.
+         //
+         return false;
+      } else if (options.is<typed_options::integral>()) {
+         const auto& int_opt = options.as<typed_options::integral>();
+         if (!int_opt.value_set.empty()) {
+            //
+            // The interpreter has no way to map values to indices within 
+            // a value set.
+            //
+            return false;
+         }
+         if (!_kind_for_size(type->size_in_bytes()))
+            return false;
+         item.bitcount = int_opt.bitcount;
+         if (int_opt.min != 0 && int_opt.min != typed_options::integral::no_minimum)
+            item.min = int_opt.min;
+      } else if (options.is<typed_options::quantized>()) {
+         //
+         // The interpreter has no way to scale values.
+         //
+         return false;
+      } else if (options.is<typed_options::pointer>()) {
+         if (options.as<typed_options::pointer>().into) {
+            //
+            // The interpreter has no way to map pointers to indices.
+            //
+            return false;
+         }
+         if (!_kind_for_size(type->size_in_bytes()))
+            return false;
+         item.bitcount = type->size_in_bits();
+      } else if (options.is<typed_options::string>()) {
+         const auto& str_opt = options.as<typed_options::string>();
+         if (str_opt.uses_charset()) {
+            //
+            // The interpreter transfers strings with the bitstream string 
+            // functions, which only handle whole bytes.
+            //
+            return false;
+         }
+         item.kind   = str_opt.nonstring ? op_kind::string_ut : op_kind::string_nt;
+         item.length = str_opt.length;
+      } else if (options.is<typed_options::buffer>()) {
+         item.kind   = op_kind::buffer;
+         item.length = options.as<typed_options::buffer>().bytecount;
+      } else if (options.is<typed_options::structure>()) {
+         //
+         // Rather than calling the whole-struct function, expand its node 
+         // tree in place, so that the struct's members become operations 
+         // at fixed addresses.
+         //
+         if (!type->is_record())
+            return false;
+         if (mixed_radix::is_mixed_radix(options, *type)) {
+            //
+            // Mixed-radix structs aren't a sequence of operations on their 
+            // members; leave them to their whole-struct functions.
+            //
+            return false;
+         }
+         auto record    = type->as_record();
+         auto functions = state.ctxt.get_whole_struct_functions_for(record);
+         const auto* tree_root = state.ctxt.whole_struct_functions.get_instructions_for(record);
+         assert(tree_root != nullptr);
+         
+         const auto* root_desc = &decl_dictionary::get().dereference_and_describe(functions.read.nth_parameter(1));
+         assert(!state.stand_ins.contains(root_desc));
+         state.stand_ins.emplace(root_desc, _stand_in{
+            .root   = *root,
+            .offset = offset,
+            .type   = record,
+         });
+         bool success = _compile_node(state, *tree_root);
+         state.stand_ins.erase(root_desc);
+         return success;
+      } else {
+         return false;
+      }
+      
+      _push_op(state.ops, item);
+      return true;
+   }
+   
+   static bool _compile_node(_compile_state& state, const instructions::base& node) {
+      switch (node.get_type()) {
+         case instructions::type::container:
+            for(const auto& child_ptr : node.as<instructions::container>()->instructions)
+               if (!_compile_node(state, *child_ptr))
+                  return false;
+            return true;
+         
+         case instructions::type::array_slice:
+            {
+               const auto& casted  = *node.as<instructions::array_slice>();
+               const auto* counter = casted.loop_index.descriptors.read;
+               for(size_t i = 0; i < casted.array.count; ++i) {
+                  state.loop_indices.insert_or_assign(counter, casted.array.start + i);
+                  for(const auto& child_ptr : casted.instructions)
+                     if (!_compile_node(state, *child_ptr))
+                        return false;
+               }
+               state.loop_indices.erase(counter);
+            }
+            return true;
+         
+         case instructions::type::single:
+            return _compile_single(state, *node.as<instructions::single>());
+         
+         default:
+            //
+            // Padding, transformed values, and unions.
+            //
+            break;
+      }
+      return false;
+   }
+   
+   extern std::optional<std::vector<op>> compile(const instructions::base& root, const instructions::utils::generation_context& ctxt) {
+      //
+      // The interpreter doesn't update checksums.
+      //
+      if (ctxt.checksum_ptr.read)
+         return {};
+      
+      _compile_state state = {
+         .ctxt = ctxt,
+      };
+      if (!_compile_node(state, root))
+         return {};
+      return std::move(state.ops);
+   }
+   
+   //
+   // Size estimates.
+   //
+   
+   // Rough sizes, in bytes, of common constructs in generated code (per 
+   // function) and in tables, on a 32-bit target.
+   namespace costs {
+      constexpr const size_t call   = 12; // call to a bitstream or whole-struct function, with arguments
+      constexpr const size_t store  = 4;  // store of a read value
+      constexpr const size_t arith  = 4;  // applying or removing a minimum
+      constexpr const size_t loop   = 16; // loop counter and branch
+      constexpr const size_t branch = 8;
+      
+      constexpr const size_t table_entry = 4; // address, word, or argument
+      constexpr const size_t table_call  = 12 + table_entry; // interpreter call, and the word list's terminator
+   }
+   
+   static size_t _estimate_code_size_of(const instructions::base& node) {
+      size_t size = 0;
+      if (auto* cont = node.as<instructions::container>()) {
+         for(const auto& child_ptr : cont->instructions)
+            size += _estimate_code_size_of(*child_ptr);
+      } else if (auto* us = node.as<instructions::union_switch>()) {
+         for(const auto& pair : us->cases)
+            size += costs::branch + _estimate_code_size_of(*pair.second);
+      }
+      
+      switch (node.get_type()) {
+         case instructions::type::array_slice:
+            size += costs::loop;
+            break;
+         case instructions::type::padding:
+            size += costs::call;
+            break;
+         case instructions::type::transform:
+            size += costs::call * 2;
+            break;
+         case instructions::type::single:
+            {
+               const auto& options = node.as<instructions::single>()->value.bitpacking_options();
+               if (options.is_omitted) {
+                  if (options.default_value)
+                     size += costs::store;
+                  break;
+               }
+               size += costs::call;
+               if (!options.is<typed_options::structure>())
+                  size += costs::store;
+               if (options.is<typed_options::integral>()) {
+                  const auto& int_opt = options.as<typed_options::integral>();
+                  if (int_opt.min != 0 && int_opt.min != typed_options::integral::no_minimum)
+                     size += costs::arith;
+               }
+            }
+            break;
+         default:
+            break;
+      }
+      return size;
+   }
+   
+   extern size_t estimate_code_size(const instructions::base& root) {
+      return _estimate_code_size_of(root) * 2; // read and save
+   }
+   
+   extern size_t estimate_table_size(const std::vector<op>& ops) {
+      size_t size = costs::table_call * 2; // read and save
+      for(const auto& item : ops) {
+         size += costs::table_entry * 2; // address and word
+         if (item.min)
+            size += costs::table_entry;
+         if (_kind_has_length(item.kind))
+            size += costs::table_entry;
+         if (item.count > 1)
+            size += costs::table_entry;
+      }
+      return size;
+   }
+   
+   //
+   // Generating the interpreter and tables.
+   //
+   
+   extern func_pair declare_interpreter() {
+      const auto& ty     = gw::builtin_types::get_fast();
+      const auto& global = basic_global_state::get_fast().global_options;
+      
+      auto function_type = gw::type::function(
+         ty.basic_void,
+         // args:
+         *global.types.bitstream_state_ptr,
+         ty.void_ptr.add_const().add_pointer(), // void* const* addresses
+         ty.uint32.add_const().add_pointer(),   // const uint32_t* words
+         ty.uint32.add_const().add_pointer()    // const uint32_t* args
+      );
+      return func_pair(
+         gw::decl::function("__lu_bitpack_read_table", function_type),
+         gw::decl::function("__lu_bitpack_save_table", function_type)
+      );
+   }
+   
+   extern func_pair generate_interpreter() {
+      const auto& gs     = basic_global_state::get_fast();
+      const auto& ty     = gw::builtin_types::get_fast();
+      const auto& global = gs.global_options;
+      
+      auto pair = declare_interpreter();
+      
+      for(int k = 0; k < 2; ++k) {
+         bool is_read = k == 0;
+         auto func    = is_read ? pair.read : pair.save;
+         
+         func.as_modifiable().set_result_decl(gw::decl::result(ty.basic_void));
+         for(size_t i = 0; i < 4; ++i)
+            func.nth_parameter(i).make_used();
+         
+         auto state     = func.nth_parameter(0).as_value();
+         auto addresses = func.nth_parameter(1).as_value();
+         auto words     = func.nth_parameter(2).as_value();
+         auto args      = func.nth_parameter(3).as_value();
+         
+         gw::expr::local_block root_block;
+         gw::statement_list    statements = root_block.statements();
+         
+         auto _declare_local = [&statements](lu::strings::zview name, gw::type::base type) {
+            gw::decl::variable decl(name, type);
+            decl.make_artificial();
+            decl.make_used();
+            statements.append(decl.make_declare_expr());
+            return decl.as_value();
+         };
+         auto word    = _declare_local("__lu_bitpack_word",    ty.uint32);
+         auto kind    = _declare_local("__lu_bitpack_kind",    ty.uint32);
+         auto address = _declare_local("__lu_bitpack_address", ty.uint8.add_pointer());
+         auto min     = _declare_local("__lu_bitpack_min",     ty.uint32);
+         auto length  = _declare_local("__lu_bitpack_length",  ty.uint32);
+         auto count   = _declare_local("__lu_bitpack_count",   ty.uint32);
+         auto stride  = _declare_local("__lu_bitpack_stride",  ty.uint32);
+         
+         auto _u32 = [&ty](uint32_t v) {
+            return gw::constant::integer(ty.uint32, v);
+         };
+         
+         /*
+            
+            Produces:
+            
+            l_next:
+               word = *words++;
+               if (word == 0)
+                  goto l_done;
+               address = (uint8_t*)*addresses++;
+               kind    = (word >> 6) & 7;
+               min     = 0;
+               length  = 0;
+               stride  = 0;
+               if (word & (1 << 9))
+                  min = *args++;
+               if (kind >= 4)
+                  length = *args++;
+               count = word >> 10;
+               if (count > 1)
+                  stride = *args++;
+            l_element:
+               // transfer one value, based on `kind`
+               address += stride;
+               (--count != 0) ? goto l_element : goto l_next;
+            l_done:
+         
+         */
+         
+         gw::decl::label l_next;
+         gw::decl::label l_element;
+         gw::decl::label l_done;
+         
+         statements.append(gw::expr::declare_label(l_next));
+         statements.append(gw::expr::assign(word, words.increment_post().dereference()));
+         {
+            gw::flow::simple_if_else_set branches;
+            branches.add_branch(word.cmp_is_equal(_u32(0)), gw::expr::go_to_label(l_done));
+            statements.append(*branches.result);
+         }
+         statements.append(gw::expr::assign(
+            address,
+            addresses.increment_post().dereference().conversion_sans_bytecode(address.value_type())
+         ));
+         statements.append(gw::expr::assign(
+            kind,
+            word.shift_right(_u32(word_kind_shift)).bitwise_and(_u32(word_kind_mask))
+         ));
+         statements.append(gw::expr::assign(min,    _u32(0)));
+         statements.append(gw::expr::assign(length, _u32(0)));
+         statements.append(gw::expr::assign(stride, _u32(0)));
+         {
+            gw::flow::simple_if_else_set branches;
+            branches.add_branch(
+               word.bitwise_and(_u32(word_has_min_bit)).cmp_is_not_equal(_u32(0)),
+               gw::expr::assign(min, args.increment_post().dereference())
+            );
+            statements.append(*branches.result);
+         }
+         {
+            gw::flow::simple_if_else_set branches;
+            branches.add_branch(
+               kind.cmp_is_greater_or_equal(_u32((uint32_t)op_kind::string_nt)),
+               gw::expr::assign(length, args.increment_post().dereference())
+            );
+            statements.append(*branches.result);
+         }
+         statements.append(gw::expr::assign(count, word.shift_right(_u32(word_count_shift))));
+         {
+            gw::flow::simple_if_else_set branches;
+            branches.add_branch(
+               count.cmp_is_greater(_u32(1)),
+               gw::expr::assign(stride, args.increment_post().dereference())
+            );
+            statements.append(*branches.result);
+         }
+         
+         statements.append(gw::expr::declare_label(l_element));
+         {
+            auto bits = word.bitwise_and(_u32(word_bitcount_mask));
+            
+            // `*(T*)address`
+            auto _target = [&address](gw::type::base type) {
+               return address.conversion_sans_bytecode(type.add_pointer()).dereference();
+            };
+            
+            gw::flow::simple_if_else_set branches;
+            auto _add_integral = [&](op_kind k, gw::decl::optional_function read_func, gw::decl::optional_function save_func, gw::type::integral type) {
+               assert(!!read_func);
+               assert(!!save_func);
+               auto func     = is_read ? *read_func : *save_func;
+               auto bit_type = func.function_type().nth_argument_type(is_read ? 1 : 2).as_integral();
+               
+               gw::expr::optional_base transfer;
+               if (is_read) {
+                  // *(T*)address = (T)(read(state, bits) + min);
+                  gw::value v = gw::expr::call(func, state, bits.convert_to_integer(bit_type));
+                  transfer = gw::expr::assign(
+                     _target(type),
+                     v.convert_to_integer(ty.uint32).add(min).convert_to_integer(type)
+                  );
+               } else {
+                  // save(state, (T)(*(T*)address - min), bits);
+                  auto value_type = func.function_type().nth_argument_type(1).as_integral();
+                  transfer = gw::expr::call(
+                     func,
+                     // args:
+                     state,
+                     _target(type).convert_to_integer(ty.uint32).sub(min).convert_to_integer(value_type),
+                     bits.convert_to_integer(bit_type)
+                  );
+               }
+               branches.add_branch(kind.cmp_is_equal(_u32((uint32_t)k)), *transfer);
+            };
+            _add_integral(op_kind::u8,  global.functions.read.u8,  global.functions.save.u8,  ty.uint8);
+            _add_integral(op_kind::u16, global.functions.read.u16, global.functions.save.u16, ty.uint16);
+            _add_integral(op_kind::u32, global.functions.read.u32, global.functions.save.u32, ty.uint32);
+            
+            if (is_read) {
+               // *(uint8_t*)address = read_bool(state);
+               branches.add_branch(
+                  kind.cmp_is_equal(_u32((uint32_t)op_kind::boolean)),
+                  gw::expr::assign(
+                     _target(ty.uint8),
+                     gw::expr::call(*global.functions.read.boolean, state)
+                  )
+               );
+            } else {
+               // save_bool(state, *(uint8_t*)address);
+               branches.add_branch(
+                  kind.cmp_is_equal(_u32((uint32_t)op_kind::boolean)),
+                  gw::expr::call(*global.functions.save.boolean, state, _target(ty.uint8))
+               );
+            }
+            
+            auto _add_span = [&](op_kind k, gw::decl::optional_function read_func, gw::decl::optional_function save_func) {
+               assert(!!read_func);
+               assert(!!save_func);
+               // func(state, (T*)address, length);
+               auto func      = is_read ? *read_func : *save_func;
+               auto func_type = func.function_type();
+               branches.add_branch(
+                  kind.cmp_is_equal(_u32((uint32_t)k)),
+                  gw::expr::call(
+                     func,
+                     // args:
+                     state,
+                     address.conversion_sans_bytecode(func_type.nth_argument_type(1)),
+                     length.convert_to_integer(func_type.nth_argument_type(2).as_integral())
+                  )
+               );
+            };
+            _add_span(op_kind::string_nt, global.functions.read.string_nt, global.functions.save.string_nt);
+            _add_span(op_kind::string_ut, global.functions.read.string_ut, global.functions.save.string_ut);
+            _add_span(op_kind::buffer,    global.functions.read.buffer,    global.functions.save.buffer);
+            
+            statements.append(*branches.result);
+         }
+         statements.append(gw::expr::assign(
+            address,
+            gw::value::wrap(fold_build_pointer_plus(address.unwrap(), stride.unwrap()))
+         ));
+         statements.append(gw::expr::ternary(
+            ty.basic_void,
+            count.decrement_pre().cmp_is_not_equal(_u32(0)),
+            gw::expr::go_to_label(l_element),
+            gw::expr::go_to_label(l_next)
+         ));
+         statements.append(gw::expr::declare_label(l_done));
+         
+         func.set_is_defined_elsewhere(false);
+         func.as_modifiable().set_root_block(root_block);
+         
+         // expose these identifiers so we can inspect them with our debug-dump pragmas.
+         func.introduce_to_current_scope();
+      }
+      return pair;
+   }
+   
+   extern expr_pair generate_table_call(
+      size_t                     sector_index,
+      const std::vector<op>&     ops,
+      func_pair                  interpreter,
+      const optional_value_pair& state_ptr
+   ) {
+      const auto& ty = gw::builtin_types::get_fast();
+      
+      std::vector<gw::value> addresses;
+      std::vector<gw::value> words;
+      std::vector<gw::value> args;
+      for(const auto& item : ops) {
+         assert(item.count > 0 && item.count <= max_op_count);
+         assert(item.bitcount <= word_bitcount_mask);
+         
+         // (void*)((uint8_t*)&root + offset)
+         gw::decl::variable root = *item.root;
+         gw::value address = root.as_value().address_of().conversion_sans_bytecode(ty.uint8.add_pointer());
+         if (item.offset > 0)
+            address = gw::value::wrap(fold_build_pointer_plus_hwi(address.unwrap(), item.offset));
+         addresses.push_back(address.conversion_sans_bytecode(ty.void_ptr));
+         
+         uint32_t word = item.bitcount;
+         word |= (uint32_t)item.kind << word_kind_shift;
+         word |= (uint32_t)item.count << word_count_shift;
+         if (item.min) {
+            word |= word_has_min_bit;
+            args.push_back(gw::constant::integer(ty.uint32, (uint32_t)*item.min));
+         }
+         if (_kind_has_length(item.kind))
+            args.push_back(gw::constant::integer(ty.uint32, item.length));
+         if (item.count > 1)
+            args.push_back(gw::constant::integer(ty.uint32, item.stride));
+         words.push_back(gw::constant::integer(ty.uint32, word));
+      }
+      words.push_back(gw::constant::integer(ty.uint32, 0));
+      
+      auto _define_table = [sector_index](const char* name, gw::type::base element_type, const std::vector<gw::value>& elements) {
+         auto array_type = element_type.add_const().add_array_extent(elements.size());
+         
+         gw::decl::variable var(lu::stringf("__lu_bitpack_table_%s_%u", name, (int)sector_index), array_type);
+         var.make_artificial();
+         var.set_initial_value(gw::constructor(array_type, elements));
+         var.make_read_only();
+         var.make_file_scope_extern();
+         var.set_is_defined_elsewhere(false);
+         return var;
+      };
+      auto table_addresses = _define_table("addresses", ty.void_ptr, addresses);
+      auto table_words     = _define_table("words",     ty.uint32,   words);
+      
+      auto args_ptr_type = ty.uint32.add_const().add_pointer();
+      auto args_ptr      = gw::value::wrap(null_pointer_node).conversion_sans_bytecode(args_ptr_type);
+      if (!args.empty())
+         args_ptr = _define_table("args", ty.uint32, args).as_value().convert_array_to_pointer();
+      
+      auto _call = [&](gw::decl::function func, gw::value state) {
+         return gw::expr::call(
+            func,
+            // args:
+            state,
+            table_addresses.as_value().convert_array_to_pointer(),
+            table_words.as_value().convert_array_to_pointer(),
+            args_ptr
+         );
+      };
+      return expr_pair(
+         _call(interpreter.read, *state_ptr.read),
+         _call(interpreter.save, *state_ptr.save)
+      );
+   }
+}
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include "codegen/value_set.h"
+#include <bit>
+#include <cassert>
+#include <map>
+#include "lu/stringf.h"
+#include "codegen/instructions/utils/generation_context.h"
+#include "gcc_wrappers/constant/integer.h"
+#include "gcc_wrappers/decl/function.h"
+#include "gcc_wrappers/decl/label.h"
+#include "gcc_wrappers/decl/param.h"
+#include "gcc_wrappers/decl/result.h"
+#include "gcc_wrappers/decl/variable.h"
+#include "gcc_wrappers/expr/assign.h"
+#include "gcc_wrappers/expr/call.h"
+#include "gcc_wrappers/expr/declare_label.h"
+#include "gcc_wrappers/expr/go_to_label.h"
+#include "gcc_wrappers/expr/local_block.h"
+#include "gcc_wrappers/expr/return_result.h"
+#include "gcc_wrappers/flow/simple_if_else_set.h"
+#include "gcc_wrappers/type/array.h"
+#include "gcc_wrappers/type/function.h"
+#include "gcc_wrappers/type/integral.h"
+#include "gcc_wrappers/builtin_types.h"
+#include "gcc_wrappers/constructor.h"
+#include "gcc_wrappers/statement_list.h"
+namespace gw {
+   using namespace gcc_wrappers;
+}
+
+namespace codegen::value_set {
+   namespace {
+      struct _entry {
+         size_t id = 0;
+         gw::decl::optional_variable table;
+         
+         // Searching a table of signed values and searching a table of unsigned 
+         // values need different comparisons.
+         gw::decl::optional_function index_of_signed;
+         gw::decl::optional_function index_of_unsigned;
+      };
+   }
+   
+   // A plug-in instance only ever compiles one translation unit, so this is 
+   // effectively per translation unit.
+   static std::map<std::vector<intmax_t>, _entry> _entries;
+   
+   static _entry& _get_entry(const std::vector<intmax_t>& set) {
+      auto it = _entries.find(set);
+      if (it != _entries.end())
+         return it->second;
+      
+      auto& entry = _entries[set];
+      entry.id = _entries.size() - 1;
+      return entry;
+   }
+   
+   // Build constants from the full value, since a set may hold values that 
+   // don't fit in an int.
+   static gw::value _int(gw::type::integral type, intmax_t v) {
+      return gw::constant::integer::wrap(build_int_cst(type.unwrap(), (HOST_WIDE_INT)v));
+   }
+   
+   // The smallest integral type that can hold every value in the set.
+   static gw::type::integral _element_type_for(const std::vector<intmax_t>& set) {
+      const auto& ty = gw::builtin_types::get();
+      
+      bool is_signed = set.front() < 0;
+      for(size_t bitcount : { 8, 16, 32 }) {
+         auto type = ty.smallest_integral_for(bitcount, is_signed);
+         if (set.front() < type.minimum_value())
+            continue;
+         if (set.back() > 0 && (uintmax_t)set.back() > type.maximum_value())
+            continue;
+         return type;
+      }
+      return ty.smallest_integral_for(64, is_signed);
+   }
+   
+   // The type we search the table in. We only search in 64 bits if the set 
+   // needs it, since that's slow on the 32-bit targets we care most about.
+   static gw::type::integral _search_type_for(const std::vector<intmax_t>& set, bool is_signed) {
+      const auto& ty = gw::builtin_types::get();
+      if (_element_type_for(set).size_in_bits() > 32)
+         return is_signed ? ty.int64 : ty.uint64;
+      return is_signed ? ty.int32 : ty.uint32;
+   }
+   
+   // static const T __lu_bitpack_value_set_0[] = { ... };
+   static gw::decl::variable _get_table(const std::vector<intmax_t>& set) {
+      auto& entry = _get_entry(set);
+      if (entry.table)
+         return *entry.table;
+      
+      auto element_type = _element_type_for(set);
+      auto array_type   = element_type.add_const().add_array_extent(set.size());
+      
+      std::vector<gw::value> elements;
+      for(auto v : set)
+         elements.push_back(_int(element_type, v));
+      
+      gw::decl::variable var(lu::stringf("__lu_bitpack_value_set_%u", (int)entry.id), array_type);
+      var.make_artificial();
+      var.set_initial_value(gw::constructor(array_type, elements));
+      var.make_read_only();
+      var.make_file_scope_extern();
+      var.set_is_externally_accessible(false);
+      var.set_is_defined_elsewhere(false);
+      entry.table = var;
+      return var;
+   }
+   
+   // static uint32_t __lu_bitpack_value_set_0_index(T value);
+   //
+   // T is 32 bits wide, unless the set holds values that need 64.
+   static gw::decl::function _get_index_function(
+      const std::vector<intmax_t>&                   set,
+      bool                                           is_signed,
+      const instructions::utils::generation_context& ctxt
+   ) {
+      const auto& ty = gw::builtin_types::get();
+      
+      auto  table = _get_table(set);
+      auto& entry = _get_entry(set);
+      auto& dst   = is_signed ? entry.index_of_signed : entry.index_of_unsigned;
+      if (dst)
+         return *dst;
+      
+      auto value_type = _search_type_for(set, is_signed);
+      
+      auto func = gw::decl::function(
+         lu::strings::zview(lu::stringf(
+            is_signed ? "__lu_bitpack_value_set_%u_index_signed" : "__lu_bitpack_value_set_%u_index",
+            (int)entry.id
+         )),
+         gw::type::function(
+            ty.uint32,
+            // args:
+            value_type
+         )
+      );
+      func.set_is_externally_accessible(false);
+      func.apply_attributes(ctxt.function_attributes);
+      auto result_decl = gw::decl::result(ty.uint32);
+      func.as_modifiable().set_result_decl(result_decl);
+      func.nth_parameter(0).make_used();
+      
+      auto value = func.nth_parameter(0).as_value();
+      
+      gw::expr::local_block root_block;
+      gw::statement_list    statements = root_block.statements();
+      
+      auto _declare_local = [&statements](lu::strings::zview name, gw::type::base type) {
+         gw::decl::variable decl(name, type);
+         decl.make_artificial();
+         decl.make_used();
+         statements.append(decl.make_declare_expr());
+         return decl.as_value();
+      };
+      auto lo  = _declare_local("__lu_bitpack_lo",  ty.uint32);
+      auto hi  = _declare_local("__lu_bitpack_hi",  ty.uint32);
+      auto mid = _declare_local("__lu_bitpack_mid", ty.uint32);
+      
+      auto _u32 = [&ty](uint32_t v) {
+         return gw::constant::integer(ty.uint32, v);
+      };
+      
+      /*
+         
+         Produces a lower-bound search that can't run off the end:
+            
+            lo = 0;
+            hi = count - 1;
+         l_loop:
+            if (lo >= hi)
+               goto l_done;
+            mid = (lo + hi) >> 1;
+            if ((T)table[mid] < value)
+               lo = mid + 1;
+            else
+               hi = mid;
+            goto l_loop;
+         l_done:
+            return lo;
+      
+      */
+      
+      gw::decl::label l_loop;
+      gw::decl::label l_done;
+      
+      statements.append(gw::expr::assign(lo, _u32(0)));
+      statements.append(gw::expr::assign(hi, _u32(set.size() - 1)));
+      statements.append(gw::expr::declare_label(l_loop));
+      {
+         gw::flow::simple_if_else_set branches;
+         branches.add_branch(lo.cmp_is_greater_or_equal(hi), gw::expr::go_to_label(l_done));
+         statements.append(*branches.result);
+      }
+      statements.append(gw::expr::assign(mid, lo.add(hi).shift_right(_u32(1))));
+      {
+         auto element = table.as_value().access_array_element(mid).convert_to_integer(value_type);
+         
+         gw::flow::simple_if_else_set branches;
+         branches.add_branch(element.cmp_is_less(value), gw::expr::assign(lo, mid.add(_u32(1))));
+         branches.set_else_branch(gw::expr::assign(hi, mid));
+         statements.append(*branches.result);
+      }
+      statements.append(gw::expr::go_to_label(l_loop));
+      statements.append(gw::expr::declare_label(l_done));
+      statements.append(gw::expr::return_result(
+         gw::expr::assign(result_decl.as_value(), lo)
+      ));
+      
+      func.set_is_defined_elsewhere(false);
+      func.as_modifiable().set_root_block(root_block);
+      
+      // expose this identifier so we can inspect it with our debug-dump pragmas.
+      func.introduce_to_current_scope();
+      
+      dst = func;
+      return func;
+   }
+   
+   extern gw::value index_of(
+      const std::vector<intmax_t>&                   set,
+      gw::value                                      value,
+      const instructions::utils::generation_context& ctxt
+   ) {
+      const auto& ty = gw::builtin_types::get();
+      assert(!set.empty());
+      
+      if (set.size() == 1)
+         return gw::constant::integer(ty.uint32, 0);
+      
+      auto type = value.value_type().with_all_qualifiers_stripped();
+      bool is_signed = type.is_integral() && type.as_integral().is_signed();
+      
+      auto func = _get_index_function(set, is_signed, ctxt);
+      return gw::expr::call(
+         func,
+         // args:
+         value.convert_to_integer(_search_type_for(set, is_signed))
+      );
+   }
+   
+   extern gw::value value_at(const std::vector<intmax_t>& set, gw::value index) {
+      const auto& ty = gw::builtin_types::get();
+      assert(!set.empty());
+      
+      if (set.size() == 1)
+         return _int(_element_type_for(set), set.front());
+      
+      auto table = _get_table(set);
+      if (std::has_single_bit(set.size())) {
+         //
+         // Every index that fits in the serialized bits is in range.
+         //
+         return table.as_value().access_array_element(index);
+      }
+      return table.as_value().access_array_element(
+         index.convert_to_integer(ty.uint32).min(gw::constant::integer(ty.uint32, set.size() - 1))
+      );
+   }
+}
\ No newline at end of file
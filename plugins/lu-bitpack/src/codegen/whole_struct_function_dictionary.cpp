@@ -17,10 +17,25 @@ namespace codegen {
          return nullptr;
       return it->second.instructions_root.get();
    }
+   gw::decl::optional_function whole_struct_function_dictionary::get_dirty_check_for(gw::type::base type) const {
+      auto it = this->_functions.find(type);
+      if (it == this->_functions.end())
+         return {};
+      return it->second.dirty_check.function;
+   }
    
    void whole_struct_function_dictionary::add_functions_for(gw::type::base type, whole_struct_function_info&& info) {
       auto& slot = this->_functions[type];
       assert(!slot.functions.read && !slot.functions.save);
       slot = std::move(info);
    }
+   
+   void whole_struct_function_dictionary::add_dirty_check_for(gw::type::base type, gw::decl::function func, std::unique_ptr<instructions::base>&& root) {
+      auto it = this->_functions.find(type);
+      assert(it != this->_functions.end());
+      auto& slot = it->second.dirty_check;
+      assert(!slot.function);
+      slot.function          = func;
+      slot.instructions_root = std::move(root);
+   }
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "gcc_wrappers/constant/floating_point.h"
+#include <cstdlib> // std::strtold
 #include "gcc_wrappers/constant/integer.h"
 #include "gcc_wrappers/_node_boilerplate-impl.define.h"
 #include <real.h> // comparisons
@@ -16,9 +17,11 @@ namespace gcc_wrappers::constant {
 
    /*static*/ floating_point floating_point::from_string(type::floating_point type, lu::strings::zview str) {
       REAL_VALUE_TYPE raw;
-      /*int overflow =*/ real_from_string(&raw, str.c_str());
-      
-      // TODO: Set TREE_OVERFLOW(node) based on `overflow != 0`?
+      //
+      // Round to the type's precision, so that the constant holds a value 
+      // that the type can actually represent.
+      //
+      real_from_string3(&raw, str.c_str(), TYPE_MODE(type.unwrap()));
       return floating_point::wrap(build_real(type.unwrap(), raw));
    }
    
@@ -93,6 +96,10 @@ namespace gcc_wrappers::constant {
       return result;
    }
    
+   long double floating_point::to_host_value() const {
+      return std::strtold(this->to_string().c_str(), nullptr);
+   }
+   
    bool floating_point::operator<(const floating_point& other) const {
       return real_less(TREE_REAL_CST_PTR(this->_node), TREE_REAL_CST_PTR(other._node));
    }
@@ -0,0 +1,25 @@
+#include "gcc_wrappers/constructor.h"
+#include <cassert>
+#include "gcc_wrappers/_node_boilerplate-impl.define.h"
+
+namespace gcc_wrappers {
+   GCC_NODE_WRAPPER_BOILERPLATE(constructor)
+   
+   constructor::constructor(type::array array_type, const std::vector<value>& elements) {
+      assert(!array_type.is_variable_length_array());
+      assert(elements.size() <= *array_type.extent());
+      
+      vec<constructor_elt, va_gc>* list = nullptr;
+      vec_alloc(list, elements.size());
+      for(size_t i = 0; i < elements.size(); ++i) {
+         CONSTRUCTOR_APPEND_ELT(list, size_int(i), elements[i].unwrap());
+      }
+      this->_node = build_constructor(array_type.unwrap(), list);
+      TREE_CONSTANT(this->_node) = 1;
+      TREE_STATIC(this->_node)   = 1;
+   }
+   
+   size_t constructor::size() const {
+      return CONSTRUCTOR_NELTS(this->_node);
+   }
+}
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "lu/stringf.h"
 #include <function.h>
 #include <stringpool.h> // get_identifier
+#include <attribs.h> // decl_attributes
 #include <output.h> // assemble_external
 #include <toplev.h>
 #include <c-family/c-common.h> // lookup_name, pushdecl, etc.
@@ -140,6 +141,13 @@ namespace gcc_wrappers::decl {
       TREE_NOTHROW(this->_node) = v ? 1 : 0;
    }
    
+   void function::apply_attributes(attribute_list list) {
+      if (list.empty())
+         return;
+      tree node = this->_node;
+      decl_attributes(&node, list.unwrap(), 0, NULL_TREE);
+   }
+   
    bool function::has_body() const {
       return DECL_SAVED_TREE(this->_node) != NULL_TREE;
    }
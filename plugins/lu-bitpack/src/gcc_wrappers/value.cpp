@@ -21,6 +21,8 @@ namespace gcc_wrappers {
          return true;
       if (CONSTANT_CLASS_P(n) || EXPR_P(n))
          return true;
+      if (TREE_CODE(n) == CONSTRUCTOR)
+         return true;
       return false;
    }
    
@@ -113,10 +113,12 @@ std::optional<size_t> last_generation_result::find_offset_within_sector(const se
 }
 
 void last_generation_result::update(
-   const sectored_item_list& items_by_sector
+   const sectored_item_list& items_by_sector,
+   codegen::whole_struct_function_dictionary&& whole_struct_functions
 ) {
    this->_empty = false;
    this->_items_by_sector.verbatim = items_by_sector;
    this->_items_by_sector.expanded.clear();
    this->offsets_by_sector_expanded.clear();
+   this->_whole_struct_functions = std::move(whole_struct_functions);
 }
\ No newline at end of file
@@ -19,8 +19,13 @@ static plugin_info _my_plugin_info = {
 
 #include "attribute_handlers/bitpack_as_opaque_buffer.h"
 #include "attribute_handlers/bitpack_bitcount.h"
+#include "attribute_handlers/bitpack_charset.h"
 #include "attribute_handlers/bitpack_default_value.h"
+#include "attribute_handlers/bitpack_delta.h"
 #include "attribute_handlers/bitpack_misc_annotation.h"
+#include "attribute_handlers/bitpack_mixed_radix.h"
+#include "attribute_handlers/bitpack_pointer_into.h"
+#include "attribute_handlers/bitpack_quantize.h"
 #include "attribute_handlers/bitpack_range.h"
 #include "attribute_handlers/bitpack_stat_category.h"
 #include "attribute_handlers/bitpack_string.h"
@@ -28,6 +33,7 @@ static plugin_info _my_plugin_info = {
 #include "attribute_handlers/bitpack_transforms.h"
 #include "attribute_handlers/bitpack_union_external_tag.h"
 #include "attribute_handlers/bitpack_union_internal_tag.h"
+#include "attribute_handlers/bitpack_value_set.h"
 #include "attribute_handlers/generic_bitpacking_data_option.h"
 #include "attribute_handlers/generic_type_or_decl.h"
 #include "attribute_handlers/no_op.h"
@@ -112,6 +118,17 @@ namespace _attributes {
       .handler = &attribute_handlers::bitpack_bitcount,
       .exclude = NULL
    };
+   static struct attribute_spec bitpack_charset = {
+      .name = "lu_bitpack_charset",
+      .min_length = 1, // min argcount
+      .max_length = -1, // max argcount (use -1 for no max)
+      .decl_required = false,
+      .type_required = false,
+      .function_type_required = false,
+      .affects_type_identity  = true,
+      .handler = &attribute_handlers::bitpack_charset,
+      .exclude = NULL
+   };
    static struct attribute_spec bitpack_default_value = {
       .name = "lu_bitpack_default_value",
       .min_length = 1, // min argcount
@@ -123,6 +140,17 @@ namespace _attributes {
       .handler = &attribute_handlers::bitpack_default_value,
       .exclude = NULL
    };
+   static struct attribute_spec bitpack_delta = {
+      .name = "lu_bitpack_delta",
+      .min_length = 2, // min argcount
+      .max_length = 2, // max argcount
+      .decl_required = false,
+      .type_required = false,
+      .function_type_required = false,
+      .affects_type_identity  = true,
+      .handler = &attribute_handlers::bitpack_delta,
+      .exclude = NULL
+   };
    static struct attribute_spec bitpack_misc_annotation = {
       .name = "lu_bitpack_misc_annotation",
       .min_length = 1, // min argcount
@@ -134,6 +162,17 @@ namespace _attributes {
       .handler = &attribute_handlers::bitpack_misc_annotation,
       .exclude = NULL
    };
+   static struct attribute_spec bitpack_mixed_radix = {
+      .name = "lu_bitpack_mixed_radix",
+      .min_length = 0, // min argcount
+      .max_length = 0, // max argcount
+      .decl_required = false,
+      .type_required = false,
+      .function_type_required = false,
+      .affects_type_identity  = true,
+      .handler = &attribute_handlers::bitpack_mixed_radix,
+      .exclude = NULL
+   };
    static struct attribute_spec bitpack_omit = {
       .name = "lu_bitpack_omit",
       .min_length = 0, // min argcount
@@ -145,6 +184,28 @@ namespace _attributes {
       .handler = &attribute_handlers::generic_bitpacking_data_option,
       .exclude = NULL
    };
+   static struct attribute_spec bitpack_pointer_into = {
+      .name = "lu_bitpack_pointer_into",
+      .min_length = 1, // min argcount
+      .max_length = 1, // max argcount
+      .decl_required = false,
+      .type_required = false,
+      .function_type_required = false,
+      .affects_type_identity  = true,
+      .handler = &attribute_handlers::bitpack_pointer_into,
+      .exclude = NULL
+   };
+   static struct attribute_spec bitpack_quantize = {
+      .name = "lu_bitpack_quantize",
+      .min_length = 3, // min argcount
+      .max_length = 3, // max argcount
+      .decl_required = false,
+      .type_required = false,
+      .function_type_required = false,
+      .affects_type_identity  = true,
+      .handler = &attribute_handlers::bitpack_quantize,
+      .exclude = NULL
+   };
    static struct attribute_spec bitpack_range = {
       .name = "lu_bitpack_range",
       .min_length = 2, // min argcount
@@ -222,6 +283,17 @@ namespace _attributes {
       .handler = &attribute_handlers::bitpack_tagged_id,
       .exclude = NULL
    };
+   static struct attribute_spec bitpack_value_set = {
+      .name = "lu_bitpack_value_set",
+      .min_length = 1, // min argcount
+      .max_length = -1, // max argcount (use -1 for no max)
+      .decl_required = false,
+      .type_required = false,
+      .function_type_required = false,
+      .affects_type_identity  = true,
+      .handler = &attribute_handlers::bitpack_value_set,
+      .exclude = NULL
+   };
 }
 
 static void register_attributes(void* event_data, void* user_data) {
@@ -231,9 +303,14 @@ static void register_attributes(void* event_data, void* user_data) {
    register_attribute(&_attributes::internal_invalid_by_name);
    register_attribute(&_attributes::bitpack_as_opaque_buffer);
    register_attribute(&_attributes::bitpack_bitcount);
+   register_attribute(&_attributes::bitpack_charset);
    register_attribute(&_attributes::bitpack_default_value);
+   register_attribute(&_attributes::bitpack_delta);
    register_attribute(&_attributes::bitpack_misc_annotation);
+   register_attribute(&_attributes::bitpack_mixed_radix);
    register_attribute(&_attributes::bitpack_omit);
+   register_attribute(&_attributes::bitpack_pointer_into);
+   register_attribute(&_attributes::bitpack_quantize);
    register_attribute(&_attributes::bitpack_range);
    register_attribute(&_attributes::bitpack_stat_category);
    register_attribute(&_attributes::bitpack_string);
@@ -241,13 +318,16 @@ static void register_attributes(void* event_data, void* user_data) {
    register_attribute(&_attributes::bitpack_union_external_tag);
    register_attribute(&_attributes::bitpack_union_internal_tag);
    register_attribute(&_attributes::bitpack_union_member_id);
+   register_attribute(&_attributes::bitpack_value_set);
 }
 
 #include "pragma_handlers/debug_dump_bp_data_options.h"
 #include "pragma_handlers/debug_dump_function.h"
 #include "pragma_handlers/debug_dump_identifier.h"
 #include "pragma_handlers/enable.h"
+#include "pragma_handlers/generate_accessor.h"
 #include "pragma_handlers/generate_functions.h"
+#include "pragma_handlers/generate_setter.h"
 #include "pragma_handlers/serialized_offset_to_constant.h"
 #include "pragma_handlers/serialized_sector_id_to_constant.h"
 #include "pragma_handlers/set_options.h"
@@ -273,11 +353,21 @@ static void register_pragmas(void* event_data, void* user_data) {
       "enable",
       &pragma_handlers::enable
    );
+   c_register_pragma_with_expansion(
+      "lu_bitpack",
+      "generate_accessor",
+      &pragma_handlers::generate_accessor
+   );
    c_register_pragma_with_expansion(
       "lu_bitpack",
       "generate_functions",
       &pragma_handlers::generate_functions
    );
+   c_register_pragma_with_expansion(
+      "lu_bitpack",
+      "generate_setter",
+      &pragma_handlers::generate_setter
+   );
    c_register_pragma_with_expansion(
       "lu_bitpack",
       "serialized_offset_to_constant",
@@ -299,6 +389,11 @@ static void register_pragmas(void* event_data, void* user_data) {
 
 #include "basic_global_state.h"
 #include "bitpacking/verify_bitpack_attributes_on_type_finished.h"
+#include "time_report.h"
+
+static void on_finish(void* event_data, void* user_data) {
+   time_report::get().emit();
+}
 
 int plugin_init (
    struct plugin_name_args*   plugin_info,
@@ -328,6 +423,13 @@ int plugin_init (
          dst = arg.value;
          continue;
       }
+      if (std::string_view(arg.key) == "time-report") {
+         auto& report = time_report::get();
+         report.enabled = true;
+         if (arg.value)
+            report.output_path = arg.value;
+         continue;
+      }
    }
    
    register_callback(
@@ -342,6 +444,14 @@ int plugin_init (
       register_pragmas,
       NULL
    );
+   if (time_report::get().enabled) {
+      register_callback(
+         plugin_info->base_name,
+         PLUGIN_FINISH,
+         on_finish,
+         NULL
+      );
+   }
    {
       auto& mgr = gcc_wrappers::events::on_type_finished::get();
       mgr.initialize(plugin_info->base_name);
@@ -91,6 +91,12 @@ namespace pragma_handlers {
          const auto& src = options.as<bitpacking::typed_data_options::computed::buffer>();
          std::cerr << " - Bitpacking type: opaque buffer\n";
          std::cerr << "    - Bytecount: " << src.bytecount << '\n';
+      } else if (options.is<bitpacking::typed_data_options::computed::delta>()) {
+         const auto& src = options.as<bitpacking::typed_data_options::computed::delta>();
+         std::cerr << " - Bitpacking type: delta\n";
+         std::cerr << "    - First bits: " << src.first_bits << '\n';
+         std::cerr << "    - Delta bits: " << src.delta_bits << '\n';
+         std::cerr << "    - Length:     " << src.length << '\n';
       } else if (options.is<bitpacking::typed_data_options::computed::integral>()) {
          const auto& src = options.as<bitpacking::typed_data_options::computed::integral>();
          std::cerr << " - Bitpacking type: integral\n";
@@ -101,15 +107,43 @@ namespace pragma_handlers {
          } else {
             std::cerr << "    - Max:      " << src.max << '\n';
          }
+         if (!src.value_set.empty()) {
+            std::cerr << "    - Values:  ";
+            for(auto v : src.value_set)
+               std::cerr << ' ' << v;
+            std::cerr << '\n';
+         }
+      } else if (options.is<bitpacking::typed_data_options::computed::quantized>()) {
+         const auto& src = options.as<bitpacking::typed_data_options::computed::quantized>();
+         std::cerr << " - Bitpacking type: quantized\n";
+         std::cerr << "    - Bitcount: " << src.bitcount << '\n';
+         std::cerr << "    - Min:      " << src.min << '\n';
+         std::cerr << "    - Max:      " << src.max << '\n';
+         std::cerr << "    - Step:     " << src.step() << '\n';
       } else if (options.is<bitpacking::typed_data_options::computed::pointer>()) {
+         const auto& src = options.as<bitpacking::typed_data_options::computed::pointer>();
          std::cerr << " - Bitpacking type: pointer\n";
+         if (auto opt = src.into) {
+            std::cerr << "    - Into:     " << opt->name() << '\n';
+            std::cerr << "    - Elements: " << src.element_count << '\n';
+            std::cerr << "    - Bitcount: " << src.bitcount << '\n';
+         }
       } else if (options.is<bitpacking::typed_data_options::computed::string>()) {
          const auto& src = options.as<bitpacking::typed_data_options::computed::string>();
          std::cerr << " - Bitpacking type: string\n";
          std::cerr << "    - Length:    " << src.length << '\n';
          std::cerr << "    - Nonstring: " << (src.nonstring ? "yes" : "no") << '\n';
+         std::cerr << "    - Char bits: " << src.char_bits << '\n';
+         if (!src.charset.empty()) {
+            std::cerr << "    - Charset:  ";
+            for(auto v : src.charset)
+               std::cerr << ' ' << (int)v;
+            std::cerr << '\n';
+         }
       } else if (options.is<bitpacking::typed_data_options::computed::structure>()) {
+         const auto& src = options.as<bitpacking::typed_data_options::computed::structure>();
          std::cerr << " - Bitpacking type: struct\n";
+         std::cerr << "    - Mixed radix: " << (src.mixed_radix ? "yes" : "no") << '\n';
       } else if (options.is<bitpacking::typed_data_options::computed::tagged_union>()) {
          const auto& src = options.as<bitpacking::typed_data_options::computed::tagged_union>();
          std::cerr << " - Bitpacking type: union\n";
@@ -0,0 +1,261 @@
+#include "pragma_handlers/generate_accessor.h"
+#include <array>
+#include <memory> // GCC headers fuck up string-related STL identifiers that <memory> depends on
+#include "gcc_wrappers/constant/integer.h"
+#include "gcc_wrappers/decl/function.h"
+#include "gcc_wrappers/decl/result.h"
+#include "gcc_wrappers/decl/variable.h"
+#include "gcc_wrappers/expr/assign.h"
+#include "gcc_wrappers/expr/call.h"
+#include "gcc_wrappers/expr/local_block.h"
+#include "gcc_wrappers/expr/return_result.h"
+#include "gcc_wrappers/type/function.h"
+#include "gcc_wrappers/builtin_types.h"
+#include "gcc_wrappers/identifier.h"
+#include "gcc_wrappers/statement_list.h"
+#include "gcc_wrappers/value.h"
+#include "gcc_helpers/stringify_function_signature.h"
+#include "basic_global_state.h"
+#include "codegen/instructions/utils/generation_context.h"
+#include "codegen/instructions/base.h"
+#include "codegen/optional_value_pair.h"
+#include "codegen/sector_byte_containing.h"
+#include "codegen/serialization_item.h"
+#include "last_generation_result.h"
+#include "pragma_parse_exception.h"
+#include "pragma_handlers/helpers/parse_c_serialization_item.h"
+#include "pragma_handlers/helpers/standalone_value.h"
+#include <c-family/c-common.h> // lookup_name
+#include <diagnostic.h>
+namespace gw {
+   using namespace gcc_wrappers;
+}
+
+namespace pragma_handlers {
+   extern void generate_accessor(cpp_reader* reader) {
+      constexpr const char* this_pragma_name = "#pragma lu_bitpack generate_accessor";
+      
+      auto& result = last_generation_result::get();
+      if (result.empty()) {
+         error("%s: no code has been generated yet", this_pragma_name);
+         return;
+      }
+      
+      const auto& gs = basic_global_state::get();
+      const auto& ty = gw::builtin_types::get();
+      
+      location_t pragma_loc = UNKNOWN_LOCATION;
+      
+      // Extract the identifier to use for the generated function.
+      gw::optional_identifier     requested_name;
+      gw::decl::optional_function existing_function;
+      {
+         tree       data;
+         location_t loc;
+         auto token_type = pragma_lex(&data, &loc);
+         pragma_loc = loc;
+         if (token_type != CPP_NAME) {
+            error_at(loc, "expected an identifier naming the function to generate");
+            return;
+         }
+         requested_name = gw::identifier::wrap(data);
+         
+         auto raw = lookup_name(requested_name.unwrap());
+         if (raw != NULL_TREE) {
+            if (TREE_CODE(raw) != FUNCTION_DECL) {
+               error_at(loc, "identifier %qE already exists, and does not name a function", requested_name.unwrap());
+               return;
+            }
+            existing_function = gw::decl::function::wrap(raw);
+            if (existing_function->has_body()) {
+               error_at(loc, "identifier %qE already exists, and names a function that is already defined", requested_name.unwrap());
+               return;
+            }
+         }
+      }
+      
+      // Figure out what to-be-serialized value the user wants to read.
+      codegen::serialization_item requested_item;
+      try {
+         requested_item = helpers::parse_c_serialization_item(reader);
+      } catch (const pragma_parse_exception& ex) {
+         error_at(ex.location, ex.what());
+         return;
+      }
+      
+      // Find what sector the to-be-serialized value is in, and find its bit-offset 
+      // within that sector.
+      auto location = helpers::locate_standalone_value(requested_item, pragma_loc, this_pragma_name);
+      if (!location)
+         return;
+      
+      //
+      // We read the value into a local variable of the value's type, using a 
+      // descriptor for that variable that's otherwise a copy of the value's. 
+      // This way, the value is read with the same bitpacking options it was 
+      // saved with.
+      //
+      auto value_type = *location->type;
+      auto value_decl = gw::decl::variable("__lu_bitpack_value", value_type);
+      value_decl.make_artificial();
+      value_decl.make_used();
+      
+      auto value_desc = helpers::describe_standalone_value(requested_item, value_decl);
+      
+      //
+      // Non-array values are returned:
+      //
+      //    ValueType GetValue(const buffer_byte_type* sector);
+      //
+      // Arrays (including strings) are copied to a caller-provided destination:
+      //
+      //    void GetValue(const buffer_byte_type* sector, ElementType* destination);
+      //
+      bool is_array      = value_type.is_array();
+      auto src_type      = gs.global_options.types.buffer_byte_ptr->remove_pointer().add_const().add_pointer();
+      auto function_type = gw::type::function(
+         value_type,
+         // args:
+         src_type
+      );
+      if (is_array) {
+         function_type = gw::type::function(
+            ty.basic_void,
+            // args:
+            src_type,
+            value_type.as_array().value_type().add_pointer()
+         );
+      }
+      if (existing_function) {
+         auto type = existing_function->function_type();
+         bool good = false;
+         if (is_array) {
+            good = type.has_signature(
+               false,
+               false,
+               true,
+               ty.basic_void,
+               std::array<gw::type::base, 2>{
+                  src_type,
+                  value_type.as_array().value_type().add_pointer()
+               }
+            );
+         } else {
+            good = type.has_signature(
+               false,
+               false,
+               true,
+               value_type,
+               std::array<gw::type::base, 1>{
+                  src_type
+               }
+            );
+         }
+         if (!good) {
+            auto expected = gcc_helpers::stringify_function_signature(function_type, requested_name->name());
+            error_at(pragma_loc, "identifier %qE already exists, and names a function with the wrong signature (expected: %<%s%>)", requested_name.unwrap(), expected.c_str());
+            return;
+         }
+      }
+      
+      auto func = existing_function ? *existing_function : gw::decl::function(requested_name->name(), function_type);
+      auto result_decl = gw::decl::result(is_array ? ty.basic_void : value_type);
+      func.as_modifiable().set_result_decl(result_decl);
+      func.nth_parameter(0).make_used();
+      if (is_array)
+         func.nth_parameter(1).make_used();
+      
+      gw::expr::local_block root_block;
+      gw::statement_list    statements = root_block.statements();
+      
+      statements.append(value_decl.make_declare_expr());
+      
+      auto state_decl = gw::decl::variable("__lu_bitstream_state", *gs.global_options.types.bitstream_state);
+      state_decl.make_artificial();
+      state_decl.make_used();
+      statements.append(state_decl.make_declare_expr());
+      {  // lu_BitstreamInitialize(&state, (buffer_byte_type*)&((const uint8_t*)sector)[offset / 8]);
+         //
+         // Cast away const-ness, as when reading: we only use "read" calls 
+         // on the bitstream, so the buffer won't be modified.
+         //
+         statements.append(
+            gw::expr::call(
+               *gs.global_options.functions.stream_state_init,
+               // args:
+               state_decl.as_value().address_of(), // &state
+               codegen::sector_byte_containing(func.nth_parameter(0).as_value(), location->offset) // src
+            )
+         );
+      }
+      if (size_t bits = location->offset % 8; bits > 0) {
+         //
+         // Skip past the bits that precede the value within its first byte.
+         //
+         statements.append(
+            gw::expr::call(
+               *gs.global_options.functions.read.u8,
+               // args:
+               state_decl.as_value().address_of(),
+               gw::constant::integer(ty.uint8, bits)
+            )
+         );
+      }
+      
+      auto ctxt = codegen::instructions::utils::generation_context(result.whole_struct_functions());
+      ctxt.state_ptr = codegen::optional_value_pair(
+         state_decl.as_value().address_of(),
+         state_decl.as_value().address_of()
+      );
+      if (gs.global_options.checksums_enabled()) {
+         //
+         // Whole-struct functions take a running checksum as an argument. We 
+         // have no use for one here, so we give them a scratch variable.
+         //
+         auto checksum_decl = gw::decl::variable("__lu_bitpack_checksum", *gs.global_options.types.checksum);
+         checksum_decl.make_artificial();
+         checksum_decl.make_used();
+         checksum_decl.set_initial_value(gw::constant::integer(gs.global_options.types.checksum->as_integral(), 0));
+         statements.append(checksum_decl.make_declare_expr());
+         ctxt.checksum_ptr = codegen::optional_value_pair(
+            checksum_decl.as_value().address_of(),
+            checksum_decl.as_value().address_of()
+         );
+      }
+      
+      auto root = codegen::instructions::utils::make_instruction_tree_for(value_desc);
+      statements.append(root->generate(ctxt).read);
+      
+      if (is_array) {
+         // memcpy(destination, &value, sizeof(value));
+         statements.append(
+            gw::expr::call(
+               *gs.builtin_functions.memcpy,
+               // args:
+               func.nth_parameter(1).as_value().conversion_sans_bytecode(ty.void_ptr),
+               value_decl.as_value().address_of().conversion_sans_bytecode(ty.const_void_ptr),
+               gw::constant::integer(ty.size, value_type.size_in_bytes())
+            )
+         );
+      } else {
+         // return value;
+         statements.append(gw::expr::return_result(
+            gw::expr::assign(result_decl.as_value(), value_decl.as_value())
+         ));
+      }
+      
+      func.set_is_defined_elsewhere(false);
+      func.as_modifiable().set_root_block(root_block);
+      if (!existing_function)
+         func.introduce_to_current_scope();
+      
+      // Report status to the user.
+      inform(
+         pragma_loc,
+         "generated accessor %qE, reading from bit offset %u of sector %u",
+         requested_name.unwrap(),
+         (int)location->offset,
+         (int)location->sector_index
+      );
+   }
+}
\ No newline at end of file
@@ -1,6 +1,8 @@
+#include <algorithm> // std::max, std::min
 #include <array>
 #include <cassert>
 #include <memory> // GCC headers fuck up string-related STL identifiers that <memory> depends on
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -19,10 +21,14 @@
 
 #include "basic_global_state.h"
 #include "last_generation_result.h"
+#include "time_report.h"
 #include "codegen/debugging/print_sectored_serialization_items.h"
 #include "codegen/debugging/print_sectored_rechunked_items.h"
+#include "codegen/instructions/utils/walk.h"
 #include "codegen/instructions/base.h"
 #include "codegen/serialization_item_list_ops/divide_items_by_sectors.h"
+#include "codegen/serialization_item_list_ops/fold_sequential_array_elements.h"
+#include "codegen/serialization_item_list_ops/get_offsets_and_sizes.h"
 #include "codegen/serialization_item_list_ops/get_total_serialized_size.h"
 #include "codegen/rechunked/item.h"
 #include "codegen/rechunked/items_to_instruction_tree.h"
@@ -40,8 +46,10 @@
 #include "gcc_wrappers/environment/c/constexpr_supported.h"
 #include "gcc_wrappers/environment/c/dialect.h"
 #include "gcc_wrappers/type/base.h"
+#include "gcc_wrappers/type/array.h"
 #include "gcc_wrappers/type/function.h"
 #include "gcc_wrappers/builtin_types.h"
+#include "gcc_wrappers/constructor.h"
 namespace gw {
    using namespace gcc_wrappers;
 }
@@ -109,8 +117,161 @@ namespace pragma_handlers {
       return valid;
    }
    
-   extern void generate_functions(cpp_reader* reader) {
+   // A top-level identifier for which we generate a standalone read function.
+   struct identifier_read_target {
+      std::string name;
+      const codegen::decl_descriptor* desc = nullptr;
+      
+      // The range of sectors that the identifier's group was divided into.
+      size_t group_start = 0;
+      size_t group_end   = 0;
+   };
+   
+   static std::vector<codegen::generation_result::identifier_span> _find_identifier_spans(
+      const identifier_read_target& target,
+      const std::vector<std::vector<codegen::serialization_item>>& all_sectors_si
+   ) {
+      std::vector<codegen::generation_result::identifier_span> spans;
+      for(size_t i = target.group_start; i < target.group_end; ++i) {
+         const auto& sector = all_sectors_si[i];
+         //
+         // Within a sector, an identifier's items are contiguous, though they 
+         // may be interspersed with padding. Find the first and last items 
+         // that belong to the identifier.
+         //
+         std::optional<size_t> first;
+         size_t last = 0;
+         for(size_t j = 0; j < sector.size(); ++j) {
+            const auto& segm = sector[j].segments.front();
+            if (!segm.is_basic() || segm.as_basic().desc != target.desc)
+               continue;
+            if (!first)
+               first = j;
+            last = j;
+         }
+         if (!first)
+            continue;
+         
+         //
+         // Omitted items take up no space in the sector, so leave them out 
+         // when measuring where the identifier starts. Take offsets from the 
+         // list ops rather than summing sizes, since a union's branches all 
+         // start at the same place.
+         //
+         std::vector<codegen::serialization_item> serialized;
+         std::optional<size_t> serialized_first;
+         for(size_t j = 0; j < sector.size(); ++j) {
+            if (sector[j].is_omitted)
+               continue;
+            if (j >= *first && !serialized_first)
+               serialized_first = serialized.size();
+            serialized.push_back(sector[j]);
+         }
+         size_t offset;
+         if (serialized_first) {
+            offset = codegen::serialization_item_list_ops::get_offsets_and_sizes(serialized)[*serialized_first].first;
+         } else {
+            offset = codegen::serialization_item_list_ops::get_total_serialized_size(serialized);
+         }
+         
+         std::vector<codegen::rechunked::item> items;
+         for(size_t j = *first; j <= last; ++j)
+            items.emplace_back(sector[j]);
+         
+         spans.push_back(codegen::generation_result::identifier_span{
+            .sector_index = i,
+            .offset       = offset,
+            .instructions = codegen::rechunked::items_to_instruction_tree(items),
+         });
+      }
+      return spans;
+   }
+   
+   static void _expand_for_resumable_steps(
+      const codegen::serialization_item& item,
+      size_t step_size,
+      std::vector<codegen::serialization_item>& out
+   ) {
+      if (item.size_in_bits() > step_size && item.can_expand()) {
+         for(const auto& child : item.expanded())
+            _expand_for_resumable_steps(child, step_size, out);
+         return;
+      }
+      out.push_back(item);
+   }
+   
+   // The condition of the outermost union that an item belongs to, if any.
+   static const codegen::serialization_items::condition_type* _outermost_condition_of(const codegen::serialization_item& item) {
+      for(const auto& segm : item.segments)
+         if (segm.condition.has_value())
+            return &*segm.condition;
+      return nullptr;
+   }
    
+   static std::vector<codegen::generation_result::resumable_step> _divide_sector_into_resumable_steps(
+      const std::vector<codegen::serialization_item>& sector,
+      size_t step_size
+   ) {
+      //
+      // Expand any item too large to fit in a step, as far as it'll go, and 
+      // then pack consecutive items into steps of up to the requested size. 
+      // Items that still don't fit get steps of their own.
+      //
+      std::vector<codegen::serialization_item> items;
+      for(const auto& item : sector)
+         _expand_for_resumable_steps(item, step_size, items);
+      
+      auto offsets_and_sizes = codegen::serialization_item_list_ops::get_offsets_and_sizes(items);
+      
+      //
+      // A union's branches all start at the same offset, so we keep all of a 
+      // union's items in the same step, even if that makes the step larger 
+      // than requested. This way, each step starts where the previous one 
+      // ends, and a step's size is just the distance from its lowest start 
+      // to its highest end.
+      //
+      std::vector<std::vector<codegen::serialization_item>> step_items;
+      std::vector<std::pair<size_t, size_t>> step_bounds; // [start, end) in bits
+      for(size_t i = 0; i < items.size(); ++i) {
+         auto [offset, size] = offsets_and_sizes[i];
+         
+         bool same_union = false;
+         if (i > 0) {
+            auto* prev = _outermost_condition_of(items[i - 1]);
+            auto* curr = _outermost_condition_of(items[i]);
+            same_union = prev && curr && prev->lhs == curr->lhs;
+         }
+         if (step_items.empty() || (!same_union && offset + size > step_bounds.back().first + step_size)) {
+            step_items.emplace_back();
+            step_bounds.push_back({ offset, offset });
+         }
+         step_items.back().push_back(items[i]);
+         
+         auto& bounds = step_bounds.back();
+         bounds.first  = (std::min)(bounds.first, offset);
+         bounds.second = (std::max)(bounds.second, offset + size);
+      }
+      
+      std::vector<codegen::generation_result::resumable_step> steps;
+      for(size_t i = 0; i < step_items.size(); ++i) {
+         auto& list = step_items[i];
+         codegen::serialization_item_list_ops::fold_sequential_array_elements(list);
+         
+         std::vector<codegen::rechunked::item> ri;
+         for(const auto& item : list)
+            ri.emplace_back(item);
+         
+         steps.push_back(codegen::generation_result::resumable_step{
+            .size         = step_bounds[i].second - step_bounds[i].first,
+            .instructions = codegen::rechunked::items_to_instruction_tree(ri),
+         });
+      }
+      return steps;
+   }
+   
+   extern void generate_functions(cpp_reader* reader) {
+      time_report::scoped_invocation timing;
+      
       // force-create the singleton now, so other code can safely use `get_fast` 
       // to access it.
       gw::builtin_types::get();
@@ -189,6 +350,42 @@ namespace pragma_handlers {
                has_builtins = false;
             }
          }
+         if (request.settings.generate_dirty_checks) {
+            if (!_check_and_report_missing_builtin(request.start_location, gs.builtin_functions.memcmp, "memcmp", "<string.h>")) {
+               has_builtins = false;
+            } else {
+               const auto& ty = gw::builtin_types::get_fast();
+               if (!_check_and_report_builtin_signature(
+                  request.start_location,
+                  *gs.builtin_functions.memcmp,
+                  ty.basic_int,
+                  std::array<gw::type::base, 3>{
+                     ty.const_void_ptr,
+                     ty.const_void_ptr,
+                     ty.size
+                  }
+               )) {
+                  has_builtins = false;
+               }
+            }
+            if (!_check_and_report_missing_builtin(request.start_location, gs.builtin_functions.strncmp, "strncmp", "<string.h>")) {
+               has_builtins = false;
+            } else {
+               const auto& ty = gw::builtin_types::get_fast();
+               if (!_check_and_report_builtin_signature(
+                  request.start_location,
+                  *gs.builtin_functions.strncmp,
+                  ty.basic_int,
+                  std::array<gw::type::base, 3>{
+                     ty.const_char_ptr,
+                     ty.const_char_ptr,
+                     ty.size
+                  }
+               )) {
+                  has_builtins = false;
+               }
+            }
+         }
       }
       
       if (bad_generated_function_names || !identifiers_valid || !has_builtins) {
@@ -203,12 +400,28 @@ namespace pragma_handlers {
       // split items into and across sectors as appropriate.
       //
       std::vector<std::vector<codegen::serialization_item>> all_sectors_si;
+      std::vector<identifier_read_target> identifier_read_targets;
       {
-         size_t sector_size_in_bits = gs.global_options.sectors.bytes_per * 8;
+         //
+         // Each identifier group starts a new sector, so the sizes of the sectors 
+         // a group can use depend on where that group starts.
+         //
+         auto sector_sizes_in_bits_from = [&gs](size_t first) {
+            std::vector<size_t> out;
+            const auto& sizes = gs.global_options.sectors.sizes;
+            for(size_t i = first; i < sizes.size(); ++i)
+               out.push_back(sizes[i] * 8);
+            if (out.empty())
+               out.push_back(gs.global_options.sectors.bytes_per * 8);
+            return out;
+         };
          
          for(auto& group : request.identifier_groups) {
             std::vector<codegen::serialization_item> items;
+            size_t group_start = all_sectors_si.size();
             for(auto& entry : group) {
+               time_report::scoped_phase phase_timing(time_report::phase::describe);
+               
                auto id   = entry.id;
                auto decl = gw::decl::variable::wrap(lookup_name(id.unwrap()));
                
@@ -230,11 +443,31 @@ namespace pragma_handlers {
             }
             
             {
-               auto these_sectors = codegen::serialization_item_list_ops::divide_items_by_sectors(sector_size_in_bits, items);
+               time_report::scoped_phase phase_timing(time_report::phase::divide);
+               
+               auto these_sectors = codegen::serialization_item_list_ops::divide_items_by_sectors(
+                  sector_sizes_in_bits_from(group_start),
+                  items,
+                  codegen::serialization_item_list_ops::division_options{
+                     .split_scalars = request.settings.split_scalars_across_sectors,
+                     .split_buffers = request.settings.split_buffers_across_sectors,
+                     .split_unions  = request.settings.split_unions_across_sectors,
+                  }
+               );
                for(size_t i = 0; i < these_sectors.size(); ++i) {
                   all_sectors_si.push_back(std::move(these_sectors[i]));
                }
             }
+            if (request.settings.generate_identifier_reads) {
+               for(size_t i = 0; i < group.size(); ++i) {
+                  identifier_read_targets.push_back(identifier_read_target{
+                     .name        = std::string(group[i].id.name()),
+                     .desc        = items[i].segments.front().as_basic().desc,
+                     .group_start = group_start,
+                     .group_end   = all_sectors_si.size(),
+                  });
+               }
+            }
             //
             // Verify that we fit under the sector count limit; if we don't, 
             // report the problem to the user, show any pending debug output, 
@@ -295,22 +528,42 @@ namespace pragma_handlers {
       // Convert serialization items to rechunked items.
       //
       std::vector<std::vector<codegen::rechunked::item>> all_sectors_ri;
-      for(const auto& sector : all_sectors_si) {
-         auto& dst = all_sectors_ri.emplace_back();
-         for(const auto& item : sector) {
-            dst.emplace_back(item);
+      std::vector<std::unique_ptr<codegen::instructions::base>> instructions_by_sector;
+      std::vector<std::unique_ptr<codegen::instructions::base>> dirty_check_instructions_by_sector;
+      {
+         time_report::scoped_phase phase_timing(time_report::phase::rechunk);
+         
+         for(const auto& sector : all_sectors_si) {
+            auto& dst = all_sectors_ri.emplace_back();
+            for(const auto& item : sector) {
+               dst.emplace_back(item);
+            }
+         }
+         if (request.settings.enable_debug_output) {
+            codegen::debugging::print_sectored_rechunked_items(all_sectors_ri);
+         }
+         //
+         // Generate node trees.
+         //
+         for(const auto& sector : all_sectors_ri) {
+            auto node_ptr = codegen::rechunked::items_to_instruction_tree(sector);
+            instructions_by_sector.push_back(std::move(node_ptr));
+         }
+         //
+         // Dirty checks need their own node trees: nodes own some of the 
+         // VAR_DECLs that their generated code uses, and a VAR_DECL can't be 
+         // shared between functions.
+         //
+         if (request.settings.generate_dirty_checks) {
+            for(const auto& sector : all_sectors_ri) {
+               auto node_ptr = codegen::rechunked::items_to_instruction_tree(sector);
+               dirty_check_instructions_by_sector.push_back(std::move(node_ptr));
+            }
          }
       }
-      if (request.settings.enable_debug_output) {
-         codegen::debugging::print_sectored_rechunked_items(all_sectors_ri);
-      }
-      //
-      // Generate node trees.
-      //
-      std::vector<std::unique_ptr<codegen::instructions::base>> instructions_by_sector;
-      for(const auto& sector : all_sectors_ri) {
-         auto node_ptr = codegen::rechunked::items_to_instruction_tree(sector);
-         instructions_by_sector.push_back(std::move(node_ptr));
+      
+      if (size_t first = request.settings.sectors.first; first > 0 && first >= instructions_by_sector.size()) {
+         warning_at(request.start_location, 0, "%<#pragma lu_bitpack generate_functions%>: the data only spans %u sectors, so no per-sector functions will be defined for the requested range (starting at sector %u)", (int)instructions_by_sector.size(), (int)first);
       }
       
       //
@@ -318,10 +571,75 @@ namespace pragma_handlers {
       //
       
       codegen::generation_result result;
-      if (!result.generate(request, instructions_by_sector))
-         return;
+      {
+         time_report::scoped_phase phase_timing(time_report::phase::generate);
+         if (!result.generate(request, instructions_by_sector))
+            return;
+         if (request.settings.generate_dirty_checks)
+            result.generate_dirty_checks(dirty_check_instructions_by_sector);
+         for(const auto& target : identifier_read_targets)
+            result.generate_identifier_read(target.name, _find_identifier_spans(target, all_sectors_si));
+         if (size_t step_size = request.settings.resumable_step_size; step_size > 0) {
+            std::vector<std::vector<codegen::generation_result::resumable_step>> steps_by_sector;
+            for(const auto& sector : all_sectors_si)
+               steps_by_sector.push_back(_divide_sector_into_resumable_steps(sector, step_size));
+            result.generate_resumable_steps(steps_by_sector);
+         }
+      }
+      
+      if (auto& report = time_report::get(); report.enabled) {
+         auto& counts = report.counts;
+         for(const auto& sector : all_sectors_si)
+            counts.serialization_items += sector.size();
+         for(const auto& sector : all_sectors_ri)
+            for(const auto& item : sector)
+               counts.rechunked_chunks += item.chunks.size();
+         
+         auto _count_nodes = [&counts](const codegen::instructions::base& node) {
+            ++counts.instruction_nodes;
+         };
+         for(const auto& node_ptr : instructions_by_sector)
+            codegen::instructions::utils::walk(_count_nodes, *node_ptr);
+         
+         auto _count_trees = [&counts](const codegen::func_pair& pair) {
+            counts.tree_nodes += time_report::count_tree_nodes_in_function(pair.read);
+            counts.tree_nodes += time_report::count_tree_nodes_in_function(pair.save);
+         };
+         for(const auto& pair : result.per_sector)
+            _count_trees(pair);
+         for(const auto& pair : result.per_sector_parts)
+            _count_trees(pair);
+         if (result.top_level.read)
+            counts.tree_nodes += time_report::count_tree_nodes_in_function(*result.top_level.read);
+         if (result.top_level.save)
+            counts.tree_nodes += time_report::count_tree_nodes_in_function(*result.top_level.save);
+         for(const auto& func : result.dirty_check_per_sector)
+            counts.tree_nodes += time_report::count_tree_nodes_in_function(func);
+         for(const auto& func : result.per_identifier_read)
+            counts.tree_nodes += time_report::count_tree_nodes_in_function(func);
+         for(const auto& pair : result.step_per_sector)
+            _count_trees(pair);
+         if (result.table_interpreter.read)
+            _count_trees(result.table_interpreter);
+         result.whole_struct.for_each([&](gw::type::base type, const codegen::whole_struct_function_info& info) {
+            if (info.instructions_root)
+               codegen::instructions::utils::walk(_count_nodes, *info.instructions_root);
+            if (info.functions.read)
+               counts.tree_nodes += time_report::count_tree_nodes_in_function(*info.functions.read);
+            if (info.functions.save)
+               counts.tree_nodes += time_report::count_tree_nodes_in_function(*info.functions.save);
+            if (info.dirty_check.function)
+               counts.tree_nodes += time_report::count_tree_nodes_in_function(*info.dirty_check.function);
+         });
+      }
       
       inform(UNKNOWN_LOCATION, "generated the serialization functions");
+      if (!request.settings.emit_shared) {
+         inform(UNKNOWN_LOCATION, "shared functions (whole-struct functions, and the requested read and save functions) were only declared, and must be defined by another translation unit");
+      }
+      if (request.settings.mode != codegen::generation_request::codegen_mode::code) {
+         inform(UNKNOWN_LOCATION, "encoded %u of %u sectors as tables", (int)result.table_sectors.size(), (int)instructions_by_sector.size());
+      }
       {  // Define file-scoped variables.
          size_t count    = gs.global_options.sectors.max_count;
          size_t max_size = gs.global_options.sectors.bytes_per;
@@ -332,40 +650,54 @@ namespace pragma_handlers {
             }
          }
          
-         const auto& ty = gw::builtin_types::get_fast();
-         auto const_size_type = ty.size.add_const();
-         {  // __lu_bitpack_sector_count
-            gw::decl::variable var("__lu_bitpack_sector_count", const_size_type);
+         //
+         // These variables are public, so that other translation units can use 
+         // them. When a layout's code is split across translation units, only 
+         // the one that emits the shared functions defines them; the rest just 
+         // declare them, so that they don't collide at link time.
+         //
+         bool define = request.settings.emit_shared;
+         auto _make_public = [define](gw::decl::variable& var, gw::value initial_value, bool allow_constexpr) {
             var.make_artificial();
-            var.set_initial_value(gw::constant::integer(ty.size, count));
+            if (define)
+               var.set_initial_value(initial_value);
             var.make_read_only();
             var.make_file_scope_extern();
-            var.set_is_defined_elsewhere(false);
+            var.set_is_defined_elsewhere(!define);
+            if (!define || !allow_constexpr)
+               return;
             if constexpr (gw::environment::c::constexpr_supported) {
                if (gw::environment::c::current_dialect() >= gw::environment::c::dialect::c23) {
                   var.make_declared_constexpr();
                }
             }
+         };
+         
+         const auto& ty = gw::builtin_types::get_fast();
+         auto const_size_type = ty.size.add_const();
+         {  // __lu_bitpack_sector_count
+            gw::decl::variable var("__lu_bitpack_sector_count", const_size_type);
+            _make_public(var, gw::constant::integer(ty.size, count), true);
          }
          {  // __lu_bitpack_max_sector_size
             gw::decl::variable var("__lu_bitpack_max_sector_size", const_size_type);
-            var.make_artificial();
-            var.set_initial_value(gw::constant::integer(ty.size, max_size));
-            var.make_read_only();
-            var.make_file_scope_extern();
-            var.set_is_defined_elsewhere(false);
-            if constexpr (gw::environment::c::constexpr_supported) {
-               if (gw::environment::c::current_dialect() >= gw::environment::c::dialect::c23) {
-                  var.make_declared_constexpr();
-               }
-            }
+            _make_public(var, gw::constant::integer(ty.size, max_size), true);
+         }
+         if (!gs.global_options.sectors.sizes.empty()) {  // __lu_bitpack_sector_sizes
+            auto array_type = const_size_type.add_array_extent(count);
+            
+            std::vector<gw::value> elements;
+            for(size_t i = 0; i < count; ++i)
+               elements.push_back(gw::constant::integer(ty.size, gs.global_options.sector_size(i)));
+            
+            gw::decl::variable var("__lu_bitpack_sector_sizes", array_type);
+            _make_public(var, gw::constructor(array_type, elements), false);
+         }
+         if (define) {
+            inform(UNKNOWN_LOCATION, "generated built-in variables (%<__lu_bitpack_sector_count%> and friends)");
+         } else {
+            inform(UNKNOWN_LOCATION, "declared built-in variables (%<__lu_bitpack_sector_count%> and friends), which must be defined by another translation unit");
          }
-         inform(UNKNOWN_LOCATION, "generated built-in variables (%<__lu_bitpack_sector_count%> and friends)");
-      }
-      
-      {
-         auto& dst = last_generation_result::get();
-         dst.update(all_sectors_si);
       }
       
       //
@@ -374,6 +706,8 @@ namespace pragma_handlers {
       if (!gs.xml_output_path.empty()) {
          const auto& path = gs.xml_output_path;
          if (path.ends_with(".xml")) {
+            time_report::scoped_phase phase_timing(time_report::phase::stats_and_xml);
+            
             codegen::stats_gatherer stats;
             stats.gather_from_sectors(all_sectors_si);
             
@@ -389,5 +723,10 @@ namespace pragma_handlers {
             stream << xml_gen.bake();
          }
       }
+      
+      {
+         auto& dst = last_generation_result::get();
+         dst.update(all_sectors_si, std::move(result.whole_struct));
+      }
    }
 }
\ No newline at end of file
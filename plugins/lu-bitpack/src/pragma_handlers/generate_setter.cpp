@@ -0,0 +1,287 @@
+#include "pragma_handlers/generate_setter.h"
+#include <array>
+#include <memory> // GCC headers fuck up string-related STL identifiers that <memory> depends on
+#include "gcc_wrappers/constant/integer.h"
+#include "gcc_wrappers/decl/function.h"
+#include "gcc_wrappers/decl/result.h"
+#include "gcc_wrappers/decl/variable.h"
+#include "gcc_wrappers/expr/assign.h"
+#include "gcc_wrappers/expr/call.h"
+#include "gcc_wrappers/expr/local_block.h"
+#include "gcc_wrappers/type/function.h"
+#include "gcc_wrappers/builtin_types.h"
+#include "gcc_wrappers/identifier.h"
+#include "gcc_wrappers/statement_list.h"
+#include "gcc_wrappers/value.h"
+#include "gcc_helpers/stringify_function_signature.h"
+#include "basic_global_state.h"
+#include "codegen/instructions/utils/generation_context.h"
+#include "codegen/instructions/base.h"
+#include "codegen/optional_value_pair.h"
+#include "codegen/sector_byte_containing.h"
+#include "codegen/serialization_item.h"
+#include "last_generation_result.h"
+#include "pragma_parse_exception.h"
+#include "pragma_handlers/helpers/parse_c_serialization_item.h"
+#include "pragma_handlers/helpers/standalone_value.h"
+#include <c-family/c-common.h> // lookup_name
+#include <diagnostic.h>
+namespace gw {
+   using namespace gcc_wrappers;
+}
+
+namespace pragma_handlers {
+   extern void generate_setter(cpp_reader* reader) {
+      constexpr const char* this_pragma_name = "#pragma lu_bitpack generate_setter";
+      
+      auto& result = last_generation_result::get();
+      if (result.empty()) {
+         error("%s: no code has been generated yet", this_pragma_name);
+         return;
+      }
+      
+      const auto& gs = basic_global_state::get();
+      const auto& ty = gw::builtin_types::get();
+      
+      location_t pragma_loc = UNKNOWN_LOCATION;
+      
+      // Extract the identifier to use for the generated function.
+      gw::optional_identifier     requested_name;
+      gw::decl::optional_function existing_function;
+      {
+         tree       data;
+         location_t loc;
+         auto token_type = pragma_lex(&data, &loc);
+         pragma_loc = loc;
+         if (token_type != CPP_NAME) {
+            error_at(loc, "expected an identifier naming the function to generate");
+            return;
+         }
+         requested_name = gw::identifier::wrap(data);
+         
+         auto raw = lookup_name(requested_name.unwrap());
+         if (raw != NULL_TREE) {
+            if (TREE_CODE(raw) != FUNCTION_DECL) {
+               error_at(loc, "identifier %qE already exists, and does not name a function", requested_name.unwrap());
+               return;
+            }
+            existing_function = gw::decl::function::wrap(raw);
+            if (existing_function->has_body()) {
+               error_at(loc, "identifier %qE already exists, and names a function that is already defined", requested_name.unwrap());
+               return;
+            }
+         }
+      }
+      
+      // Figure out what to-be-serialized value the user wants to write.
+      codegen::serialization_item requested_item;
+      try {
+         requested_item = helpers::parse_c_serialization_item(reader);
+      } catch (const pragma_parse_exception& ex) {
+         error_at(ex.location, ex.what());
+         return;
+      }
+      
+      // Find what sector the to-be-serialized value is in, and find its bit-offset 
+      // within that sector.
+      auto location = helpers::locate_standalone_value(requested_item, pragma_loc, this_pragma_name);
+      if (!location)
+         return;
+      
+      //
+      // We copy the new value into a local variable of the value's type, and 
+      // write it using a descriptor for that variable that's otherwise a copy 
+      // of the value's. This way, the value is written with the same bitpacking 
+      // options that `generate_functions` uses.
+      //
+      auto value_type = *location->type;
+      auto value_decl = gw::decl::variable("__lu_bitpack_value", value_type);
+      value_decl.make_artificial();
+      value_decl.make_used();
+      
+      auto value_desc = helpers::describe_standalone_value(requested_item, value_decl);
+      
+      //
+      // Non-array values are passed by value:
+      //
+      //    void SetValue(buffer_byte_type* sector, ValueType value);
+      //
+      // Arrays (including strings) are passed by pointer:
+      //
+      //    void SetValue(buffer_byte_type* sector, const ElementType* value);
+      //
+      bool is_array       = value_type.is_array();
+      auto dst_type       = *gs.global_options.types.buffer_byte_ptr;
+      auto value_arg_type = value_type;
+      if (is_array)
+         value_arg_type = value_type.as_array().value_type().add_const().add_pointer();
+      auto function_type = gw::type::function(
+         ty.basic_void,
+         // args:
+         dst_type,
+         value_arg_type
+      );
+      if (existing_function) {
+         auto type = existing_function->function_type();
+         bool good = type.has_signature(
+            false,
+            false,
+            true,
+            ty.basic_void,
+            std::array<gw::type::base, 2>{
+               dst_type,
+               value_arg_type
+            }
+         );
+         if (!good) {
+            auto expected = gcc_helpers::stringify_function_signature(function_type, requested_name->name());
+            error_at(pragma_loc, "identifier %qE already exists, and names a function with the wrong signature (expected: %<%s%>)", requested_name.unwrap(), expected.c_str());
+            return;
+         }
+      }
+      
+      auto func = existing_function ? *existing_function : gw::decl::function(requested_name->name(), function_type);
+      func.as_modifiable().set_result_decl(gw::decl::result(ty.basic_void));
+      func.nth_parameter(0).make_used();
+      func.nth_parameter(1).make_used();
+      
+      gw::expr::local_block root_block;
+      gw::statement_list    statements = root_block.statements();
+      
+      statements.append(value_decl.make_declare_expr());
+      if (is_array) {
+         // memcpy(&value, value_arg, sizeof(value));
+         statements.append(
+            gw::expr::call(
+               *gs.builtin_functions.memcpy,
+               // args:
+               value_decl.as_value().address_of().conversion_sans_bytecode(ty.void_ptr),
+               func.nth_parameter(1).as_value().conversion_sans_bytecode(ty.const_void_ptr),
+               gw::constant::integer(ty.size, value_type.size_in_bytes())
+            )
+         );
+      } else {
+         // value = value_arg;
+         statements.append(gw::expr::assign(value_decl.as_value(), func.nth_parameter(1).as_value()));
+      }
+      
+      //
+      // Bitstream writes aren't guaranteed to preserve the other bits in the 
+      // bytes they touch: a write may overwrite the rest of its first byte. 
+      // So, we read the bits that share the value's first and last bytes, and 
+      // then write them back along with the value.
+      //
+      //    u8 prefix = read_u8(&reader, start % 8);
+      //    u8 suffix = read_u8(&reader, (8 - end % 8) % 8); // after skipping to `end`
+      //
+      //    write_u8(&writer, prefix, start % 8);
+      //    // write value
+      //    write_u8(&writer, suffix, (8 - end % 8) % 8);
+      //
+      size_t start_bit   = location->offset;
+      size_t end_bit     = location->offset + location->size;
+      size_t prefix_size = start_bit % 8;
+      size_t suffix_size = (8 - end_bit % 8) % 8;
+      
+      auto _make_state = [&gs, &statements, &func](lu::strings::zview name, size_t bit_offset) {
+         auto decl = gw::decl::variable(name, *gs.global_options.types.bitstream_state);
+         decl.make_artificial();
+         decl.make_used();
+         statements.append(decl.make_declare_expr());
+         statements.append(
+            gw::expr::call(
+               *gs.global_options.functions.stream_state_init,
+               // args:
+               decl.as_value().address_of(), // &state
+               codegen::sector_byte_containing(func.nth_parameter(0).as_value(), bit_offset) // dst
+            )
+         );
+         return decl;
+      };
+      auto _read_bits = [&gs, &ty](gw::decl::variable state, size_t bitcount) {
+         return gw::expr::call(
+            *gs.global_options.functions.read.u8,
+            // args:
+            state.as_value().address_of(),
+            gw::constant::integer(ty.uint8, bitcount)
+         );
+      };
+      auto _write_bits = [&gs, &ty](gw::decl::variable state, gw::value bits, size_t bitcount) {
+         return gw::expr::call(
+            *gs.global_options.functions.save.u8,
+            // args:
+            state.as_value().address_of(),
+            bits,
+            gw::constant::integer(ty.uint8, bitcount)
+         );
+      };
+      
+      gw::decl::optional_variable prefix_decl;
+      gw::decl::optional_variable suffix_decl;
+      if (prefix_size > 0) {
+         auto state = _make_state("__lu_bitstream_state_prefix", start_bit);
+         
+         prefix_decl = gw::decl::variable("__lu_bitpack_prefix", ty.uint8);
+         prefix_decl->make_artificial();
+         prefix_decl->make_used();
+         statements.append(prefix_decl->make_declare_expr());
+         statements.append(gw::expr::assign(prefix_decl->as_value(), _read_bits(state, prefix_size)));
+      }
+      if (suffix_size > 0) {
+         auto state = _make_state("__lu_bitstream_state_suffix", end_bit);
+         statements.append(_read_bits(state, end_bit % 8));
+         
+         suffix_decl = gw::decl::variable("__lu_bitpack_suffix", ty.uint8);
+         suffix_decl->make_artificial();
+         suffix_decl->make_used();
+         statements.append(suffix_decl->make_declare_expr());
+         statements.append(gw::expr::assign(suffix_decl->as_value(), _read_bits(state, suffix_size)));
+      }
+      
+      auto state_decl = _make_state("__lu_bitstream_state", start_bit);
+      if (prefix_decl)
+         statements.append(_write_bits(state_decl, prefix_decl->as_value(), prefix_size));
+      
+      auto ctxt = codegen::instructions::utils::generation_context(result.whole_struct_functions());
+      ctxt.state_ptr = codegen::optional_value_pair(
+         state_decl.as_value().address_of(),
+         state_decl.as_value().address_of()
+      );
+      if (gs.global_options.checksums_enabled()) {
+         //
+         // Whole-struct functions take a running checksum as an argument. We 
+         // have no use for one here, so we give them a scratch variable.
+         //
+         auto checksum_decl = gw::decl::variable("__lu_bitpack_checksum", *gs.global_options.types.checksum);
+         checksum_decl.make_artificial();
+         checksum_decl.make_used();
+         checksum_decl.set_initial_value(gw::constant::integer(gs.global_options.types.checksum->as_integral(), 0));
+         statements.append(checksum_decl.make_declare_expr());
+         ctxt.checksum_ptr = codegen::optional_value_pair(
+            checksum_decl.as_value().address_of(),
+            checksum_decl.as_value().address_of()
+         );
+      }
+      
+      auto root = codegen::instructions::utils::make_instruction_tree_for(value_desc);
+      statements.append(root->generate(ctxt).save);
+      
+      if (suffix_decl)
+         statements.append(_write_bits(state_decl, suffix_decl->as_value(), suffix_size));
+      
+      func.set_is_defined_elsewhere(false);
+      func.as_modifiable().set_root_block(root_block);
+      if (!existing_function)
+         func.introduce_to_current_scope();
+      
+      // Report status to the user.
+      inform(
+         pragma_loc,
+         "generated setter %qE, writing %u bits at bit offset %u of sector %u",
+         requested_name.unwrap(),
+         (int)location->size,
+         (int)location->offset,
+         (int)location->sector_index
+      );
+   }
+}
\ No newline at end of file
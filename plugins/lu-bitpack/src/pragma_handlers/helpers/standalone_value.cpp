@@ -0,0 +1,97 @@
+#include "pragma_handlers/helpers/standalone_value.h"
+#include <cassert>
+#include "gcc_wrappers/type/array.h"
+#include "last_generation_result.h"
+#include <diagnostic.h>
+namespace gw {
+   using namespace gcc_wrappers;
+}
+namespace typed_options {
+   using namespace bitpacking::typed_data_options::computed;
+}
+
+namespace pragma_handlers::helpers {
+   extern std::optional<standalone_value> locate_standalone_value(
+      const codegen::serialization_item& requested_item,
+      location_t  pragma_loc,
+      const char* pragma_name
+   ) {
+      auto& result = last_generation_result::get();
+      
+      auto sector_index = result.find_containing_sector(requested_item);
+      auto offset       = result.find_offset_within_sector(requested_item);
+      if (!sector_index.has_value() || !offset.has_value()) {
+         error_at(pragma_loc, "%qs: the requested value does not appear to be present in the bitstream", pragma_name);
+         return {};
+      }
+      
+      //
+      // The value must lie entirely within one sector, and must always be 
+      // present there.
+      //
+      for(size_t i = 0; i < result.sector_count(); ++i) {
+         for(const auto& item : result.get_expanded_sector_items(i)) {
+            if (!item.is_whole_or_part(requested_item))
+               continue;
+            if (i != *sector_index) {
+               error_at(pragma_loc, "%qs: the requested value is split across sectors %u and %u; request each of its parts instead", pragma_name, (int)*sector_index, (int)i);
+               return {};
+            }
+            for(const auto& segm : item.segments) {
+               if (segm.condition.has_value()) {
+                  error_at(pragma_loc, "%qs: the requested value is (or is within) a member of a tagged union, and so is only present depending on that union%'s tag", pragma_name);
+                  return {};
+               }
+            }
+         }
+      }
+      
+      const auto& segm  = requested_item.segments.back().as_basic();
+      const auto& desc  = *segm.desc;
+      size_t      depth = segm.array_accesses.size();
+      if (depth > desc.array.extents.size()) {
+         if (desc.options.is<typed_options::delta>()) {
+            error_at(pragma_loc, "%qs: the requested value is an element of a delta-encoded array, which is only serialized relative to the elements before it; request the whole array instead", pragma_name);
+         } else {
+            error_at(pragma_loc, "%qs: the requested value is part of a string; request the whole string instead", pragma_name);
+         }
+         return {};
+      }
+      if (desc.options.is<typed_options::tagged_union>()) {
+         if (!desc.options.as<typed_options::tagged_union>().is_internal) {
+            error_at(pragma_loc, "%qs: the requested value is an externally tagged union, whose tag is serialized separately from it; request the value that contains both instead", pragma_name);
+            return {};
+         }
+      }
+      
+      gw::type::base type = desc.types.basic_type;
+      for(size_t i = 0; i < depth; ++i)
+         type = type.as_array().value_type();
+      
+      return standalone_value{
+         .sector_index = *sector_index,
+         .offset       = *offset,
+         .size         = requested_item.size_in_bits(),
+         .type         = type,
+      };
+   }
+   
+   extern codegen::decl_descriptor describe_standalone_value(
+      const codegen::serialization_item& requested_item,
+      gw::decl::variable local
+   ) {
+      const auto& segm  = requested_item.segments.back().as_basic();
+      size_t      depth = segm.array_accesses.size();
+      
+      codegen::decl_descriptor desc = *segm.desc;
+      assert(depth <= desc.array.extents.size());
+      desc.decl             = local;
+      desc.types.basic_type = local.value_type();
+      desc.array.extents.erase(
+         desc.array.extents.begin(),
+         desc.array.extents.begin() + depth
+      );
+      desc.variable.dereference_count = 0;
+      return desc;
+   }
+}
\ No newline at end of file
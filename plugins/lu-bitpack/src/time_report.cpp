@@ -0,0 +1,200 @@
+#include "time_report.h"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <sys/resource.h> // getrusage
+#include "lu/stringf.h"
+#include <tree.h>
+#include <timevar.h>
+#include <diagnostic.h>
+namespace gw {
+   using namespace gcc_wrappers;
+}
+
+namespace {
+   // GCC's `-ftime-report` keys client items by name, so these must be stable
+   // for the lifetime of the process.
+   constexpr const char* timevar_name_for_invocation = "lu_bitpack: generate_functions";
+   constexpr const char* timevar_names_for_phases[time_report::phase_count] = {
+      "lu_bitpack: describe and check",
+      "lu_bitpack: divide items by sectors",
+      "lu_bitpack: rechunk and build instructions",
+      "lu_bitpack: generate sector functions",
+      "lu_bitpack: generate whole-struct functions",
+      "lu_bitpack: stats and XML",
+   };
+   
+   double _to_ms(time_report::clock::duration d) {
+      return std::chrono::duration<double, std::milli>(d).count();
+   }
+}
+
+//
+// scoped_invocation
+//
+
+time_report::scoped_invocation::scoped_invocation() {
+   if (g_timer)
+      g_timer->push_client_item(timevar_name_for_invocation);
+   auto& report = time_report::get();
+   if (report.enabled)
+      ++report.invocations;
+}
+time_report::scoped_invocation::~scoped_invocation() {
+   if (g_timer)
+      g_timer->pop_client_item();
+}
+
+//
+// scoped_phase
+//
+
+time_report::scoped_phase::scoped_phase(phase p) {
+   if (g_timer)
+      g_timer->push_client_item(timevar_names_for_phases[(size_t)p]);
+   auto& report = time_report::get();
+   if (report.enabled) {
+      this->_timed = true;
+      report._push(p);
+   }
+}
+time_report::scoped_phase::~scoped_phase() {
+   if (this->_timed)
+      time_report::get_fast()._pop();
+   if (g_timer)
+      g_timer->pop_client_item();
+}
+
+//
+// time_report
+//
+
+void time_report::_push(phase p) {
+   auto now = clock::now();
+   if (!this->_stack.empty()) {
+      //
+      // Pause the outer phase.
+      //
+      auto& outer = this->_stack.back();
+      this->phases[(size_t)outer.id].elapsed += now - outer.resumed_at;
+   }
+   this->_stack.push_back(active_phase{
+      .id         = p,
+      .resumed_at = now,
+   });
+   ++this->phases[(size_t)p].entered;
+}
+void time_report::_pop() {
+   assert(!this->_stack.empty());
+   auto now   = clock::now();
+   auto inner = this->_stack.back();
+   this->phases[(size_t)inner.id].elapsed += now - inner.resumed_at;
+   this->_stack.pop_back();
+   if (!this->_stack.empty()) {
+      //
+      // Resume the outer phase.
+      //
+      this->_stack.back().resumed_at = now;
+   }
+}
+
+/*static*/ const char* time_report::name_of(phase p) {
+   switch (p) {
+      case phase::describe:      return "describe";
+      case phase::divide:        return "divide_items_by_sectors";
+      case phase::rechunk:       return "rechunk";
+      case phase::generate:      return "generate";
+      case phase::whole_struct:  return "whole_struct";
+      case phase::stats_and_xml: return "stats_and_xml";
+   }
+   return "unknown";
+}
+
+/*static*/ size_t time_report::count_tree_nodes_in_function(gw::decl::function func) {
+   tree body = DECL_SAVED_TREE(func.unwrap());
+   if (body == NULL_TREE)
+      return 0;
+   size_t count = 0;
+   walk_tree_without_duplicates(
+      &body,
+      [](tree* node, int* walk_subtrees, void* data) -> tree {
+         ++*(size_t*)data;
+         return NULL_TREE;
+      },
+      &count
+   );
+   return count;
+}
+
+/*static*/ size_t time_report::peak_rss_kib() {
+   struct rusage usage;
+   if (getrusage(RUSAGE_SELF, &usage) != 0)
+      return 0;
+   return usage.ru_maxrss; // KiB on Linux
+}
+
+std::string time_report::to_json() const {
+   std::string out = "{\n";
+   out += lu::stringf("   \"invocations\": %u,\n", (int)this->invocations);
+   out += "   \"phases\": {\n";
+   for(size_t i = 0; i < phase_count; ++i) {
+      const auto& info = this->phases[i];
+      out += lu::stringf(
+         "      \"%s\": { \"ms\": %.3f, \"entered\": %u }%s\n",
+         name_of((phase)i),
+         _to_ms(info.elapsed),
+         (int)info.entered,
+         i + 1 < phase_count ? "," : ""
+      );
+   }
+   out += "   },\n";
+   out += "   \"counts\": {\n";
+   out += lu::stringf("      \"serialization_items\": %u,\n", (int)this->counts.serialization_items);
+   out += lu::stringf("      \"rechunked_chunks\": %u,\n",    (int)this->counts.rechunked_chunks);
+   out += lu::stringf("      \"instruction_nodes\": %u,\n",   (int)this->counts.instruction_nodes);
+   out += lu::stringf("      \"tree_nodes\": %u\n",           (int)this->counts.tree_nodes);
+   out += "   },\n";
+   out += lu::stringf("   \"peak_rss_kib\": %u\n", (int)peak_rss_kib());
+   out += "}\n";
+   return out;
+}
+
+std::string time_report::to_text() const {
+   std::string out = lu::stringf("lu_bitpack time report (%u invocation(s) of generate_functions):\n", (int)this->invocations);
+   clock::duration total = clock::duration::zero();
+   for(size_t i = 0; i < phase_count; ++i) {
+      const auto& info = this->phases[i];
+      total += info.elapsed;
+      out += lu::stringf(
+         "   %-24s %10.3f ms  (%u)\n",
+         name_of((phase)i),
+         _to_ms(info.elapsed),
+         (int)info.entered
+      );
+   }
+   out += lu::stringf("   %-24s %10.3f ms\n", "TOTAL", _to_ms(total));
+   out += lu::stringf("   serialization items:     %u\n", (int)this->counts.serialization_items);
+   out += lu::stringf("   rechunked chunks:        %u\n", (int)this->counts.rechunked_chunks);
+   out += lu::stringf("   instruction nodes:       %u\n", (int)this->counts.instruction_nodes);
+   out += lu::stringf("   tree nodes:              %u\n", (int)this->counts.tree_nodes);
+   out += lu::stringf("   peak RSS:                %u KiB\n", (int)peak_rss_kib());
+   return out;
+}
+
+void time_report::emit() {
+   if (!this->enabled)
+      return;
+   if (this->output_path.ends_with(".json")) {
+      std::ofstream stream(this->output_path.c_str());
+      if (!stream) {
+         warning(0, "lu-bitpack: unable to open the time report output path: %<%s%>", this->output_path.c_str());
+         return;
+      }
+      stream << this->to_json();
+      return;
+   }
+   if (!this->output_path.empty()) {
+      warning(0, "lu-bitpack: ignoring invalid time report output path set on the command line (must end in %<.json%>): %<%s%>", this->output_path.c_str());
+   }
+   fputs(this->to_text().c_str(), stderr);
+}
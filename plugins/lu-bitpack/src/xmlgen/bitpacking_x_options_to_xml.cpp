@@ -1,4 +1,6 @@
 #include "xmlgen/bitpacking_x_options_to_xml.h"
+#include <string>
+#include "lu/stringf.h"
 #include "bitpacking/data_options.h"
 #include "gcc_wrappers/type/base.h"
 #include "xmlgen/integral_type_index.h"
@@ -22,7 +24,7 @@ namespace xmlgen {
       if (write_as_child_node) {
          if (options.is<typed_options::boolean>())
             return;
-         if (options.is<typed_options::pointer>())
+         if (options.is<typed_options::pointer>() && !options.as<typed_options::pointer>().into)
             return;
          if (options.is<typed_options::structure>())
             return;
@@ -32,8 +34,14 @@ namespace xmlgen {
          subject.append_child(std::move(x_opt_ptr));
          if (options.is<typed_options::buffer>()) {
             x_opt->node_name = "opaque-buffer-options";
+         } else if (options.is<typed_options::delta>()) {
+            x_opt->node_name = "delta-options";
          } else if (options.is<typed_options::integral>()) {
             x_opt->node_name = "integral-options";
+         } else if (options.is<typed_options::pointer>()) {
+            x_opt->node_name = "pointer-options";
+         } else if (options.is<typed_options::quantized>()) {
+            x_opt->node_name = "quantize-options";
          } else if (options.is<typed_options::string>()) {
             x_opt->node_name = "string-options";
          } else if (options.is<typed_options::tagged_union>()) {
@@ -58,8 +66,12 @@ namespace xmlgen {
                subject.node_name = "boolean";
             } else if (options.is<typed_options::buffer>()) {
                subject.node_name = "buffer";
+            } else if (options.is<typed_options::delta>()) {
+               subject.node_name = "delta";
             } else if (options.is<typed_options::integral>()) {
                subject.node_name = "integer";
+            } else if (options.is<typed_options::quantized>()) {
+               subject.node_name = "quantized";
             } else if (options.is<typed_options::pointer>()) {
                subject.node_name = "pointer";
             } else if (options.is<typed_options::string>()) {
@@ -92,6 +104,11 @@ namespace xmlgen {
       if (options.is<typed_options::buffer>()) {
          const auto& casted = options.as<typed_options::buffer>();
          node.set_attribute_i("bytecount", casted.bytecount);
+      } else if (options.is<typed_options::delta>()) {
+         const auto& casted = options.as<typed_options::delta>();
+         node.set_attribute_i("first-bits", casted.first_bits);
+         node.set_attribute_i("delta-bits", casted.delta_bits);
+         node.set_attribute_i("length",     casted.length);
       } else if (options.is<typed_options::integral>()) {
          const auto& casted = options.as<typed_options::integral>();
          node.set_attribute_i("bitcount", casted.bitcount);
@@ -101,14 +118,46 @@ namespace xmlgen {
          if (casted.max != typed_options::integral::no_maximum) {
             node.set_attribute_i("max", casted.max);
          }
+         if (!casted.value_set.empty()) {
+            std::string list;
+            for(auto v : casted.value_set) {
+               if (!list.empty())
+                  list += ',';
+               list += std::to_string(v);
+            }
+            node.set_attribute("value-set", list);
+         }
+      } else if (options.is<typed_options::quantized>()) {
+         const auto& casted = options.as<typed_options::quantized>();
+         node.set_attribute_i("bitcount", casted.bitcount);
+         node.set_attribute("min",  lu::stringf("%.10Lg", casted.min));
+         node.set_attribute("max",  lu::stringf("%.10Lg", casted.max));
+         node.set_attribute("step", lu::stringf("%.10Lg", casted.step()));
       } else if (options.is<typed_options::pointer>()) {
-         ;
+         const auto& casted = options.as<typed_options::pointer>();
+         if (auto opt = casted.into) {
+            node.set_attribute("into", opt->name());
+            node.set_attribute_i("bitcount", casted.bitcount);
+         }
       } else if (options.is<typed_options::string>()) {
          const auto& casted = options.as<typed_options::string>();
          node.set_attribute_i("length",    casted.length);
          node.set_attribute_b("nonstring", casted.nonstring);
+         if (casted.char_bits != 8)
+            node.set_attribute_i("char-bits", casted.char_bits);
+         if (!casted.charset.empty()) {
+            std::string list;
+            for(auto v : casted.charset) {
+               if (!list.empty())
+                  list += ',';
+               list += std::to_string(v);
+            }
+            node.set_attribute("charset", list);
+         }
       } else if (options.is<typed_options::structure>()) {
-         ;
+         const auto& casted = options.as<typed_options::structure>();
+         if (casted.mixed_radix)
+            node.set_attribute_b("mixed-radix", true);
       } else if (options.is<typed_options::tagged_union>()) {
          const auto& casted = options.as<typed_options::tagged_union>();
          node.set_attribute("tag", casted.tag_identifier);
@@ -1,6 +1,7 @@
 #include "xmlgen/instruction_tree_xml_generator.h"
 #include <cassert>
 #include <limits>
+#include <string>
 #include "gcc_wrappers/decl/param.h"
 #include "bitpacking/data_options.h"
 #include "lu/stringf.h"
@@ -115,8 +116,12 @@ namespace xmlgen {
             node.node_name = "boolean";
          } else if (options.is<typed_options::buffer>()) {
             node.node_name = "buffer";
+         } else if (options.is<typed_options::delta>()) {
+            node.node_name = "delta";
          } else if (options.is<typed_options::integral>()) {
             node.node_name = "integer";
+         } else if (options.is<typed_options::quantized>()) {
+            node.node_name = "quantized";
          } else if (options.is<typed_options::pointer>()) {
             node.node_name = "pointer";
          } else if (options.is<typed_options::string>()) {
@@ -141,6 +146,11 @@ namespace xmlgen {
       if (options.is<typed_options::buffer>()) {
          const auto& casted = options.as<typed_options::buffer>();
          node.set_attribute_i("bytecount", casted.bytecount);
+      } else if (options.is<typed_options::delta>()) {
+         const auto& casted = options.as<typed_options::delta>();
+         node.set_attribute_i("first-bits", casted.first_bits);
+         node.set_attribute_i("delta-bits", casted.delta_bits);
+         node.set_attribute_i("length",     casted.length);
       } else if (options.is<typed_options::integral>()) {
          const auto& casted = options.as<typed_options::integral>();
          node.set_attribute_i("bitcount", casted.bitcount);
@@ -150,14 +160,46 @@ namespace xmlgen {
          if (casted.max != typed_options::integral::no_maximum) {
             node.set_attribute_i("max", casted.max);
          }
+         if (!casted.value_set.empty()) {
+            std::string list;
+            for(auto v : casted.value_set) {
+               if (!list.empty())
+                  list += ',';
+               list += std::to_string(v);
+            }
+            node.set_attribute("value-set", list);
+         }
+      } else if (options.is<typed_options::quantized>()) {
+         const auto& casted = options.as<typed_options::quantized>();
+         node.set_attribute_i("bitcount", casted.bitcount);
+         node.set_attribute("min",  lu::stringf("%.10Lg", casted.min));
+         node.set_attribute("max",  lu::stringf("%.10Lg", casted.max));
+         node.set_attribute("step", lu::stringf("%.10Lg", casted.step()));
       } else if (options.is<typed_options::pointer>()) {
-         ;
+         const auto& casted = options.as<typed_options::pointer>();
+         if (auto opt = casted.into) {
+            node.set_attribute("into", opt->name());
+            node.set_attribute_i("bitcount", casted.bitcount);
+         }
       } else if (options.is<typed_options::string>()) {
          const auto& casted = options.as<typed_options::string>();
          node.set_attribute_i("length",    casted.length);
          node.set_attribute_b("nonstring", casted.nonstring);
+         if (casted.char_bits != 8)
+            node.set_attribute_i("char-bits", casted.char_bits);
+         if (!casted.charset.empty()) {
+            std::string list;
+            for(auto v : casted.charset) {
+               if (!list.empty())
+                  list += ',';
+               list += std::to_string(v);
+            }
+            node.set_attribute("charset", list);
+         }
       } else if (options.is<typed_options::structure>()) {
-         ;
+         const auto& casted = options.as<typed_options::structure>();
+         if (casted.mixed_radix)
+            node.set_attribute_b("mixed-radix", true);
       } else if (options.is<typed_options::tagged_union>()) {
          const auto& casted = options.as<typed_options::tagged_union>();
          node.set_attribute("tag", casted.tag_identifier);
@@ -220,6 +262,15 @@ namespace xmlgen {
       const auto& options = instr.value.bitpacking_options();
       this->_fill_out_value_element(node, options);
       
+      if (instr.bit_slice.has_value()) {
+         node.set_attribute_i("slice-start", instr.bit_slice->start);
+         node.set_attribute_i("slice-bitcount", instr.bit_slice->count);
+      }
+      if (instr.byte_slice.has_value()) {
+         node.set_attribute_i("slice-start-byte", instr.byte_slice->start);
+         node.set_attribute_i("slice-bytecount", instr.byte_slice->count);
+      }
+      
       return node_ptr;
    }
    owned_element instruction_tree_xml_generator::_generate(const codegen::instructions::transform& instr) {
@@ -1,4 +1,5 @@
 #include "xmlgen/integral_type_index.h"
+#include <string>
 #include "gcc_wrappers/type/array.h"
 #include "gcc_wrappers/type/container.h"
 namespace gw {
@@ -27,6 +28,15 @@ namespace xmlgen {
          if (casted.max != typed_options::integral::no_maximum) {
             node.set_attribute_i("max", casted.max);
          }
+         if (!casted.value_set.empty()) {
+            std::string list;
+            for(auto v : casted.value_set) {
+               if (!list.empty())
+                  list += ',';
+               list += std::to_string(v);
+            }
+            node.set_attribute("value-set", list);
+         }
       }
       for(const auto& category : this->options.stat_categories) {
          auto  elem_ptr = std::make_unique<xml_element>();
@@ -8,6 +8,7 @@
 #include "codegen/decl_descriptor.h"
 #include "codegen/decl_dictionary.h"
 #include "codegen/generation_request.h"
+#include "codegen/mixed_radix.h"
 #include "codegen/stats_gatherer.h"
 #include "codegen/whole_struct_function_dictionary.h"
 #include "codegen/whole_struct_function_info.h"
@@ -84,8 +85,12 @@ namespace xmlgen {
                node.node_name = "boolean";
             } else if (member_options.is<typed_options::buffer>()) {
                node.node_name = "buffer";
+            } else if (member_options.is<typed_options::delta>()) {
+               node.node_name = "delta";
             } else if (member_options.is<typed_options::integral>()) {
                node.node_name = "integer";
+            } else if (member_options.is<typed_options::quantized>()) {
+               node.node_name = "quantized";
             } else if (member_options.is<typed_options::pointer>()) {
                node.node_name = "pointer";
             } else if (member_options.is<typed_options::string>()) {
@@ -110,6 +115,11 @@ namespace xmlgen {
          if (member_options.is<typed_options::buffer>()) {
             const auto& casted = member_options.as<typed_options::buffer>();
             node.set_attribute_i("bytecount", casted.bytecount);
+         } else if (member_options.is<typed_options::delta>()) {
+            const auto& casted = member_options.as<typed_options::delta>();
+            node.set_attribute_i("first-bits", casted.first_bits);
+            node.set_attribute_i("delta-bits", casted.delta_bits);
+            node.set_attribute_i("length",     casted.length);
          } else if (member_options.is<typed_options::integral>()) {
             const auto& casted = member_options.as<typed_options::integral>();
             //
@@ -142,12 +152,33 @@ namespace xmlgen {
             if (serialize_max && casted.max != typed_options::integral::no_maximum) {
                node.set_attribute_i("max", casted.max);
             }
+         } else if (member_options.is<typed_options::quantized>()) {
+            const auto& casted = member_options.as<typed_options::quantized>();
+            node.set_attribute_i("bitcount", casted.bitcount);
+            node.set_attribute("min",  lu::stringf("%.10Lg", casted.min));
+            node.set_attribute("max",  lu::stringf("%.10Lg", casted.max));
+            node.set_attribute("step", lu::stringf("%.10Lg", casted.step()));
          } else if (member_options.is<typed_options::pointer>()) {
-            ;
+            const auto& casted = member_options.as<typed_options::pointer>();
+            if (auto opt = casted.into) {
+               node.set_attribute("into", opt->name());
+               node.set_attribute_i("bitcount", casted.bitcount);
+            }
          } else if (member_options.is<typed_options::string>()) {
             const auto& casted = member_options.as<typed_options::string>();
             node.set_attribute_i("length",    casted.length);
             node.set_attribute_b("nonstring", casted.nonstring);
+            if (casted.char_bits != 8)
+               node.set_attribute_i("char-bits", casted.char_bits);
+            if (!casted.charset.empty()) {
+               std::string list;
+               for(auto v : casted.charset) {
+                  if (!list.empty())
+                     list += ',';
+                  list += std::to_string(v);
+               }
+               node.set_attribute("charset", list);
+            }
          } else if (member_options.is<typed_options::structure>()) {
             ;
          } else if (member_options.is<typed_options::tagged_union>()) {
@@ -373,6 +404,22 @@ namespace xmlgen {
             out += node.to_string(2);
             out += '\n';
          }
+         if (!go.sectors.sizes.empty()) {
+            std::string value;
+            for(auto size : go.sectors.sizes) {
+               if (!value.empty())
+                  value += ',';
+               value += lu::stringf("%u", (int)size);
+            }
+            
+            auto  node_ptr = std::make_unique<xml_element>();
+            auto& node     = *node_ptr;
+            node.node_name = "option";
+            node.set_attribute("name", "sector-bytecounts");
+            node.set_attribute("value", value);
+            out += node.to_string(2);
+            out += '\n';
+         }
          out += "   </config>\n";
       }
       {  // categories
@@ -422,6 +469,22 @@ namespace xmlgen {
                   auto child_ptr = this->_referenceable_aggregate_members_to_xml(cont);
                   node.append_child(std::move(child_ptr));
                }
+               if (codegen::mixed_radix::is_mixed_radix(info.options, info.stats.type)) {
+                  auto layout = codegen::mixed_radix::compute_layout(info.stats.type.as_record());
+                  if (layout) {
+                     auto  elem_ptr = std::make_unique<xml_element>();
+                     auto& elem     = *elem_ptr;
+                     elem.node_name = "mixed-radix-options";
+                     elem.set_attribute_i("group-count",       layout->groups.size());
+                     elem.set_attribute_i("bitcount",          layout->bitcount);
+                     elem.set_attribute_i("unpacked-bitcount", layout->unpacked_bitcount);
+                     elem.set_attribute_i("bits-saved",        layout->unpacked_bitcount - layout->bitcount);
+                     if (info.stats.counts.total > 0) {
+                        elem.set_attribute_i("total-bits-saved", (layout->unpacked_bitcount - layout->bitcount) * info.stats.counts.total);
+                     }
+                     node.append_child(std::move(elem_ptr));
+                  }
+               }
                
                xml_element* instr = nullptr;
                if (info.instructions) {
@@ -0,0 +1,197 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 14
+#define SECTOR_SIZE 3968
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+
+//
+// A save layout on the scale of a real game's, for use by `make bench`. The 
+// shape is loosely modeled on a monster-collecting game: a small party with 
+// full stats, and a large amount of storage boxes holding compact entries.
+//
+
+#define PARTY_SIZE        6
+#define BOX_COUNT        14
+#define MONS_PER_BOX     30
+#define NAME_LENGTH      10
+#define FLAG_BYTES      300
+#define VAR_COUNT       256
+
+struct BoxMon {
+   LU_BP_MINMAX(0, 1023) u16 species;
+   LU_BP_MINMAX(0, 511)  u16 held_item;
+   u32 experience;
+   LU_BP_BITCOUNT(9) u16 moves[4];
+   LU_BP_BITCOUNT(6) u8  pp[4];
+   LU_BP_BITCOUNT(5) u8  ivs[6];
+   u8  evs[6];
+   LU_BP_STRING_UT u8 nickname[NAME_LENGTH];
+   LU_BP_MINMAX(0, 255) u8 friendship;
+   bool8 is_egg;
+   bool8 is_shiny;
+};
+
+struct PartyMon {
+   struct BoxMon box;
+   LU_BP_MINMAX(1, 100) u8 level;
+   u16 hp;
+   u16 max_hp;
+   u16 stats[5];
+   LU_BP_BITCOUNT(3) u8 status;
+};
+
+struct SaveBlock2 {
+   LU_BP_STRING u8 player_name[7];
+   LU_BP_MINMAX(0, 1) u8 gender;
+   u16 trainer_id;
+   u16 secret_id;
+   LU_BP_MINMAX(0, 999) u16 play_time_hours;
+   LU_BP_MINMAX(0, 59)  u8  play_time_minutes;
+   LU_BP_MINMAX(0, 59)  u8  play_time_seconds;
+   u32 money;
+   struct PartyMon party[PARTY_SIZE];
+   LU_BP_AS_OPAQUE_BUFFER u8 flags[FLAG_BYTES];
+   u16 vars[VAR_COUNT];
+} gSaveBlock2;
+
+struct PokemonStorage {
+   LU_BP_MINMAX(0, BOX_COUNT - 1) u8 current_box;
+   LU_BP_STRING u8 box_names[BOX_COUNT][9];
+   LU_BP_MINMAX(0, 15) u8 box_wallpapers[BOX_COUNT];
+   struct BoxMon boxes[BOX_COUNT][MONS_PER_BOX];
+} gPokemonStorage;
+
+extern void generated_read(const u8* src, int sector_id);
+extern void generated_save(u8* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = gSaveBlock2 | gPokemonStorage \
+)
+
+//
+// Testing:
+//
+
+#include <string.h> // memcpy, memset
+
+static void fill_box_mon(struct BoxMon* mon, u32 seed) {
+   mon->species    = seed % 1024;
+   mon->held_item  = (seed * 7) % 512;
+   mon->experience = seed * 2654435761u;
+   for(int i = 0; i < 4; ++i) {
+      mon->moves[i] = (seed + i * 37) % 512;
+      mon->pp[i]    = (seed + i) % 64;
+   }
+   for(int i = 0; i < 6; ++i) {
+      mon->ivs[i] = (seed + i * 3) % 32;
+      mon->evs[i] = (seed + i * 11) % 256;
+   }
+   memset(mon->nickname, 0, sizeof(mon->nickname));
+   for(int i = 0; i < (int)(seed % NAME_LENGTH); ++i)
+      mon->nickname[i] = 'A' + (seed + i) % 26;
+   mon->friendship = seed % 256;
+   mon->is_egg     = seed % 2;
+   mon->is_shiny   = (seed / 2) % 2;
+}
+
+static void fill_test_data(void) {
+   memset(&gSaveBlock2, 0, sizeof(gSaveBlock2));
+   memset(&gPokemonStorage, 0, sizeof(gPokemonStorage));
+   
+   memcpy(gSaveBlock2.player_name, "PLAYER", 6);
+   gSaveBlock2.gender            = 1;
+   gSaveBlock2.trainer_id        = 12345;
+   gSaveBlock2.secret_id         = 54321;
+   gSaveBlock2.play_time_hours   = 123;
+   gSaveBlock2.play_time_minutes = 45;
+   gSaveBlock2.play_time_seconds = 6;
+   gSaveBlock2.money             = 999999;
+   for(int i = 0; i < PARTY_SIZE; ++i) {
+      struct PartyMon* mon = &gSaveBlock2.party[i];
+      fill_box_mon(&mon->box, 1000 + i);
+      mon->level  = 1 + i * 10;
+      mon->hp     = 100 + i;
+      mon->max_hp = 200 + i;
+      for(int j = 0; j < 5; ++j)
+         mon->stats[j] = 50 + i * 5 + j;
+      mon->status = i % 8;
+   }
+   for(int i = 0; i < FLAG_BYTES; ++i)
+      gSaveBlock2.flags[i] = i * 13;
+   for(int i = 0; i < VAR_COUNT; ++i)
+      gSaveBlock2.vars[i] = i * 257;
+   
+   gPokemonStorage.current_box = 3;
+   for(int i = 0; i < BOX_COUNT; ++i) {
+      snprintf((char*)gPokemonStorage.box_names[i], 9, "BOX %d", i + 1);
+      gPokemonStorage.box_wallpapers[i] = i % 16;
+      for(int j = 0; j < MONS_PER_BOX; ++j)
+         fill_box_mon(&gPokemonStorage.boxes[i][j], i * MONS_PER_BOX + j);
+   }
+}
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+static struct SaveBlock2     sExpected2;
+static struct PokemonStorage sExpectedStorage;
+
+int main() {
+   fill_test_data();
+   memcpy(&sExpected2, &gSaveBlock2, sizeof(gSaveBlock2));
+   memcpy(&sExpectedStorage, &gPokemonStorage, sizeof(gPokemonStorage));
+   
+   printf("Saving %u sectors...\n", (int)__lu_bitpack_sector_count);
+   for(int i = 0; i < (int)__lu_bitpack_sector_count; ++i)
+      generated_save(sector_buffers[i], i);
+   
+   memset(&gSaveBlock2, 0, sizeof(gSaveBlock2));
+   memset(&gPokemonStorage, 0, sizeof(gPokemonStorage));
+   
+   printf("Reading %u sectors...\n", (int)__lu_bitpack_sector_count);
+   for(int i = 0; i < (int)__lu_bitpack_sector_count; ++i)
+      generated_read(sector_buffers[i], i);
+   
+   if (memcmp(&gSaveBlock2, &sExpected2, sizeof(gSaveBlock2)) != 0) {
+      printf("gSaveBlock2 did not survive a round trip.\n");
+      return 1;
+   }
+   if (memcmp(&gPokemonStorage, &sExpectedStorage, sizeof(gPokemonStorage)) != 0) {
+      printf("gPokemonStorage did not survive a round trip.\n");
+      return 1;
+   }
+   printf("Round trip OK.\n");
+   return 0;
+}
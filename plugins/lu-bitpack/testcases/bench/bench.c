@@ -0,0 +1,105 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "types.h"
+#include "bitstreams.h"
+
+//
+// Throughput benchmark for generated read/save functions. Link this against
+// a testcase compiled with `-Dmain=lu_testcase_main` and against a build of
+// `bitstreams.c`. (Build `bitstreams.c` with `LU_BITSTREAM_COUNT_CALLS` to
+// also report call counts; this adds an increment to every call.)
+//
+// Usage: bench <testcase-name> [iterations]
+//
+// Writes one JSON object per sector, one per line, to stdout.
+//
+
+extern void generated_read(const u8* src, int sector_id);
+extern void generated_save(u8* dst, int sector_id);
+
+extern const size_t __lu_bitpack_sector_count;
+extern const size_t __lu_bitpack_max_sector_size;
+
+static double now_ns(void) {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+int main(int argc, char** argv) {
+   const char* name       = argc > 1 ? argv[1] : "unknown";
+   long        iterations = argc > 2 ? atol(argv[2]) : 100000;
+   if (iterations <= 0)
+      iterations = 1;
+
+   size_t sector_size = __lu_bitpack_max_sector_size;
+   if (sector_size == 0)
+      sector_size = 1;
+   u8* buffer = malloc(sector_size);
+   if (!buffer)
+      return 1;
+
+   for(size_t i = 0; i < __lu_bitpack_sector_count; ++i) {
+      memset(buffer, 0, sector_size);
+
+      //
+      // Warm up, and take a single counted pass through each function.
+      //
+      u32 save_calls = 0;
+      u32 read_calls = 0;
+      u32 bits       = 0;
+      #ifdef LU_BITSTREAM_COUNT_CALLS
+         memset(&lu_BitstreamCallCounts, 0, sizeof(lu_BitstreamCallCounts));
+         generated_save(buffer, (int)i);
+         save_calls = lu_BitstreamCallCounts.calls;
+         bits       = lu_BitstreamCallCounts.bits;
+
+         memset(&lu_BitstreamCallCounts, 0, sizeof(lu_BitstreamCallCounts));
+         generated_read(buffer, (int)i);
+         read_calls = lu_BitstreamCallCounts.calls;
+      #else
+         generated_save(buffer, (int)i);
+         generated_read(buffer, (int)i);
+         bits = (u32)(sector_size * 8);
+      #endif
+      if (bits == 0)
+         bits = 1;
+
+      double start;
+      double save_ns;
+      double read_ns;
+
+      start = now_ns();
+      for(long j = 0; j < iterations; ++j)
+         generated_save(buffer, (int)i);
+      save_ns = (now_ns() - start) / (double)iterations;
+
+      start = now_ns();
+      for(long j = 0; j < iterations; ++j)
+         generated_read(buffer, (int)i);
+      read_ns = (now_ns() - start) / (double)iterations;
+
+      printf(
+         "{\"testcase\": \"%s\", \"sector\": %u, \"iterations\": %ld, \"bits\": %u, "
+         "\"save_ns_per_sector\": %.2f, \"read_ns_per_sector\": %.2f, "
+         "\"save_ns_per_bit\": %.4f, \"read_ns_per_bit\": %.4f, "
+         "\"save_calls\": %u, \"read_calls\": %u}\n",
+         name,
+         (unsigned int)i,
+         iterations,
+         bits,
+         save_ns,
+         read_ns,
+         save_ns / bits,
+         read_ns / bits,
+         save_calls,
+         read_calls
+      );
+   }
+
+   free(buffer);
+   return 0;
+}
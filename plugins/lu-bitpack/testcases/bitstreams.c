@@ -22,6 +22,18 @@ static void _advance_position_by_bytes(struct lu_BitstreamState* state, u8 bytes
    #define INVOKE_POST_WRITE_HANDLERS 1
 #endif
 
+#ifdef LU_BITSTREAM_COUNT_CALLS
+   struct lu_BitstreamCallCounts lu_BitstreamCallCounts;
+   
+   #define COUNT_CALL(bitcount) \
+      do { \
+         ++lu_BitstreamCallCounts.calls; \
+         lu_BitstreamCallCounts.bits += (bitcount); \
+      } while (0)
+#else
+   #define COUNT_CALL(bitcount)
+#endif
+
 static void _post_write_integral(struct lu_BitstreamState* state, u8 bits_written, u32 value_written) {
 }
 static void _post_write_buffer(struct lu_BitstreamState* state, u8 string_length) {
@@ -61,10 +73,11 @@ static u8 _consume_byte_for_read(struct lu_BitstreamState* state, u8 bitcount, u
 
 u8 lu_BitstreamRead_bool(struct lu_BitstreamState* state) {
    u8 consumed;
+   COUNT_CALL(1);
    return _consume_byte_for_read(state, 1, &consumed) & 1;
 }
 
-u8 lu_BitstreamRead_u8(struct lu_BitstreamState* state, u8 bitcount) {
+static u8 _read_u8(struct lu_BitstreamState* state, u8 bitcount) {
    u8 result;
    u8 raw;
    u8 consumed;
@@ -79,7 +92,7 @@ u8 lu_BitstreamRead_u8(struct lu_BitstreamState* state, u8 bitcount) {
    }
    return result;
 }
-u16 lu_BitstreamRead_u16(struct lu_BitstreamState* state, u8 bitcount) {
+static u16 _read_u16(struct lu_BitstreamState* state, u8 bitcount) {
    u16 result;
    u8  raw;
    u8  consumed;
@@ -94,7 +107,7 @@ u16 lu_BitstreamRead_u16(struct lu_BitstreamState* state, u8 bitcount) {
    }
    return result;
 }
-u32 lu_BitstreamRead_u32(struct lu_BitstreamState* state, u8 bitcount) {
+static u32 _read_u32(struct lu_BitstreamState* state, u8 bitcount) {
    u32 result;
    u8  raw;
    u8  consumed;
@@ -110,8 +123,23 @@ u32 lu_BitstreamRead_u32(struct lu_BitstreamState* state, u8 bitcount) {
    return result;
 }
 
+u8 lu_BitstreamRead_u8(struct lu_BitstreamState* state, u8 bitcount) {
+   COUNT_CALL(bitcount);
+   return _read_u8(state, bitcount);
+}
+u16 lu_BitstreamRead_u16(struct lu_BitstreamState* state, u8 bitcount) {
+   COUNT_CALL(bitcount);
+   return _read_u16(state, bitcount);
+}
+u32 lu_BitstreamRead_u32(struct lu_BitstreamState* state, u8 bitcount) {
+   COUNT_CALL(bitcount);
+   return _read_u32(state, bitcount);
+}
+
 s8 lu_BitstreamRead_s8(struct lu_BitstreamState* state, u8 bitcount) {
-   s8 result = (s8) lu_BitstreamRead_u8(state, bitcount);
+   s8 result;
+   COUNT_CALL(bitcount);
+   result = (s8) _read_u8(state, bitcount);
    if (bitcount < 8) {
       u8 sign_bit = (u8)result >> (bitcount - 1); // cast to avoid sign-extension
       if (sign_bit) {
@@ -122,7 +150,9 @@ s8 lu_BitstreamRead_s8(struct lu_BitstreamState* state, u8 bitcount) {
    return result;
 }
 s16 lu_BitstreamRead_s16(struct lu_BitstreamState* state, u8 bitcount) {
-   s16 result = (s16) lu_BitstreamRead_u16(state, bitcount);
+   s16 result;
+   COUNT_CALL(bitcount);
+   result = (s16) _read_u16(state, bitcount);
    if (bitcount < 16) {
       u8 sign_bit = (u16)result >> (bitcount - 1); // cast to avoid sign-extension
       if (sign_bit) {
@@ -133,7 +163,9 @@ s16 lu_BitstreamRead_s16(struct lu_BitstreamState* state, u8 bitcount) {
    return result;
 }
 s32 lu_BitstreamRead_s32(struct lu_BitstreamState* state, u8 bitcount) {
-   s32 result = (s32) lu_BitstreamRead_u32(state, bitcount);
+   s32 result;
+   COUNT_CALL(bitcount);
+   result = (s32) _read_u32(state, bitcount);
    if (bitcount < 32) {
       u8 sign_bit = (u32)result >> (bitcount - 1); // cast to avoid sign-extension
       if (sign_bit) {
@@ -149,9 +181,10 @@ void lu_BitstreamRead_string(struct lu_BitstreamState* state, u8* dst, u16 max_l
    bool8 seen_end;
    u16 len;
    
+   COUNT_CALL(max_length * 8);
    seen_end = FALSE;
    for(i = 0; i < max_length; ++i) {
-      dst[i] = lu_BitstreamRead_u8(state, 8);
+      dst[i] = _read_u8(state, 8);
       if (dst[i] == EOS) {
          seen_end = TRUE;
       } else if (seen_end) {
@@ -162,14 +195,16 @@ void lu_BitstreamRead_string(struct lu_BitstreamState* state, u8* dst, u16 max_l
 }
 void lu_BitstreamRead_string_optional_terminator(struct lu_BitstreamState* state, u8* dst, u16 max_length) {
    u16 i;
+   COUNT_CALL(max_length * 8);
    for(i = 0; i < max_length; ++i)
-      dst[i] = lu_BitstreamRead_u8(state, 8);
+      dst[i] = _read_u8(state, 8);
 }
 
 void lu_BitstreamRead_buffer(struct lu_BitstreamState* state, void* value, u16 bytecount) {
    u16 i;
+   COUNT_CALL(bytecount * 8);
    for(i = 0; i < bytecount; ++i)
-      *((u8*)value + i) = lu_BitstreamRead_u8(state, 8);
+      *((u8*)value + i) = _read_u8(state, 8);
 }
 
 //
@@ -177,6 +212,7 @@ void lu_BitstreamRead_buffer(struct lu_BitstreamState* state, void* value, u16 b
 //
 
 void lu_BitstreamWrite_bool(struct lu_BitstreamState* state, bool8 value) {
+   COUNT_CALL(1);
    if (state->shift == 0) {
       *state->target = value ? 0x80 : 0x00;
       ++state->shift;
@@ -202,7 +238,7 @@ void lu_BitstreamWrite_bool(struct lu_BitstreamState* state, bool8 value) {
       _post_write_integral(state, 1, value);
    #endif
 }
-void lu_BitstreamWrite_u8(struct lu_BitstreamState* state, u8 value, u8 bitcount) {
+static void _write_u8(struct lu_BitstreamState* state, u8 value, u8 bitcount) {
    #ifdef INVOKE_POST_WRITE_HANDLERS
       u8 original_bitcount = bitcount;
    #endif
@@ -250,7 +286,7 @@ void lu_BitstreamWrite_u8(struct lu_BitstreamState* state, u8 value, u8 bitcount
    #endif
 }
 
-void lu_BitstreamWrite_u16(struct lu_BitstreamState* state, u16 value, u8 bitcount) {
+static void _write_u16(struct lu_BitstreamState* state, u16 value, u8 bitcount) {
    #ifdef INVOKE_POST_WRITE_HANDLERS
       u8 original_bitcount = bitcount;
    #endif
@@ -298,7 +334,7 @@ void lu_BitstreamWrite_u16(struct lu_BitstreamState* state, u16 value, u8 bitcou
    #endif
 }
 
-void lu_BitstreamWrite_u32(struct lu_BitstreamState* state, u32 value, u8 bitcount) {
+static void _write_u32(struct lu_BitstreamState* state, u32 value, u8 bitcount) {
    #ifdef INVOKE_POST_WRITE_HANDLERS
       u8 original_bitcount = bitcount;
    #endif
@@ -346,14 +382,30 @@ void lu_BitstreamWrite_u32(struct lu_BitstreamState* state, u32 value, u8 bitcou
    #endif
 }
 
+void lu_BitstreamWrite_u8(struct lu_BitstreamState* state, u8 value, u8 bitcount) {
+   COUNT_CALL(bitcount);
+   _write_u8(state, value, bitcount);
+}
+void lu_BitstreamWrite_u16(struct lu_BitstreamState* state, u16 value, u8 bitcount) {
+   COUNT_CALL(bitcount);
+   _write_u16(state, value, bitcount);
+}
+void lu_BitstreamWrite_u32(struct lu_BitstreamState* state, u32 value, u8 bitcount) {
+   COUNT_CALL(bitcount);
+   _write_u32(state, value, bitcount);
+}
+
 void lu_BitstreamWrite_s8(struct lu_BitstreamState* state, s8 value, u8 bitcount) {
-   lu_BitstreamWrite_u8(state, (u8)value, bitcount);
+   COUNT_CALL(bitcount);
+   _write_u8(state, (u8)value, bitcount);
 }
 void lu_BitstreamWrite_s16(struct lu_BitstreamState* state, s16 value, u8 bitcount) {
-   lu_BitstreamWrite_u16(state, (u16)value, bitcount);
+   COUNT_CALL(bitcount);
+   _write_u16(state, (u16)value, bitcount);
 }
 void lu_BitstreamWrite_s32(struct lu_BitstreamState* state, s32 value, u8 bitcount) {
-   lu_BitstreamWrite_u32(state, (u32)value, bitcount);
+   COUNT_CALL(bitcount);
+   _write_u32(state, (u32)value, bitcount);
 }
 
 
@@ -361,6 +413,7 @@ void lu_BitstreamWrite_string(struct lu_BitstreamState* state, const u8* value,
    u16 i;
    u16 len;
    
+   COUNT_CALL(max_length * 8);
    len = max_length;
    for(i = 0; i < max_length; ++i) {
       if (value[i] == EOS) {
@@ -370,10 +423,10 @@ void lu_BitstreamWrite_string(struct lu_BitstreamState* state, const u8* value,
    }
    
    for(i = 0; i < len; ++i) {
-      lu_BitstreamWrite_u8(state, value[i], 8);
+      _write_u8(state, value[i], 8);
    }
    for(; i < max_length; ++i) {
-      lu_BitstreamWrite_u8(state, EOS, 8);
+      _write_u8(state, EOS, 8);
    }
    #ifdef INVOKE_POST_WRITE_HANDLERS
       _post_write_string(state, max_length);
@@ -381,8 +434,9 @@ void lu_BitstreamWrite_string(struct lu_BitstreamState* state, const u8* value,
 }
 void lu_BitstreamWrite_string_optional_terminator(struct lu_BitstreamState* state, const u8* value, u16 max_length) {
    u16 i;
+   COUNT_CALL(max_length * 8);
    for(i = 0; i < max_length; ++i)
-      lu_BitstreamWrite_u8(state, value[i], 8);
+      _write_u8(state, value[i], 8);
    //
    #ifdef INVOKE_POST_WRITE_HANDLERS
       _post_write_string(state, max_length);
@@ -391,8 +445,9 @@ void lu_BitstreamWrite_string_optional_terminator(struct lu_BitstreamState* stat
 
 void lu_BitstreamWrite_buffer(struct lu_BitstreamState* state, const void* value, u16 bytecount) {
    u16 i;
+   COUNT_CALL(bytecount * 8);
    for(i = 0; i < bytecount; ++i)
-      lu_BitstreamWrite_u8(state, *((const u8*)value + i), 8);
+      _write_u8(state, *((const u8*)value + i), 8);
    //
    #ifdef INVOKE_POST_WRITE_HANDLERS
       _post_write_buffer(state, bytecount);
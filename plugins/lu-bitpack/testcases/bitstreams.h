@@ -14,6 +14,17 @@ struct lu_BitstreamState {
 
 extern void lu_BitstreamInitialize(struct lu_BitstreamState*, u8* target);
 
+#ifdef LU_BITSTREAM_COUNT_CALLS
+// Tallies of the calls made into this library, for benchmarking. Calls that 
+// the library makes to itself (e.g. to write each byte of a string) are not 
+// counted. Strings and buffers count as their full size in bits.
+struct lu_BitstreamCallCounts {
+   u32 calls;
+   u32 bits;
+};
+extern struct lu_BitstreamCallCounts lu_BitstreamCallCounts;
+#endif
+
 //
 // READING:
 //
@@ -0,0 +1,54 @@
+#
+# Compares two code size reports (see summarize.awk), and prints each row 
+# whose size changed, appeared, or disappeared. Exits with status 1 if any 
+# row grew and `strict` is set, or if the baseline has no rows at all.
+#
+# Usage: awk -v strict=0 -f compare.awk baseline.txt current.txt
+#
+
+# Skip comments and blank lines in either file.
+/^#/ || NF == 0 { next }
+
+FILENAME == ARGV[1] {
+   key = $1 " " $2 " " $3
+   baseline[key] = $4
+   ++baseline_rows
+   next
+}
+
+# Without a baseline, there's nothing to compare against; END reports it.
+!baseline_rows { next }
+
+{
+   key = $1 " " $2 " " $3
+   seen[key] = 1
+   if (!(key in baseline)) {
+      printf "  %-6s %-60s %8d\n", "new", key, $4
+      ++changed
+   } else if (baseline[key] != $4) {
+      delta = $4 - baseline[key]
+      printf "  %-6s %-60s %8d -> %8d (%+d)\n", (delta > 0 ? "GREW" : "shrank"), key, baseline[key], $4, delta
+      ++changed
+      if (delta > 0)
+         ++grew
+   }
+}
+
+END {
+   if (!baseline_rows) {
+      print "The code size baseline is empty; run `make code-size-update-baseline` to create it." > "/dev/stderr"
+      exit 1
+   }
+   for (key in baseline) {
+      if (!(key in seen)) {
+         printf "  %-6s %-60s %8d\n", "gone", key, baseline[key]
+         ++changed
+      }
+   }
+   if (!changed)
+      print "Code size matches the baseline."
+   else
+      printf "%d row(s) changed from the baseline; %d grew.\n", changed, grew
+   if (strict && grew)
+      exit 1
+}
@@ -0,0 +1,39 @@
+#
+# Turns `nm -S` output for one compiled testcase into rows of the code size 
+# report, one per line:
+#
+#    <testcase> function <symbol> <bytes>
+#    <testcase> sector   <index>  <bytes>   (read and save functions combined)
+#    <testcase> total    -        <bytes>
+#
+# Usage: nm -S test.o | awk -v testcase=<name> -f summarize.awk
+#
+
+function hex_to_dec(s,    i, c, n) {
+   n = 0
+   s = tolower(s)
+   for (i = 1; i <= length(s); ++i) {
+      c = index("0123456789abcdef", substr(s, i, 1)) - 1
+      n = n * 16 + c
+   }
+   return n
+}
+
+# Only sized, defined functions.
+NF == 4 && ($3 == "T" || $3 == "t") && $4 ~ /^__lu_bitpack_/ {
+   size = hex_to_dec($2)
+   functions[$4] = size
+   total += size
+   if (match($4, /_sector_[0-9]+$/)) {
+      sector = substr($4, RSTART + 8)
+      sectors[sector] += size
+   }
+}
+
+END {
+   for (name in functions)
+      printf "%s function %s %d\n", testcase, name, functions[name]
+   for (sector in sectors)
+      printf "%s sector %s %d\n", testcase, sector, sectors[sector]
+   printf "%s total - %d\n", testcase, total
+}
@@ -0,0 +1,154 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 5
+#define SECTOR_SIZE 12
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: accessors that read single values directly out of a sector.
+struct PackedColor;
+struct Color;
+void PackColor(const struct Color*, struct PackedColor*);
+void UnpackColor(struct Color*, const struct PackedColor*);
+
+struct PackedColor {
+   LU_BP_BITCOUNT(15) u16 tuple;
+};
+struct LU_BP_TRANSFORM(PackColor,UnpackColor) Color {
+   u8 r;
+   u8 g;
+   u8 b;
+};
+void PackColor(const struct Color* src, struct PackedColor* dst) {
+   dst->tuple = ((src->r & 31) << 10) | ((src->g & 31) << 5) | (src->b & 31);
+}
+void UnpackColor(struct Color* dst, const struct PackedColor* src) {
+   dst->r = (src->tuple >> 10) & 31;
+   dst->g = (src->tuple >> 5) & 31;
+   dst->b = src->tuple & 31;
+}
+
+struct Item {
+   LU_BP_BITCOUNT(10) u16 id;
+   LU_BP_MINMAX(-5, 10) s8 count;
+   bool8 flag;
+};
+
+struct TestStruct {
+   LU_BP_BITCOUNT(3) u8 small;
+   LU_BP_MINMAX(1000, 1500) u16 ranged;
+   LU_BP_STRING_NT u8 name[8];
+   struct Item items[4];
+   struct Color color;
+   u32 large;
+} sTestStruct;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct             \
+)
+
+u16 GetRanged(const void* sector);
+void GetName(const void* sector, u8* dst);
+
+#pragma lu_bitpack generate_accessor GetSmall  sTestStruct.small
+#pragma lu_bitpack generate_accessor GetRanged sTestStruct.ranged
+#pragma lu_bitpack generate_accessor GetName   sTestStruct.name
+#pragma lu_bitpack generate_accessor GetItem2  sTestStruct.items[2]
+#pragma lu_bitpack generate_accessor GetCount3 sTestStruct.items[3].count
+#pragma lu_bitpack generate_accessor GetColor  sTestStruct.color
+
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_small  sTestStruct.small
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_ranged sTestStruct.ranged
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_name   sTestStruct.name
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_item2  sTestStruct.items[2]
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_count3 sTestStruct.items[3].count
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_color  sTestStruct.color
+
+//
+// Testing:
+//
+
+#include <string.h> // memcpy, memset
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+int main() {
+   memset(&sector_buffers, 0, sizeof(sector_buffers));
+   
+   sTestStruct.small  = 5;
+   sTestStruct.ranged = 1234;
+   memcpy(sTestStruct.name, "Lu\0garbage", 8);
+   for(int i = 0; i < 4; ++i) {
+      sTestStruct.items[i].id    = 100 * i;
+      sTestStruct.items[i].count = i - 2;
+      sTestStruct.items[i].flag  = i & 1;
+   }
+   sTestStruct.color.r = 31;
+   sTestStruct.color.g = 16;
+   sTestStruct.color.b = 1;
+   sTestStruct.large   = 0xDEADBEEF;
+   
+   for(int i = 0; i < SECTOR_COUNT; ++i)
+      generated_save(sector_buffers[i], i);
+   
+   //
+   // Clobber the live data, so that we know the accessors aren't reading it.
+   //
+   memset(&sTestStruct, 0, sizeof(sTestStruct));
+   
+   printf("small:  %u\n", GetSmall(sector_buffers[sector_of_small]));
+   printf("ranged: %u\n", GetRanged(sector_buffers[sector_of_ranged]));
+   {
+      u8 name[8];
+      GetName(sector_buffers[sector_of_name], name);
+      printf("name:   %s\n", (const char*)name);
+   }
+   {
+      struct Item item = GetItem2(sector_buffers[sector_of_item2]);
+      printf("items[2]: id %u, count %d, flag %u\n", item.id, item.count, item.flag);
+   }
+   printf("items[3].count: %d\n", GetCount3(sector_buffers[sector_of_count3]));
+   {
+      struct Color color = GetColor(sector_buffers[sector_of_color]);
+      printf("color:  %u %u %u\n", color.r, color.g, color.b);
+   }
+   
+   return 0;
+}
@@ -0,0 +1,100 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 1
+#define SECTOR_SIZE 32
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: strings packed in fewer than 8 bits per character.
+static const u8 gDigits[] = { 0, '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '-' };
+static const u8 gBases[]  = { 'A', 'C', 'G', 'T' };
+
+struct TestStruct {
+   u8 before;
+   LU_BP_CHARSET("bits=7") char name[8];
+   LU_BP_CHARSET("table=gDigits") char phone[11];
+   __attribute__((lu_nonstring)) LU_BP_CHARSET("bits=2,table=gBases") char codons[2][4];
+   u16 after;
+} sTestStruct;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct             \
+)
+
+// 8 bits for `before`; 7 bits for each of the 7 characters of `name`; 4 bits 
+// (for 12 table entries) for each of the 10 characters of `phone`; and 2 bits 
+// for each of the 8 characters of `codons`.
+const unsigned int offset_of_after;
+#pragma lu_bitpack serialized_offset_to_constant offset_of_after sTestStruct.after
+
+//
+// Testing:
+//
+
+#include <string.h> // memcmp, memcpy, strcpy
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void fill(void) {
+   sTestStruct.before = 0x12;
+   strcpy(sTestStruct.name,  "Hello");
+   strcpy(sTestStruct.phone, "555-0123");
+   memcpy(sTestStruct.codons[0], "GATC", 4);
+   memcpy(sTestStruct.codons[1], "TTAA", 4);
+   sTestStruct.after = 0xBCDE;
+}
+
+int main() {
+   lu_test_check_value("Offset of sTestStruct.after", offset_of_after, 8 + 7 * 7 + 4 * 10 + 2 * 8);
+   
+   fill();
+   struct TestStruct expected = sTestStruct;
+   LU_TEST_ROUND_TRIP(generated_read, generated_save, sTestStruct, sector_buffers, 0xFF);
+   
+   bool8 same = 1;
+   same &= sTestStruct.before == expected.before;
+   same &= memcmp(sTestStruct.name,  expected.name,  sizeof(expected.name)) == 0;
+   same &= memcmp(sTestStruct.phone, expected.phone, sizeof(expected.phone)) == 0;
+   same &= memcmp(sTestStruct.codons, expected.codons, sizeof(expected.codons)) == 0;
+   same &= sTestStruct.after == expected.after;
+   lu_test_check(same, "Charset read matches the original data");
+   
+   return lu_test_failures;
+}
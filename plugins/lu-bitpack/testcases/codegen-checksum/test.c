@@ -0,0 +1,131 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 5
+#define SECTOR_SIZE 12
+
+u32 UpdateChecksum(u32 checksum, u32 value, u8 bitcount);
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer, \
+   checksum_type        = u32, \
+   func_checksum_update = UpdateChecksum \
+)
+
+// Testcase: a checksum computed while reading and saving each sector.
+u32 UpdateChecksum(u32 checksum, u32 value, u8 bitcount) {
+   checksum = (checksum << 5) | (checksum >> 27);
+   checksum ^= value + bitcount;
+   return checksum * 0x9E3779B1;
+}
+
+struct Item {
+   LU_BP_BITCOUNT(10) u16 id;
+   LU_BP_MINMAX(-5, 10) s8 count;
+   bool8 flag;
+};
+
+struct TestStruct {
+   LU_BP_BITCOUNT(3) u8 small;
+   u32 large;
+   LU_BP_STRING_NT u8 name[8];
+   LU_BP_STRING_UT u8 tag[4];
+   LU_BP_AS_OPAQUE_BUFFER u8 blob[3];
+   struct Item items[4];
+   LU_BP_OMIT int scratch;
+} sTestStruct;
+
+extern u32 generated_read(const void* src, int sector_id);
+extern u32 generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   data      = sTestStruct             \
+)
+
+//
+// Testing:
+//
+
+#include <string.h> // memcpy, memset
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+static u32 sector_checksums[SECTOR_COUNT];
+
+static void verify_all(const char* when) {
+   printf("Sectors with mismatched checksums %s:", when);
+   for(int i = 0; i < SECTOR_COUNT; ++i) {
+      if (generated_read(sector_buffers[i], i) != sector_checksums[i])
+         printf(" %u", i);
+   }
+   printf("\n");
+}
+
+int main() {
+   memset(&sector_buffers, 0, sizeof(sector_buffers));
+   
+   sTestStruct.small = 5;
+   sTestStruct.large = 0xDEADBEEF;
+   memcpy(sTestStruct.name, "Lu\0garbage", 8);
+   memcpy(sTestStruct.tag, "ABCD", 4);
+   sTestStruct.blob[0] = 1;
+   sTestStruct.blob[1] = 2;
+   sTestStruct.blob[2] = 3;
+   for(int i = 0; i < 4; ++i) {
+      sTestStruct.items[i].id    = 100 * i;
+      sTestStruct.items[i].count = i - 2;
+      sTestStruct.items[i].flag  = i & 1;
+   }
+   sTestStruct.scratch = 12345;
+   
+   for(int i = 0; i < SECTOR_COUNT; ++i) {
+      sector_checksums[i] = generated_save(sector_buffers[i], i);
+      printf("Sector %u checksum: %08X\n", i, sector_checksums[i]);
+   }
+   verify_all("after saving");
+   
+   //
+   // Data that isn't serialized shouldn't affect the checksum.
+   //
+   sTestStruct.name[5] = 'X'; // after the terminator
+   sTestStruct.items[1].flag = 2; // still truthy
+   sTestStruct.scratch = 0;
+   for(int i = 0; i < SECTOR_COUNT; ++i) {
+      if (generated_save(sector_buffers[i], i) != sector_checksums[i])
+         printf("Sector %u checksum changed after changing unsaved data\n", i);
+   }
+   
+   sector_buffers[1][0] ^= 0x10;
+   verify_all("after corrupting sector 1");
+   
+   return 0;
+}
\ No newline at end of file
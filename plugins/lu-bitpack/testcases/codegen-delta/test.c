@@ -0,0 +1,109 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 1
+#define SECTOR_SIZE 32
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: delta-encoded arrays.
+struct TestStruct {
+   u8 before;
+   LU_BP_DELTA(16, 6) u16 times[5];
+   LU_BP_DELTA(8, 3)  u8  counts[2][3];
+   LU_BP_DELTA(10, 4) s16 clamped[4];
+   u16 after;
+} sTestStruct;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct             \
+)
+
+// 8 bits for `before`; 16 + 4 * 6 bits for `times`; 8 + 2 * 3 bits for each 
+// of the two `counts` arrays; and 10 + 3 * 4 bits for `clamped`.
+const unsigned int offset_of_after;
+#pragma lu_bitpack serialized_offset_to_constant offset_of_after sTestStruct.after
+
+//
+// Testing:
+//
+
+#include <string.h> // memcmp, memcpy
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void fill(void) {
+   static const u16 times[5]     = { 100, 110, 150, 150, 200 };
+   static const u8  counts[2][3] = { { 1, 2, 9 }, { 0, 7, 14 } };
+   
+   sTestStruct.before = 0x12;
+   memcpy(sTestStruct.times,  times,  sizeof(times));
+   memcpy(sTestStruct.counts, counts, sizeof(counts));
+   //
+   // The first element is negative, and so is saved as zero; and the jump 
+   // to 40 is too large for 4 bits, and so is clamped. The next element is 
+   // still within reach of the clamped value, and reads back exactly.
+   //
+   sTestStruct.clamped[0] = -5;
+   sTestStruct.clamped[1] = 3;
+   sTestStruct.clamped[2] = 40;
+   sTestStruct.clamped[3] = 20;
+   sTestStruct.after = 0xBCDE;
+}
+
+int main() {
+   lu_test_check_value("Offset of sTestStruct.after", offset_of_after, 8 + (16 + 4 * 6) + 2 * (8 + 2 * 3) + (10 + 3 * 4));
+   
+   fill();
+   struct TestStruct expected = sTestStruct;
+   LU_TEST_ROUND_TRIP(generated_read, generated_save, sTestStruct, sector_buffers, 0xFF);
+   
+   bool8 same = 1;
+   same &= sTestStruct.before == expected.before;
+   same &= memcmp(sTestStruct.times,  expected.times,  sizeof(expected.times)) == 0;
+   same &= memcmp(sTestStruct.counts, expected.counts, sizeof(expected.counts)) == 0;
+   same &= sTestStruct.clamped[0] == 0;
+   same &= sTestStruct.clamped[1] == 3;
+   same &= sTestStruct.clamped[2] == 18;
+   same &= sTestStruct.clamped[3] == 20;
+   same &= sTestStruct.after == expected.after;
+   lu_test_check(same, "Delta read matches the original data");
+   
+   return lu_test_failures;
+}
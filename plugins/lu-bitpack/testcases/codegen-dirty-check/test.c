@@ -0,0 +1,163 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 5
+#define SECTOR_SIZE 12
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: dirty checks for each kind of value.
+struct PackedColor;
+struct Color;
+void PackColor(const struct Color*, struct PackedColor*);
+void UnpackColor(struct Color*, const struct PackedColor*);
+
+struct PackedColor {
+   LU_BP_BITCOUNT(15) u16 tuple;
+};
+struct LU_BP_TRANSFORM(PackColor,UnpackColor) Color {
+   u8 r;
+   u8 g;
+   u8 b;
+};
+void PackColor(const struct Color* src, struct PackedColor* dst) {
+   dst->tuple = ((src->r & 31) << 10) | ((src->g & 31) << 5) | (src->b & 31);
+}
+void UnpackColor(struct Color* dst, const struct PackedColor* src) {
+   dst->r = (src->tuple >> 10) & 31;
+   dst->g = (src->tuple >> 5) & 31;
+   dst->b = src->tuple & 31;
+}
+
+struct Item {
+   LU_BP_BITCOUNT(10) u16 id;
+   LU_BP_MINMAX(-5, 10) s8 count;
+   bool8 flag;
+};
+
+struct TestStruct {
+   LU_BP_BITCOUNT(3) u8 small;
+   u32 large;
+   LU_BP_STRING_NT u8 name[8];
+   LU_BP_STRING_UT u8 tag[4];
+   LU_BP_AS_OPAQUE_BUFFER u8 blob[3];
+   struct Item items[4];
+   struct Color color;
+   LU_BP_OMIT int scratch;
+   
+   LU_BP_MINMAX(0, 1) u8 kind;
+   LU_BP_UNION_TAG(kind) union {
+      LU_BP_TAGGED_ID(0) LU_BP_BITCOUNT(6) u8 a;
+      LU_BP_TAGGED_ID(1) u16 b;
+   } data;
+} sTestStruct;
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct,            \
+   generate_dirty_checks = true \
+)
+
+//
+// Testing:
+//
+
+#include <string.h> // memset
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void print_dirty_sectors(const char* when) {
+   printf("Dirty sectors %s:", when);
+   for(int i = 0; i < SECTOR_COUNT; ++i) {
+      if (__lu_bitpack_sector_is_dirty(sector_buffers[i], i))
+         printf(" %u", i);
+   }
+   printf("\n");
+}
+
+static void save_all(void) {
+   for(int i = 0; i < SECTOR_COUNT; ++i)
+      generated_save(sector_buffers[i], i);
+}
+
+int main() {
+   memset(&sector_buffers, 0, sizeof(sector_buffers));
+   
+   sTestStruct.small = 5;
+   sTestStruct.large = 0xDEADBEEF;
+   memcpy(sTestStruct.name, "Lu\0garbage", 8);
+   memcpy(sTestStruct.tag, "ABCD", 4);
+   sTestStruct.blob[0] = 1;
+   sTestStruct.blob[1] = 2;
+   sTestStruct.blob[2] = 3;
+   for(int i = 0; i < 4; ++i) {
+      sTestStruct.items[i].id    = 100 * i;
+      sTestStruct.items[i].count = i - 2;
+      sTestStruct.items[i].flag  = i & 1;
+   }
+   sTestStruct.color.r = 31;
+   sTestStruct.color.g = 16;
+   sTestStruct.color.b = 1;
+   sTestStruct.kind   = 1;
+   sTestStruct.data.b = 0x1234;
+   
+   print_dirty_sectors("before saving");
+   save_all();
+   print_dirty_sectors("after saving");
+   
+   //
+   // Changes that a save wouldn't write shouldn't make anything dirty.
+   //
+   sTestStruct.scratch = 12345;
+   sTestStruct.name[5] = 'X'; // after the terminator
+   sTestStruct.items[1].flag = 2; // still truthy
+   print_dirty_sectors("after changing unsaved data");
+   
+   sTestStruct.items[2].count = 7;
+   print_dirty_sectors("after changing items[2].count");
+   save_all();
+   
+   sTestStruct.data.b = 0x1235;
+   print_dirty_sectors("after changing data.b");
+   save_all();
+   
+   sTestStruct.color.g = 17;
+   print_dirty_sectors("after changing color.g");
+   save_all();
+   
+   print_dirty_sectors("after saving again");
+   
+   return 0;
+}
@@ -0,0 +1,96 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 3
+#define SECTOR_SIZE 32
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: attributes applied to every generated function.
+struct Inner {
+   LU_BP_BITCOUNT(5) u8 a;
+   u16 b;
+};
+
+struct TestStruct {
+   u32 large;
+   struct Inner inners[4];
+   LU_BP_STRING_NT u8 name[8];
+} sTestStruct;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct,            \
+   function_attributes = "section(\".text.lu_generated\"), noinline" \
+)
+
+//
+// Testing:
+//
+
+#include <string.h> // memcpy, strcmp
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+int main() {
+   lu_test_check(__builtin_has_attribute(generated_read, section(".text.lu_generated")), "generated_read is in the requested section");
+   lu_test_check(__builtin_has_attribute(generated_save, noinline), "generated_save is noinline");
+   lu_test_check(__builtin_has_attribute(__lu_bitpack_read_sector_0, section(".text.lu_generated")), "__lu_bitpack_read_sector_0 is in the requested section");
+   lu_test_check(__builtin_has_attribute(__lu_bitpack_read_Inner, section(".text.lu_generated")), "__lu_bitpack_read_Inner is in the requested section");
+   
+   sTestStruct.large = 0xDEADBEEF;
+   for(int i = 0; i < 4; ++i) {
+      sTestStruct.inners[i].a = i * 3;
+      sTestStruct.inners[i].b = 1000 + i;
+   }
+   memcpy(sTestStruct.name, "Lu\0garbage", 8);
+   
+   struct TestStruct expected = sTestStruct;
+   LU_TEST_ROUND_TRIP(generated_read, generated_save, sTestStruct, sector_buffers, 0);
+   
+   bool8 same = 1;
+   same &= sTestStruct.large == expected.large;
+   for(int i = 0; i < 4; ++i) {
+      same &= sTestStruct.inners[i].a == expected.inners[i].a;
+      same &= sTestStruct.inners[i].b == expected.inners[i].b;
+   }
+   same &= strcmp((const char*)sTestStruct.name, (const char*)expected.name) == 0;
+   lu_test_check(same, "Read matches the original data");
+   
+   return lu_test_failures;
+}
@@ -0,0 +1,122 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 2
+#define SECTOR_SIZE 32
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: sectors too large for one function, divided among several.
+struct Inner {
+   LU_BP_BITCOUNT(5) u8 a;
+   u16 b;
+};
+
+struct TestStruct {
+   u8  a;
+   u16 b;
+   u32 c;
+   LU_BP_BITCOUNT(3) u8 d;
+   LU_BP_MINMAX(-5, 10) s8 e;
+   bool8 f;
+   LU_BP_STRING_NT u8 name[8];
+   struct Inner inner;
+   u16 values[6];
+   u8  g;
+   u16 h;
+   u32 i;
+   bool8 j;
+} sTestStruct;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct,            \
+   max_statements_per_function = 3    \
+)
+
+//
+// Testing:
+//
+
+#include <string.h> // memcpy, strcmp
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void fill(void) {
+   sTestStruct.a = 0x12;
+   sTestStruct.b = 0x3456;
+   sTestStruct.c = 0xDEADBEEF;
+   sTestStruct.d = 5;
+   sTestStruct.e = -3;
+   sTestStruct.f = 1;
+   memcpy(sTestStruct.name, "Lu\0garbage", 8);
+   sTestStruct.inner.a = 17;
+   sTestStruct.inner.b = 1234;
+   for(int i = 0; i < 6; ++i)
+      sTestStruct.values[i] = 100 + i * 17;
+   sTestStruct.g = 0x9A;
+   sTestStruct.h = 0xBCDE;
+   sTestStruct.i = 0x01020304;
+   sTestStruct.j = 1;
+}
+
+int main() {
+   fill();
+   struct TestStruct expected = sTestStruct;
+   LU_TEST_ROUND_TRIP(generated_read, generated_save, sTestStruct, sector_buffers, 0);
+   
+   bool8 same = 1;
+   same &= sTestStruct.a == expected.a;
+   same &= sTestStruct.b == expected.b;
+   same &= sTestStruct.c == expected.c;
+   same &= sTestStruct.d == expected.d;
+   same &= sTestStruct.e == expected.e;
+   same &= sTestStruct.f == expected.f;
+   same &= strcmp((const char*)sTestStruct.name, (const char*)expected.name) == 0;
+   same &= sTestStruct.inner.a == expected.inner.a;
+   same &= sTestStruct.inner.b == expected.inner.b;
+   for(int i = 0; i < 6; ++i)
+      same &= sTestStruct.values[i] == expected.values[i];
+   same &= sTestStruct.g == expected.g;
+   same &= sTestStruct.h == expected.h;
+   same &= sTestStruct.i == expected.i;
+   same &= sTestStruct.j == expected.j;
+   lu_test_check(same, "Split read matches the original data");
+   
+   return lu_test_failures;
+}
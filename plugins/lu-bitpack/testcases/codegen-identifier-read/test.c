@@ -0,0 +1,158 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 6
+#define SECTOR_SIZE 8
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: reading one top-level identifier without fetching unrelated sectors.
+struct Party {
+   LU_BP_BITCOUNT(3) u8 count;
+   LU_BP_STRING_NT u8 name[5];
+   LU_BP_BITCOUNT(27) u32 money;
+} sParty;
+
+struct Options {
+   LU_BP_BITCOUNT(5) u8 speed;
+   bool8 sound;
+} sOptions;
+
+struct Storage {
+   LU_BP_BITCOUNT(10) u16 boxes[12];
+} sStorage;
+
+// Testcase: an identifier that follows a union and an omitted-but-defaulted 
+// field in the same sector. The union takes up only as much space as its 
+// largest branch, and the omitted field takes up none.
+struct {
+   LU_BP_BITCOUNT(2) u8 tag;
+   LU_BP_UNION_TAG(tag) union {
+      LU_BP_TAGGED_ID(0) LU_BP_BITCOUNT(5)  u8  small;
+      LU_BP_TAGGED_ID(1) LU_BP_BITCOUNT(11) u16 large;
+   } data;
+   LU_BP_OMIT LU_BP_DEFAULT("Ana") LU_BP_STRING char name[4];
+} sHeader;
+
+struct Trailer {
+   LU_BP_BITCOUNT(12) u16 value;
+} sTrailer;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sParty sOptions | sStorage | sHeader sTrailer, \
+   generate_identifier_reads = true \
+)
+
+//
+// Testing:
+//
+
+#include <string.h> // memcpy, memset
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static const void* get_sector(int sector_id) {
+   printf(" %u", sector_id);
+   return sector_buffers[sector_id];
+}
+
+int main() {
+   memset(&sector_buffers, 0, sizeof(sector_buffers));
+   
+   sParty.count = 5;
+   sParty.money = 123456;
+   memcpy(sParty.name, "Lu\0gar", 5);
+   sOptions.speed = 17;
+   sOptions.sound = 1;
+   for(int i = 0; i < 12; ++i)
+      sStorage.boxes[i] = 80 * i + 3;
+   sHeader.tag        = 1;
+   sHeader.data.large = 1500;
+   sTrailer.value     = 2701;
+   
+   for(int i = 0; i < SECTOR_COUNT; ++i)
+      generated_save(sector_buffers[i], i);
+   
+   printf("sParty spans sectors %u through %u\n", (int)__lu_bitpack_first_sector_of_sParty, (int)(__lu_bitpack_first_sector_of_sParty + __lu_bitpack_sector_count_of_sParty - 1));
+   printf("sOptions spans sectors %u through %u\n", (int)__lu_bitpack_first_sector_of_sOptions, (int)(__lu_bitpack_first_sector_of_sOptions + __lu_bitpack_sector_count_of_sOptions - 1));
+   printf("sStorage spans sectors %u through %u\n", (int)__lu_bitpack_first_sector_of_sStorage, (int)(__lu_bitpack_first_sector_of_sStorage + __lu_bitpack_sector_count_of_sStorage - 1));
+   printf("sTrailer spans sectors %u through %u\n", (int)__lu_bitpack_first_sector_of_sTrailer, (int)(__lu_bitpack_first_sector_of_sTrailer + __lu_bitpack_sector_count_of_sTrailer - 1));
+   
+   //
+   // Clobber the live data, and then read each identifier back on its own. 
+   // Identifiers that we haven't read yet should stay clobbered.
+   //
+   memset(&sParty,   0xFF, sizeof(sParty));
+   memset(&sOptions, 0xFF, sizeof(sOptions));
+   memset(&sStorage, 0xFF, sizeof(sStorage));
+   memset(&sHeader,  0xFF, sizeof(sHeader));
+   memset(&sTrailer, 0xFF, sizeof(sTrailer));
+   
+   printf("Reading sOptions; fetched sectors:");
+   __lu_bitpack_read_sOptions(get_sector);
+   printf("\n");
+   printf("sOptions: speed %u, sound %u\n", sOptions.speed, sOptions.sound);
+   printf("sParty.count is still %u\n", sParty.count);
+   
+   printf("Reading sStorage; fetched sectors:");
+   __lu_bitpack_read_sStorage(get_sector);
+   printf("\n");
+   printf("sStorage:");
+   for(int i = 0; i < 12; ++i)
+      printf(" %u", sStorage.boxes[i]);
+   printf("\n");
+   
+   printf("Reading sParty; fetched sectors:");
+   __lu_bitpack_read_sParty(get_sector);
+   printf("\n");
+   printf("sParty: count %u, money %u, name %s\n", sParty.count, sParty.money, (const char*)sParty.name);
+   
+   printf("Reading sTrailer; fetched sectors:");
+   __lu_bitpack_read_sTrailer(get_sector);
+   printf("\n");
+   printf("sTrailer: value %u\n", sTrailer.value);
+   printf("sHeader.tag is still %u\n", sHeader.tag);
+   
+   printf("Reading sHeader; fetched sectors:");
+   __lu_bitpack_read_sHeader(get_sector);
+   printf("\n");
+   printf("sHeader: tag %u, large %u, name %.3s\n", sHeader.tag, sHeader.data.large, sHeader.name);
+   
+   return 0;
+}
@@ -49,6 +49,7 @@ extern void generated_save(u8* dst, int sector_id);
 #pragma lu_bitpack generate_functions( \
    read_name = generated_read,         \
    save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
    data      = sTestStruct             \
 )
 //#pragma lu_bitpack debug_dump_function generated_read
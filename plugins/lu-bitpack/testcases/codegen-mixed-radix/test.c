@@ -0,0 +1,136 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 1
+#define SECTOR_SIZE 32
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: members of a struct packed together as one mixed-radix integer.
+struct __attribute__((lu_bitpack_mixed_radix)) Dice {
+   LU_BP_MINMAX(0, 4) u8 a;
+   LU_BP_MINMAX(0, 4) u8 b;
+   LU_BP_MINMAX(0, 4) u8 c;
+   LU_BP_MINMAX(-5, 5) s8 d;
+   bool8 e;
+   LU_BP_MINMAX(1, 6) u8 rolls[3];
+};
+
+struct TestStruct {
+   u8 before;
+   struct Dice dice;
+   struct Dice clamped;
+   u16 after;
+} sTestStruct;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct             \
+)
+
+// 5 * 5 * 5 * 11 * 2 * 6 * 6 * 6 = 594000 values, which fit in 20 bits.
+// Packed separately, the members would take 3 + 3 + 3 + 4 + 1 + 3*3 = 23.
+const unsigned int offset_of_after;
+#pragma lu_bitpack serialized_offset_to_constant offset_of_after sTestStruct.after
+
+//
+// Testing:
+//
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void fill(void) {
+   sTestStruct.before = 0x12;
+   
+   sTestStruct.dice.a = 4;
+   sTestStruct.dice.b = 0;
+   sTestStruct.dice.c = 3;
+   sTestStruct.dice.d = -4;
+   sTestStruct.dice.e = 1;
+   sTestStruct.dice.rolls[0] = 6;
+   sTestStruct.dice.rolls[1] = 1;
+   sTestStruct.dice.rolls[2] = 5;
+   
+   sTestStruct.clamped.a = 9;
+   sTestStruct.clamped.b = 2;
+   sTestStruct.clamped.c = 200;
+   sTestStruct.clamped.d = 7;
+   sTestStruct.clamped.e = 0;
+   sTestStruct.clamped.rolls[0] = 3;
+   sTestStruct.clamped.rolls[1] = 12;
+   sTestStruct.clamped.rolls[2] = 2;
+   
+   sTestStruct.after = 0xBCDE;
+}
+
+static bool8 dice_equal(const struct Dice* a, const struct Dice* b) {
+   bool8 same = 1;
+   same &= a->a == b->a;
+   same &= a->b == b->b;
+   same &= a->c == b->c;
+   same &= a->d == b->d;
+   same &= a->e == b->e;
+   for(int i = 0; i < 3; ++i)
+      same &= a->rolls[i] == b->rolls[i];
+   return same;
+}
+
+int main() {
+   lu_test_check_value("Offset of sTestStruct.after", offset_of_after, 8 + 20 + 20);
+   
+   fill();
+   struct TestStruct expected = sTestStruct;
+   LU_TEST_ROUND_TRIP(generated_read, generated_save, sTestStruct, sector_buffers, 0);
+   
+   //
+   // Out-of-range values are clamped to the top of their range on save.
+   //
+   expected.clamped.a = 4;
+   expected.clamped.c = 4;
+   expected.clamped.d = 5;
+   expected.clamped.rolls[1] = 6;
+   
+   bool8 same = 1;
+   same &= sTestStruct.before == expected.before;
+   same &= dice_equal(&sTestStruct.dice, &expected.dice);
+   same &= sTestStruct.after == expected.after;
+   lu_test_check(same, "Mixed-radix read matches the original data");
+   lu_test_check(dice_equal(&sTestStruct.clamped, &expected.clamped), "Out-of-range values were clamped");
+   
+   return lu_test_failures;
+}
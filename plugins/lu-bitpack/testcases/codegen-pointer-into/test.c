@@ -0,0 +1,114 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 1
+#define SECTOR_SIZE 32
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: pointers into known arrays, saved as indices.
+struct Node {
+   u16 value;
+   u8  next;
+};
+struct Node gNodes[100];
+const char* const gNames[3] = { "first", "second", "third" };
+
+struct TestStruct {
+   u8 before;
+   LU_BP_POINTER_INTO(gNodes) struct Node* cursor;
+   LU_BP_POINTER_INTO(gNodes) struct Node* empty;
+   LU_BP_POINTER_INTO(gNodes) const struct Node* last;
+   LU_BP_POINTER_INTO(gNodes) struct Node* stray;
+   LU_BP_POINTER_INTO("gNames") const char* const* names[2];
+   u16 after;
+} sTestStruct;
+
+static struct Node sStrayNode;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct             \
+)
+
+// 8 bits for `before`; 7 bits (for 100 elements plus null) for each of the 4 
+// node pointers; and 2 bits (for 3 elements plus null) for each name pointer.
+const unsigned int offset_of_after;
+#pragma lu_bitpack serialized_offset_to_constant offset_of_after sTestStruct.after
+
+//
+// Testing:
+//
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void fill(void) {
+   sTestStruct.before   = 0x12;
+   sTestStruct.cursor   = &gNodes[42];
+   sTestStruct.empty    = NULL;
+   sTestStruct.last     = &gNodes[99];
+   sTestStruct.stray    = &sStrayNode; // not in the array; saved as null
+   sTestStruct.names[0] = &gNames[2];
+   sTestStruct.names[1] = &gNames[0];
+   sTestStruct.after    = 0xBCDE;
+}
+
+int main() {
+   lu_test_check_value("Offset of sTestStruct.after", offset_of_after, 8 + 7 * 4 + 2 * 2);
+   
+   //
+   // We clobber the data with non-null garbage before reading it back, so 
+   // that null pointers have to be written.
+   //
+   fill();
+   struct TestStruct expected = sTestStruct;
+   LU_TEST_ROUND_TRIP(generated_read, generated_save, sTestStruct, sector_buffers, 0xFF);
+   
+   bool8 same = 1;
+   same &= sTestStruct.before == expected.before;
+   same &= sTestStruct.cursor == &gNodes[42];
+   same &= sTestStruct.empty == NULL;
+   same &= sTestStruct.last == &gNodes[99];
+   same &= sTestStruct.stray == NULL;
+   same &= sTestStruct.names[0] == &gNames[2];
+   same &= sTestStruct.names[1] == &gNames[0];
+   same &= sTestStruct.after == expected.after;
+   lu_test_check(same, "Pointer read matches the original data");
+   
+   return lu_test_failures;
+}
@@ -0,0 +1,110 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 1
+#define SECTOR_SIZE 32
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: floats and wide integers quantized into fixed bit widths.
+struct TestStruct {
+   u8 before;
+   LU_BP_QUANTIZE(-1024.0, 1024.0, 16) float position[3];
+   LU_BP_QUANTIZE(0, 1, 10) float speed;
+   LU_BP_QUANTIZE(0, 65535, 10) u32 timer;
+   LU_BP_QUANTIZE(-1000, 1000, 8) s16 offset;
+   LU_BP_QUANTIZE(0.0, 1.0, 12) double ratio;
+   u16 after;
+} sTestStruct;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct             \
+)
+
+// 8 bits for `before`; 16 bits for each of the 3 positions; 10 bits each for 
+// `speed` and `timer`; 8 bits for `offset`; and 12 bits for `ratio`.
+const unsigned int offset_of_after;
+#pragma lu_bitpack serialized_offset_to_constant offset_of_after sTestStruct.after
+
+//
+// Testing:
+//
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void fill(void) {
+   sTestStruct.before      = 0x12;
+   sTestStruct.position[0] = 0.5f;
+   sTestStruct.position[1] = -1024.0f;
+   sTestStruct.position[2] = 2000.0f; // out of range; saved as 1024
+   sTestStruct.speed       = 0.25f;
+   sTestStruct.timer       = 12345; // saved in buckets of 64; reads back as 12288
+   sTestStruct.offset      = -3;    // saved in buckets of 8; reads back as -8
+   sTestStruct.ratio       = 0.1;
+   sTestStruct.after       = 0xBCDE;
+}
+
+static bool8 near(double a, double b, double step) {
+   double d = a - b;
+   if (d < 0)
+      d = -d;
+   return d <= step / 2 + step / 1000;
+}
+
+int main() {
+   lu_test_check_value("Offset of sTestStruct.after", offset_of_after, 8 + 16 * 3 + 10 + 10 + 8 + 12);
+   
+   fill();
+   struct TestStruct expected = sTestStruct;
+   LU_TEST_ROUND_TRIP(generated_read, generated_save, sTestStruct, sector_buffers, 0);
+   
+   bool8 same = 1;
+   same &= sTestStruct.before == expected.before;
+   same &= near(sTestStruct.position[0], 0.5, 2048.0 / 65535);
+   same &= sTestStruct.position[1] == -1024.0f;
+   same &= near(sTestStruct.position[2], 1024.0, 2048.0 / 65535);
+   same &= near(sTestStruct.speed, 0.25, 1.0 / 1023);
+   same &= sTestStruct.timer == 12288;
+   same &= sTestStruct.offset == -8;
+   same &= near(sTestStruct.ratio, 0.1, 1.0 / 4095);
+   same &= sTestStruct.after == expected.after;
+   lu_test_check(same, "Quantized read matches the original data");
+   
+   return lu_test_failures;
+}
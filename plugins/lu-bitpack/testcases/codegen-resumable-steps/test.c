@@ -0,0 +1,190 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 3
+#define SECTOR_SIZE 32
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: resumable step functions that read and save a bounded number of 
+// bits per call.
+struct Item {
+   LU_BP_BITCOUNT(10) u16 id;
+   LU_BP_MINMAX(-5, 10) s8 count;
+   bool8 flag;
+};
+
+struct TestStruct {
+   LU_BP_BITCOUNT(3) u8 small;
+   u32 large;
+   LU_BP_STRING_NT u8 name[8];
+   struct Item items[12];
+   
+   LU_BP_MINMAX(0, 1) u8 kind;
+   LU_BP_UNION_TAG(kind) union {
+      LU_BP_TAGGED_ID(0) LU_BP_BITCOUNT(6) u8 a;
+      LU_BP_TAGGED_ID(1) u16 b;
+   } data;
+   
+   // A union larger than a step. Its branches overlap one another, so they 
+   // must all be kept in the same step.
+   LU_BP_MINMAX(0, 1) u8 shape;
+   LU_BP_UNION_TAG(shape) union {
+      LU_BP_TAGGED_ID(0) struct {
+         u32 x;
+         u32 y;
+      } point;
+      LU_BP_TAGGED_ID(1) struct {
+         u16 w;
+         u16 h;
+         u32 area;
+      } box;
+   } big;
+   
+   u8 bytes[40];
+} sTestStruct;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct,            \
+   resumable_step_size = 48 \
+)
+
+//
+// Testing:
+//
+
+#include <string.h> // memcmp, memcpy, memset, strcmp
+
+static u8 expected_buffers[SECTOR_COUNT][SECTOR_SIZE];
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void fill(void) {
+   sTestStruct.small = 5;
+   sTestStruct.large = 0xDEADBEEF;
+   memcpy(sTestStruct.name, "Lu\0garbage", 8);
+   for(int i = 0; i < 12; ++i) {
+      sTestStruct.items[i].id    = 50 * i;
+      sTestStruct.items[i].count = (i % 16) - 5;
+      sTestStruct.items[i].flag  = i & 1;
+   }
+   sTestStruct.kind   = 1;
+   sTestStruct.data.b = 0x1234;
+   sTestStruct.shape        = 1;
+   sTestStruct.big.box.w    = 300;
+   sTestStruct.big.box.h    = 200;
+   sTestStruct.big.box.area = 60000;
+   for(int i = 0; i < 40; ++i)
+      sTestStruct.bytes[i] = i * 7;
+}
+
+int main() {
+   fill();
+   struct TestStruct expected = sTestStruct;
+   LU_TEST_ROUND_TRIP(generated_read, generated_save, sTestStruct, expected_buffers, 0);
+   
+   //
+   // Save each sector in small steps, and check that we get the same bytes 
+   // as a one-shot save.
+   //
+   for(int i = 0; i < SECTOR_COUNT; ++i) {
+      struct lu_BitstreamState state;
+      int cursor = 0;
+      int calls  = 1;
+      lu_BitstreamInitialize(&state, sector_buffers[i]);
+      while (!__lu_bitpack_save_step(&state, i, &cursor, 64))
+         ++calls;
+      printf("Saved sector %u in %u calls.\n", i, calls);
+   }
+   lu_test_check(
+      memcmp(expected_buffers, sector_buffers, sizeof(sector_buffers)) == 0,
+      "Stepped save matches one-shot save"
+   );
+   
+   //
+   // Read each sector back in small steps.
+   //
+   memset(&sTestStruct, 0, sizeof(sTestStruct));
+   for(int i = 0; i < SECTOR_COUNT; ++i) {
+      struct lu_BitstreamState state;
+      int cursor = 0;
+      int calls  = 1;
+      lu_BitstreamInitialize(&state, sector_buffers[i]);
+      while (!__lu_bitpack_read_step(&state, i, &cursor, 64))
+         ++calls;
+      printf("Read sector %u in %u calls.\n", i, calls);
+   }
+   {
+      bool8 same = 1;
+      same &= sTestStruct.small == expected.small;
+      same &= sTestStruct.large == expected.large;
+      same &= strcmp((const char*)sTestStruct.name, (const char*)expected.name) == 0;
+      for(int i = 0; i < 12; ++i) {
+         same &= sTestStruct.items[i].id    == expected.items[i].id;
+         same &= sTestStruct.items[i].count == expected.items[i].count;
+         same &= sTestStruct.items[i].flag  == expected.items[i].flag;
+      }
+      same &= sTestStruct.kind   == expected.kind;
+      same &= sTestStruct.data.b == expected.data.b;
+      same &= sTestStruct.shape        == expected.shape;
+      same &= sTestStruct.big.box.w    == expected.big.box.w;
+      same &= sTestStruct.big.box.h    == expected.big.box.h;
+      same &= sTestStruct.big.box.area == expected.big.box.area;
+      same &= memcmp(sTestStruct.bytes, expected.bytes, 40) == 0;
+      lu_test_check(same, "Stepped read matches the original data");
+   }
+   
+   //
+   // A budget of zero still makes progress, one step per call.
+   //
+   {
+      struct lu_BitstreamState state;
+      int cursor = 0;
+      int calls  = 1;
+      lu_BitstreamInitialize(&state, sector_buffers[0]);
+      while (!__lu_bitpack_save_step(&state, 0, &cursor, 0))
+         ++calls;
+      printf("Saved sector 0 with no budget in %u calls.\n", calls);
+   }
+   lu_test_check(
+      memcmp(expected_buffers, sector_buffers, sizeof(sector_buffers)) == 0,
+      "Stepped save with no budget matches one-shot save"
+   );
+   
+   return lu_test_failures;
+}
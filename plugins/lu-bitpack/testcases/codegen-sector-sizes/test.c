@@ -0,0 +1,118 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 3
+#define SECTOR_SIZE 4 // largest sector
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_sizes=(4, 2, 4), \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: sectors of differing sizes.
+struct TestStruct {
+   u32 a; // sector 0
+   u16 b; // sector 1
+   u8  c; // sector 2, since sector 1 only has room for `b`
+   u16 d;
+   u8  e;
+} sTestStruct;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct             \
+)
+
+const unsigned int sector_of_c;
+const unsigned int sector_of_e;
+const unsigned int offset_of_e;
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_c sTestStruct.c
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_e sTestStruct.e
+#pragma lu_bitpack serialized_offset_to_constant    offset_of_e sTestStruct.e
+
+//
+// Testing:
+//
+
+#include <string.h> // memset
+
+#define GUARD_BYTE 0xAA
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void fill(void) {
+   sTestStruct.a = 0x12345678;
+   sTestStruct.b = 0x9ABC;
+   sTestStruct.c = 0xDE;
+   sTestStruct.d = 0xF012;
+   sTestStruct.e = 0x34;
+}
+
+static bool8 matches(const struct TestStruct* expected) {
+   bool8 same = 1;
+   same &= sTestStruct.a == expected->a;
+   same &= sTestStruct.b == expected->b;
+   same &= sTestStruct.c == expected->c;
+   same &= sTestStruct.d == expected->d;
+   same &= sTestStruct.e == expected->e;
+   return same;
+}
+
+int main() {
+   lu_test_check_value("Sector count", __lu_bitpack_sector_count, SECTOR_COUNT);
+   lu_test_check_value("Max sector size", __lu_bitpack_max_sector_size, SECTOR_SIZE);
+   lu_test_check_value("Size of sector 0", __lu_bitpack_sector_sizes[0], 4);
+   lu_test_check_value("Size of sector 1", __lu_bitpack_sector_sizes[1], 2);
+   lu_test_check_value("Size of sector 2", __lu_bitpack_sector_sizes[2], 4);
+   lu_test_check_value("Sector of sTestStruct.c", sector_of_c, 2);
+   lu_test_check_value("Sector of sTestStruct.e", sector_of_e, 2);
+   lu_test_check_value("Offset of sTestStruct.e", offset_of_e, 24);
+   
+   memset(&sector_buffers, GUARD_BYTE, sizeof(sector_buffers));
+   
+   fill();
+   struct TestStruct expected = sTestStruct;
+   LU_TEST_ROUND_TRIP(generated_read, generated_save, sTestStruct, sector_buffers, 0);
+   lu_test_check(matches(&expected), "Read matches the original data");
+   
+   //
+   // Sector 1 is only two bytes long, so nothing should be written past that.
+   //
+   lu_test_check(
+      sector_buffers[1][2] == GUARD_BYTE && sector_buffers[1][3] == GUARD_BYTE,
+      "Save stayed within the bounds of sector 1"
+   );
+   
+   return lu_test_failures;
+}
@@ -0,0 +1,138 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 5
+#define SECTOR_SIZE 12
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: setters that overwrite single values within a saved sector.
+struct Item {
+   LU_BP_BITCOUNT(10) u16 id;
+   LU_BP_MINMAX(-5, 10) s8 count;
+   bool8 flag;
+};
+
+struct TestStruct {
+   LU_BP_BITCOUNT(3) u8 small;
+   LU_BP_MINMAX(1000, 1500) u16 ranged;
+   LU_BP_STRING_NT u8 name[8];
+   struct Item items[4];
+   u32 large;
+} sTestStruct;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct             \
+)
+
+#pragma lu_bitpack generate_setter SetSmall  sTestStruct.small
+#pragma lu_bitpack generate_setter SetRanged sTestStruct.ranged
+#pragma lu_bitpack generate_setter SetName   sTestStruct.name
+#pragma lu_bitpack generate_setter SetItem2  sTestStruct.items[2]
+#pragma lu_bitpack generate_setter SetCount3 sTestStruct.items[3].count
+
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_small  sTestStruct.small
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_ranged sTestStruct.ranged
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_name   sTestStruct.name
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_item2  sTestStruct.items[2]
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_count3 sTestStruct.items[3].count
+
+//
+// Testing:
+//
+
+#include <string.h> // memcmp, memcpy, memset
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+static u8 expected_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void compare(const char* when) {
+   for(int i = 0; i < SECTOR_COUNT; ++i)
+      generated_save(expected_buffers[i], i);
+   printf("Sectors that differ from a full save %s:", when);
+   for(int i = 0; i < SECTOR_COUNT; ++i) {
+      if (memcmp(sector_buffers[i], expected_buffers[i], SECTOR_SIZE))
+         printf(" %u", i);
+   }
+   printf("\n");
+}
+
+int main() {
+   memset(&sector_buffers, 0, sizeof(sector_buffers));
+   memset(&expected_buffers, 0, sizeof(expected_buffers));
+   
+   sTestStruct.small  = 5;
+   sTestStruct.ranged = 1234;
+   memcpy(sTestStruct.name, "Lu\0garbage", 8);
+   for(int i = 0; i < 4; ++i) {
+      sTestStruct.items[i].id    = 100 * i;
+      sTestStruct.items[i].count = i - 2;
+      sTestStruct.items[i].flag  = i & 1;
+   }
+   sTestStruct.large = 0xDEADBEEF;
+   
+   for(int i = 0; i < SECTOR_COUNT; ++i)
+      generated_save(sector_buffers[i], i);
+   compare("after saving");
+   
+   sTestStruct.small = 2;
+   SetSmall(sector_buffers[sector_of_small], 2);
+   compare("after setting small");
+   
+   sTestStruct.ranged = 1499;
+   SetRanged(sector_buffers[sector_of_ranged], 1499);
+   compare("after setting ranged");
+   
+   memcpy(sTestStruct.name, "Bitpack", 8);
+   SetName(sector_buffers[sector_of_name], (const u8*)"Bitpack");
+   compare("after setting name");
+   
+   {
+      struct Item item = { .id = 1023, .count = 10, .flag = 1 };
+      sTestStruct.items[2] = item;
+      SetItem2(sector_buffers[sector_of_item2], item);
+   }
+   compare("after setting items[2]");
+   
+   sTestStruct.items[3].count = -5;
+   SetCount3(sector_buffers[sector_of_count3], -5);
+   compare("after setting items[3].count");
+   
+   return 0;
+}
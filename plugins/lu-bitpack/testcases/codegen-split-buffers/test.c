@@ -0,0 +1,118 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 3
+#define SECTOR_SIZE 4
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: opaque buffers and unterminated strings split across sector 
+// boundaries.
+struct TestStruct {
+   u8 a;
+   LU_BP_AS_OPAQUE_BUFFER struct {
+      u8 bytes[6];
+   } buf; // 3 bytes in sector 0; 3 bytes in sector 1
+   LU_BP_STRING_UT char name[4]; // 1 byte in sector 1; 3 bytes in sector 2
+   u8 after;
+} sTestStruct;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+// Without `split_buffers_across_sectors`, this would be an error, as `buf` 
+// is larger than a whole sector.
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct,            \
+   split_buffers_across_sectors = true \
+)
+
+const unsigned int sector_of_name;
+const unsigned int offset_of_name;
+const unsigned int sector_of_after;
+const unsigned int offset_of_after;
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_name  sTestStruct.name
+#pragma lu_bitpack serialized_offset_to_constant    offset_of_name  sTestStruct.name
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_after sTestStruct.after
+#pragma lu_bitpack serialized_offset_to_constant    offset_of_after sTestStruct.after
+
+//
+// Testing:
+//
+
+#include <string.h> // memcmp, memcpy, memset
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void fill(void) {
+   sTestStruct.a = 0x12;
+   for(int i = 0; i < 6; ++i)
+      sTestStruct.buf.bytes[i] = 0xA0 + i;
+   memcpy(sTestStruct.name, "Lucy", 4);
+   sTestStruct.after = 0x34;
+}
+
+static bool8 matches(const struct TestStruct* expected) {
+   bool8 same = 1;
+   same &= sTestStruct.a == expected->a;
+   same &= memcmp(sTestStruct.buf.bytes, expected->buf.bytes, 6) == 0;
+   same &= memcmp(sTestStruct.name, expected->name, 4) == 0;
+   same &= sTestStruct.after == expected->after;
+   return same;
+}
+
+int main() {
+   lu_test_check_value("Sector of sTestStruct.name", sector_of_name, 1);
+   lu_test_check_value("Offset of sTestStruct.name", offset_of_name, 24);
+   lu_test_check_value("Sector of sTestStruct.after", sector_of_after, 2);
+   lu_test_check_value("Offset of sTestStruct.after", offset_of_after, 24);
+   
+   //
+   // Each sector only touches the bytes that it holds, so sectors should be 
+   // readable in any order.
+   //
+   fill();
+   struct TestStruct expected = sTestStruct;
+   LU_TEST_ROUND_TRIP(generated_read, generated_save, sTestStruct, sector_buffers, 0xFF);
+   lu_test_check(matches(&expected), "Read matches the original data");
+   
+   memset(&sTestStruct, 0xFF, sizeof(sTestStruct));
+   for(int i = SECTOR_COUNT - 1; i >= 0; --i)
+      generated_read(sector_buffers[i], i);
+   lu_test_check(matches(&expected), "Read in reverse sector order matches the original data");
+   
+   return lu_test_failures;
+}
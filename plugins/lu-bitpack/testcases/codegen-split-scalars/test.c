@@ -0,0 +1,115 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 3
+#define SECTOR_SIZE 4
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: integers split across sector boundaries.
+struct TestStruct {
+   u8 a;
+   LU_BP_BITCOUNT(20) u32 b;
+   u16 c; // low 4 bits in sector 0; high 12 bits in sector 1
+   LU_BP_MINMAX(-1000, 1000) s16 d;
+   LU_BP_BITCOUNT(20) u32 e; // low 9 bits in sector 1; high 11 bits in sector 2
+   bool8 f;
+} sTestStruct;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct,            \
+   split_scalars_across_sectors = true \
+)
+
+// Were `e` moved to the next sector whole, `f` would follow all 20 of its 
+// bits; instead, it follows only the 11 bits that spilled over.
+const unsigned int sector_of_f;
+const unsigned int offset_of_f;
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_f sTestStruct.f
+#pragma lu_bitpack serialized_offset_to_constant    offset_of_f sTestStruct.f
+
+//
+// Testing:
+//
+
+#include <string.h> // memset
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void fill(void) {
+   sTestStruct.a = 0x12;
+   sTestStruct.b = 0xABCDE;
+   sTestStruct.c = 0xF00D;
+   sTestStruct.d = -777;
+   sTestStruct.e = 0x98765;
+   sTestStruct.f = 1;
+}
+
+static bool8 matches(const struct TestStruct* expected) {
+   bool8 same = 1;
+   same &= sTestStruct.a == expected->a;
+   same &= sTestStruct.b == expected->b;
+   same &= sTestStruct.c == expected->c;
+   same &= sTestStruct.d == expected->d;
+   same &= sTestStruct.e == expected->e;
+   same &= sTestStruct.f == expected->f;
+   return same;
+}
+
+int main() {
+   lu_test_check_value("Sector of sTestStruct.f", sector_of_f, 2);
+   lu_test_check_value("Offset of sTestStruct.f", offset_of_f, 11);
+   
+   //
+   // Each half of a split value is combined with whatever the value already 
+   // holds, so garbage shouldn't survive, and sectors should be readable in 
+   // any order.
+   //
+   fill();
+   struct TestStruct expected = sTestStruct;
+   LU_TEST_ROUND_TRIP(generated_read, generated_save, sTestStruct, sector_buffers, 0xFF);
+   lu_test_check(matches(&expected), "Read matches the original data");
+   
+   memset(&sTestStruct, 0xFF, sizeof(sTestStruct));
+   for(int i = SECTOR_COUNT - 1; i >= 0; --i)
+      generated_read(sector_buffers[i], i);
+   lu_test_check(matches(&expected), "Read in reverse sector order matches the original data");
+   
+   return lu_test_failures;
+}
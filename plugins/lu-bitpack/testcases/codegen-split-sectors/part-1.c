@@ -0,0 +1,9 @@
+#include "layout.h"
+
+#pragma lu_bitpack generate_functions( \
+   read_name   = generated_read, \
+   save_name   = generated_save, \
+   data        = sTestStruct,    \
+   sectors     = 1-2,            \
+   emit_shared = false           \
+)
@@ -0,0 +1,47 @@
+#include "layout.h"
+
+struct TestStruct sTestStruct;
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read, \
+   save_name = generated_save, \
+   data      = sTestStruct,    \
+   sectors   = 0               \
+)
+
+//
+// Testing:
+//
+
+#include <string.h> // memcmp, memcpy, strcmp
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void fill(void) {
+   sTestStruct.large = 0xDEADBEEF;
+   for(int i = 0; i < 8; ++i) {
+      sTestStruct.inners[i].a = i * 3;
+      sTestStruct.inners[i].b = 1000 + i;
+   }
+   memcpy(sTestStruct.name, "Lu\0garbagegarbag", 16);
+   for(int i = 0; i < 24; ++i)
+      sTestStruct.bytes[i] = i * 7;
+}
+
+int main() {
+   fill();
+   struct TestStruct expected = sTestStruct;
+   LU_TEST_ROUND_TRIP(generated_read, generated_save, sTestStruct, sector_buffers, 0);
+   
+   bool8 same = 1;
+   same &= sTestStruct.large == expected.large;
+   for(int i = 0; i < 8; ++i) {
+      same &= sTestStruct.inners[i].a == expected.inners[i].a;
+      same &= sTestStruct.inners[i].b == expected.inners[i].b;
+   }
+   same &= strcmp((const char*)sTestStruct.name, (const char*)expected.name) == 0;
+   same &= memcmp(sTestStruct.bytes, expected.bytes, 24) == 0;
+   lu_test_check(same, "Read matches the original data");
+   
+   return lu_test_failures;
+}
@@ -0,0 +1,150 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 3
+#define SECTOR_SIZE 4
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: a tagged union split across sector boundaries.
+struct TestStruct {
+   u8 a;
+   LU_BP_BITCOUNT(2) u8 tag;
+   LU_BP_UNION_TAG(tag) union {
+      LU_BP_TAGGED_ID(0) struct {
+         u8  x; // sector 0
+         u16 y; // sector 1
+         u16 z; // sector 1
+      } first;
+      LU_BP_TAGGED_ID(1) struct {
+         u16 p;    // sector 0
+         u8  q[3]; // sector 1
+      } second;
+      LU_BP_TAGGED_ID(2) u8 third; // sector 0
+   } data;
+   u8 after;
+} sTestStruct;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+// Without `split_unions_across_sectors`, this would be an error, as `data` 
+// is larger than a whole sector.
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct,            \
+   split_unions_across_sectors = true  \
+)
+
+// Within each sector, the union's members are padded to the same length as 
+// the longest of them (16 bits in sector 0; 32 bits in sector 1), so `after` 
+// starts sector 2.
+const unsigned int sector_of_after;
+const unsigned int offset_of_after;
+#pragma lu_bitpack serialized_sector_id_to_constant sector_of_after sTestStruct.after
+#pragma lu_bitpack serialized_offset_to_constant    offset_of_after sTestStruct.after
+
+//
+// Testing:
+//
+
+#include <string.h> // memcmp, memset
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void fill(u8 tag) {
+   memset(&sTestStruct, 0, sizeof(sTestStruct));
+   sTestStruct.a   = 0x12;
+   sTestStruct.tag = tag;
+   switch (tag) {
+      case 0:
+         sTestStruct.data.first.x = 0x34;
+         sTestStruct.data.first.y = 0x5678;
+         sTestStruct.data.first.z = 0x9ABC;
+         break;
+      case 1:
+         sTestStruct.data.second.p    = 0xDEF0;
+         sTestStruct.data.second.q[0] = 0x11;
+         sTestStruct.data.second.q[1] = 0x22;
+         sTestStruct.data.second.q[2] = 0x33;
+         break;
+      case 2:
+         sTestStruct.data.third = 0x44;
+         break;
+   }
+   sTestStruct.after = 0x55;
+}
+
+static bool8 matches(const struct TestStruct* expected) {
+   bool8 same = 1;
+   same &= sTestStruct.a     == expected->a;
+   same &= sTestStruct.tag   == expected->tag;
+   same &= sTestStruct.after == expected->after;
+   switch (expected->tag) {
+      case 0:
+         same &= sTestStruct.data.first.x == expected->data.first.x;
+         same &= sTestStruct.data.first.y == expected->data.first.y;
+         same &= sTestStruct.data.first.z == expected->data.first.z;
+         break;
+      case 1:
+         same &= sTestStruct.data.second.p == expected->data.second.p;
+         same &= memcmp(sTestStruct.data.second.q, expected->data.second.q, 3) == 0;
+         break;
+      case 2:
+         same &= sTestStruct.data.third == expected->data.third;
+         break;
+   }
+   return same;
+}
+
+int main() {
+   lu_test_check_value("Sector of sTestStruct.after", sector_of_after, 2);
+   lu_test_check_value("Offset of sTestStruct.after", offset_of_after, 0);
+   
+   for(u8 tag = 0; tag < 3; ++tag) {
+      //
+      // The tag is in sector 0, so that sector has to be read before the 
+      // later parts of the union.
+      //
+      fill(tag);
+      struct TestStruct expected = sTestStruct;
+      LU_TEST_ROUND_TRIP(generated_read, generated_save, sTestStruct, sector_buffers, 0xFF);
+      
+      printf("With tag %u:\n", tag);
+      lu_test_check(matches(&expected), "Read matches the original data");
+   }
+   
+   return lu_test_failures;
+}
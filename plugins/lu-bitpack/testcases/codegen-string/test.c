@@ -47,6 +47,7 @@ extern void generated_save(u8* dst, int sector_id);
 #pragma lu_bitpack generate_functions( \
    read_name = generated_read,         \
    save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
    data      = sTestStruct,            \
    enable_debug_output = true \
 )
@@ -0,0 +1,112 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 3
+#define SECTOR_SIZE 32
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: sectors encoded as tables, and read and saved by a shared 
+// interpreter.
+struct Item {
+   LU_BP_BITCOUNT(10) u16 id;
+   LU_BP_MINMAX(-5, 10) s8 count;
+   bool8 flag;
+};
+
+struct TestStruct {
+   LU_BP_BITCOUNT(3) u8 small;
+   u32 large;
+   LU_BP_STRING_NT u8 name[8];
+   struct Item items[12];
+   LU_BP_MINMAX(100, 200) u16 values[6];
+   LU_BP_AS_OPAQUE_BUFFER u32 blob;
+   u8 bytes[40];
+} sTestStruct;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   data      = sTestStruct,            \
+   codegen_mode = table \
+)
+
+//
+// Testing:
+//
+
+#include <string.h> // memcmp, memcpy, strcmp
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void fill(void) {
+   sTestStruct.small = 5;
+   sTestStruct.large = 0xDEADBEEF;
+   memcpy(sTestStruct.name, "Lu\0garbage", 8);
+   for(int i = 0; i < 12; ++i) {
+      sTestStruct.items[i].id    = 50 * i;
+      sTestStruct.items[i].count = (i % 16) - 5;
+      sTestStruct.items[i].flag  = i & 1;
+   }
+   for(int i = 0; i < 6; ++i)
+      sTestStruct.values[i] = 100 + i * 17;
+   sTestStruct.blob = 0x01020304;
+   for(int i = 0; i < 40; ++i)
+      sTestStruct.bytes[i] = i * 7;
+}
+
+int main() {
+   fill();
+   struct TestStruct expected = sTestStruct;
+   LU_TEST_ROUND_TRIP(generated_read, generated_save, sTestStruct, sector_buffers, 0);
+   
+   bool8 same = 1;
+   same &= sTestStruct.small == expected.small;
+   same &= sTestStruct.large == expected.large;
+   same &= strcmp((const char*)sTestStruct.name, (const char*)expected.name) == 0;
+   for(int i = 0; i < 12; ++i) {
+      same &= sTestStruct.items[i].id    == expected.items[i].id;
+      same &= sTestStruct.items[i].count == expected.items[i].count;
+      same &= sTestStruct.items[i].flag  == expected.items[i].flag;
+   }
+   for(int i = 0; i < 6; ++i)
+      same &= sTestStruct.values[i] == expected.values[i];
+   same &= sTestStruct.blob == expected.blob;
+   same &= memcmp(sTestStruct.bytes, expected.bytes, 40) == 0;
+   lu_test_check(same, "Table-driven read matches the original data");
+   
+   return lu_test_failures;
+}
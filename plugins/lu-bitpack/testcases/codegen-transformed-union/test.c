@@ -78,6 +78,7 @@ struct TestStruct {
 #pragma lu_bitpack generate_functions( \
    read_name = generated_read,         \
    save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
    data      = sTestStruct,            \
    enable_debug_output = true \
 )
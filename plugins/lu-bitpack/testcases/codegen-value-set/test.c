@@ -0,0 +1,106 @@
+
+#include "types.h"
+#include "bitstreams.h"
+#include "helpers.h"
+
+#define SECTOR_COUNT 1
+#define SECTOR_SIZE 32
+
+#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)
+
+// Testcase: integrals serialized as their indices within sparse value sets.
+static const u16 sSpeciesIds[] = { 25000, 1, 9000, 40, 512 };
+
+struct TestStruct {
+   u8 before;
+   LU_BP_VALUE_SET("sSpeciesIds") u16 species;
+   LU_BP_VALUE_SET("sSpeciesIds") u16 party[4];
+   LU_BP_VALUE_SET(-300, -7, 0, 7, 300) s16 offset;
+   LU_BP_VALUE_SET(3, 1000, 70000, 2000000) u32 score;
+   LU_BP_VALUE_SET(42) u8 constant;
+   u16 after;
+} sTestStruct;
+
+extern void generated_read(const void* src, int sector_id);
+extern void generated_save(void* dst, int sector_id);
+
+#pragma lu_bitpack generate_functions( \
+   read_name = generated_read,         \
+   save_name = generated_save,         \
+   codegen_mode = LU_BP_CODEGEN_MODE, \
+   data      = sTestStruct             \
+)
+
+// 8 bits for `before`; 3 bits for each of the 5 species; 3 bits for `offset`; 
+// 2 bits for `score`; and none for `constant`.
+const unsigned int offset_of_after;
+#pragma lu_bitpack serialized_offset_to_constant offset_of_after sTestStruct.after
+
+//
+// Testing:
+//
+
+static u8 sector_buffers[SECTOR_COUNT][SECTOR_SIZE];
+
+static void fill(void) {
+   sTestStruct.before   = 0x12;
+   sTestStruct.species  = 9000;
+   sTestStruct.party[0] = 1;
+   sTestStruct.party[1] = 25000;
+   sTestStruct.party[2] = 40;
+   sTestStruct.party[3] = 600; // not in the set; saved as 9000
+   sTestStruct.offset   = -300;
+   sTestStruct.score    = 2000000;
+   sTestStruct.constant = 42;
+   sTestStruct.after    = 0xBCDE;
+}
+
+int main() {
+   lu_test_check_value("Offset of sTestStruct.after", offset_of_after, 8 + 3 * 5 + 3 + 2);
+   
+   fill();
+   struct TestStruct expected = sTestStruct;
+   expected.party[3] = 9000;
+   LU_TEST_ROUND_TRIP(generated_read, generated_save, sTestStruct, sector_buffers, 0);
+   
+   bool8 same = 1;
+   same &= sTestStruct.before == expected.before;
+   same &= sTestStruct.species == expected.species;
+   for(int i = 0; i < 4; ++i)
+      same &= sTestStruct.party[i] == expected.party[i];
+   same &= sTestStruct.offset == expected.offset;
+   same &= sTestStruct.score == expected.score;
+   same &= sTestStruct.constant == expected.constant;
+   same &= sTestStruct.after == expected.after;
+   lu_test_check(same, "Value-set read matches the original data");
+   
+   return lu_test_failures;
+}
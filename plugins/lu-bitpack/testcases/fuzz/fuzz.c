@@ -0,0 +1,168 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "types.h"
+#include "bitstreams.h"
+
+//
+// Round-trip fuzz harness for generated read/save functions. Link this
+// against a testcase compiled with `-Dmain=lu_testcase_main` and against
+// `bitstreams.c`.
+//
+// Usage: fuzz <testcase-name> <seed> <iterations> <output-path>
+//
+// We don't know the layout of the testcase's data, so we produce random
+// values for it by reading random bytes: each value then holds a random
+// bit pattern within its serialized bitcount, offset by its minimum. Per
+// iteration, we then:
+//
+//  - Save every sector (A), read A back, and save again (B). A and B must
+//    be identical.
+//
+//  - Append A, and a snapshot of the program's zero-initialized data (where
+//    the testcase's globals live) as of having read A back, to the output
+//    file. Binaries built from the same testcase with different codegen
+//    options must produce byte-identical output files for the same seed.
+//
+// Note that the plug-in defines `__lu_bitpack_sector_count` as the maximum
+// sector count. We detect the number of sectors actually in use by checking
+// which sectors' saves write anything.
+//
+
+extern void generated_read(const u8* src, int sector_id);
+extern void generated_save(u8* dst, int sector_id);
+
+extern const size_t __lu_bitpack_sector_count;
+extern const size_t __lu_bitpack_max_sector_size;
+
+// Bounds of .bss, as defined by the GNU linker.
+extern char __bss_start[];
+extern char _end[];
+
+static u32 next_random(u32* state) {
+   u32 x = *state;
+   x ^= x << 13;
+   x ^= x >> 17;
+   x ^= x << 5;
+   *state = x;
+   return x;
+}
+
+static void fill_random(u8* dst, size_t size, u32* state) {
+   for(size_t i = 0; i < size; ++i)
+      dst[i] = (u8)next_random(state);
+}
+
+static size_t count_used_sectors(u8* scratch, size_t sector_size) {
+   size_t count = 0;
+   for(; count < __lu_bitpack_sector_count; ++count) {
+      memset(scratch, 0x5A, sector_size);
+      generated_save(scratch, (int)count);
+      int written = 0;
+      for(size_t i = 0; i < sector_size; ++i) {
+         if (scratch[i] != 0x5A) {
+            written = 1;
+            break;
+         }
+      }
+      if (!written) {
+         //
+         // Maybe this sector's data happens to match our fill byte. Check
+         // again with a different one.
+         //
+         memset(scratch, 0xA5, sector_size);
+         generated_save(scratch, (int)count);
+         for(size_t i = 0; i < sector_size; ++i) {
+            if (scratch[i] != 0xA5) {
+               written = 1;
+               break;
+            }
+         }
+      }
+      if (!written)
+         break;
+   }
+   return count;
+}
+
+int main(int argc, char** argv) {
+   if (argc < 5) {
+      printf("Usage: %s <testcase-name> <seed> <iterations> <output-path>\n", argv[0]);
+      return 2;
+   }
+   const char* name       = argv[1];
+   u32         seed       = (u32)strtoul(argv[2], NULL, 10);
+   long        iterations = atol(argv[3]);
+   const char* out_path   = argv[4];
+   if (seed == 0)
+      seed = 1;
+
+   size_t sector_size = __lu_bitpack_max_sector_size;
+   if (sector_size == 0)
+      sector_size = 1;
+   size_t bss_size = (size_t)(_end - __bss_start);
+
+   u8* scratch = malloc(sector_size);
+   if (!scratch)
+      return 1;
+   size_t sector_count = count_used_sectors(scratch, sector_size);
+
+   u8* buffers_a = malloc(sector_count * sector_size + 1);
+   u8* buffers_b = malloc(sector_count * sector_size + 1);
+   u8* snapshot  = malloc(bss_size + 1);
+   FILE* out     = fopen(out_path, "wb");
+   if (!buffers_a || !buffers_b || !snapshot || !out)
+      return 1;
+
+   int failures = 0;
+   for(long n = 0; n < iterations; ++n) {
+      //
+      // Randomize the data.
+      //
+      for(size_t i = 0; i < sector_count; ++i) {
+         fill_random(scratch, sector_size, &seed);
+         generated_read(scratch, (int)i);
+      }
+      //
+      // Round-trip.
+      //
+      memset(buffers_a, 0, sector_count * sector_size);
+      memset(buffers_b, 0, sector_count * sector_size);
+      for(size_t i = 0; i < sector_count; ++i)
+         generated_save(buffers_a + i * sector_size, (int)i);
+      for(size_t i = 0; i < sector_count; ++i)
+         generated_read(buffers_a + i * sector_size, (int)i);
+      memcpy(snapshot, __bss_start, bss_size);
+      for(size_t i = 0; i < sector_count; ++i)
+         generated_save(buffers_b + i * sector_size, (int)i);
+
+      for(size_t i = 0; i < sector_count * sector_size; ++i) {
+         if (buffers_a[i] != buffers_b[i]) {
+            printf(
+               "%s: iteration %ld: sector %u byte %u differs after a round trip (0x%02X, then 0x%02X)\n",
+               name,
+               n,
+               (unsigned int)(i / sector_size),
+               (unsigned int)(i % sector_size),
+               buffers_a[i],
+               buffers_b[i]
+            );
+            ++failures;
+            break;
+         }
+      }
+      fwrite(buffers_a, 1, sector_count * sector_size, out);
+      fwrite(snapshot, 1, bss_size, out);
+   }
+   fclose(out);
+
+   printf(
+      "%s: %ld iterations over %u sector(s); %d failure(s)\n",
+      name,
+      iterations,
+      (unsigned int)sector_count,
+      failures
+   );
+   return failures ? 1 : 0;
+}
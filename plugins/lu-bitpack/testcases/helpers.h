@@ -9,11 +9,22 @@
 #define LU_BP_STRING           __attribute__((lu_bitpack_string))
 #define LU_BP_STRING_NT        LU_BP_STRING
 #define LU_BP_STRING_UT        __attribute__((lu_nonstring)) LU_BP_STRING
+#define LU_BP_CHARSET(params)  __attribute__((lu_bitpack_charset(params)))
+#define LU_BP_VALUE_SET(...)   __attribute__((lu_bitpack_value_set(__VA_ARGS__)))
+#define LU_BP_QUANTIZE(min, max, bits) __attribute__((lu_bitpack_quantize(min, max, bits)))
+#define LU_BP_DELTA(first_bits, delta_bits) __attribute__((lu_bitpack_delta(first_bits, delta_bits)))
+#define LU_BP_POINTER_INTO(array) __attribute__((lu_bitpack_pointer_into(array)))
 #define LU_BP_TRANSFORM(pre_pack, post_unpack) \
    __attribute__((lu_bitpack_transforms("pre_pack=" #pre_pack ",post_unpack=" #post_unpack)))
 
 #define LU_BP_CATEGORY(name) __attribute__((lu_bitpack_stat_category(name)))
 
+// The codegen mode used by testcases that don't test a specific one. Build 
+// with e.g. `-DLU_BP_CODEGEN_MODE=table` to run them all in another mode.
+#ifndef LU_BP_CODEGEN_MODE
+   #define LU_BP_CODEGEN_MODE code
+#endif
+
 // Indicate the value that acts as a union's tag, when that value is not 
 // inside of [all of the members of] the union itself. The union must be 
 // located somewhere inside of a containing struct (named tag or typedef) 
@@ -31,8 +42,9 @@
 
 #include <ctype.h>
 #include <stdio.h>
+#include <string.h>
 
-void print_buffer(const char* buffer, int size) {
+static inline void print_buffer(const char* buffer, int size) {
    printf("Buffer:\n   ");
    for(int i = 0; i < size; ++i) {
       if (i && i % 8 == 0) {
@@ -43,7 +55,7 @@ void print_buffer(const char* buffer, int size) {
    printf("\n");
 }
 
-void print_char(char c) {
+static inline void print_char(char c) {
    if (isprint(c)) {
       printf("'%c'", (uint8_t)(c & 0xFF));
    } else {
@@ -51,7 +63,7 @@ void print_char(char c) {
    }
 }
 
-void print_top_level_string_member(const char* name, int size, const char* data) {
+static inline void print_top_level_string_member(const char* name, int size, const char* data) {
    printf("      .%s = {\n", name);
    for(int i = 0; i < size; ++i) {
       printf("         ");
@@ -61,4 +73,53 @@ void print_top_level_string_member(const char* name, int size, const char* data)
    printf("      },\n");
 }
 
+//
+// Checks. Each check prints its result, and failed checks are counted, so 
+// that a testcase can fail its run by returning `lu_test_failures` from 
+// `main`.
+//
+
+static int lu_test_failures;
+
+static inline void lu_test_check(int ok, const char* what) {
+   if (ok) {
+      printf("%s: OK\n", what);
+   } else {
+      printf("%s: FAILED\n", what);
+      ++lu_test_failures;
+   }
+}
+
+static inline void lu_test_check_value(const char* what, unsigned int actual, unsigned int expected) {
+   if (actual == expected) {
+      printf("%s: %u\n", what, actual);
+   } else {
+      printf("%s: %u, but expected %u: FAILED\n", what, actual, expected);
+      ++lu_test_failures;
+   }
+}
+
+// Saves every sector of `data` into `buffers`, a `u8[sector_count][size]` 
+// array; fills `data` with `clobber` bytes; and then reads every sector back, 
+// so that the testcase can compare `data` against what it saved. Saving the 
+// data we read back must reproduce the original save, byte for byte, so we 
+// check that too.
+#define LU_TEST_ROUND_TRIP(read, save, data, buffers, clobber) \
+   do { \
+      const int lu_count_ = (int)(sizeof(buffers) / sizeof((buffers)[0])); \
+      u8 lu_resaved_[sizeof(buffers) / sizeof((buffers)[0])][sizeof((buffers)[0])]; \
+      memcpy(lu_resaved_, (buffers), sizeof(buffers)); \
+      for(int lu_i_ = 0; lu_i_ < lu_count_; ++lu_i_) \
+         save((buffers)[lu_i_], lu_i_); \
+      memset(&(data), (clobber), sizeof(data)); \
+      for(int lu_i_ = 0; lu_i_ < lu_count_; ++lu_i_) \
+         read((buffers)[lu_i_], lu_i_); \
+      for(int lu_i_ = 0; lu_i_ < lu_count_; ++lu_i_) \
+         save(lu_resaved_[lu_i_], lu_i_); \
+      lu_test_check( \
+         memcmp(lu_resaved_, (buffers), sizeof(buffers)) == 0, \
+         "Saving the data read back reproduces the original save" \
+      ); \
+   } while (0)
+
 #endif
\ No newline at end of file
@@ -0,0 +1,347 @@
+-- Designed for Lua 5.4.
+
+--
+-- Generates C sources with large, parameterized data layouts, for measuring
+-- how the plug-in's compile time and memory usage scale. Each shape stresses
+-- a different part of code generation; `scale` controls its size.
+--
+
+local fmt = string.format
+
+local shapes = {} -- shapes[name] = { description = "...", generate = function(out, scale) }
+
+function usage(error_message)
+   print("Usage:")
+   print(" generate.lua --shape <name> --scale <n> [--out <path>]")
+   print("")
+   print("Writes a C source file that uses the bitpacking plug-in to serialize a synthetic ")
+   print("data layout. If no output path is given, the file is written to stdout.")
+   print("")
+   print("Shapes:")
+   local names = {}
+   for name, _ in pairs(shapes) do
+      names[#names + 1] = name
+   end
+   table.sort(names)
+   for _, name in ipairs(names) do
+      print(fmt(" %-16s %s", name, shapes[name].description))
+   end
+   print("")
+   print("Additional options:")
+   print(" --sector-size <n>               sector size in bytes (default 3968)")
+   print(" --list                          list shape names, one per line, and exit")
+   if error_message then
+      print("")
+      print("Error: " .. error_message)
+   end
+   os.exit(1)
+end
+
+--
+-- Output helpers.
+--
+
+local writer = {}
+writer.__index = writer
+function writer.new()
+   return setmetatable({ lines = {} }, writer)
+end
+function writer:line(...)
+   if select("#", ...) == 0 then
+      self.lines[#self.lines + 1] = ""
+   else
+      self.lines[#self.lines + 1] = fmt(...)
+   end
+end
+function writer:text()
+   return table.concat(self.lines, "\n") .. "\n"
+end
+
+-- Cycles through a handful of scalar field types, so that fields exercise
+-- each of the bitstream read/write functions.
+local function scalar_field(out, indent, name, i)
+   local kind = i % 6
+   if kind == 0 then
+      out:line("%sLU_BP_BITCOUNT(%u) u8 %s;", indent, 1 + i % 8, name)
+   elseif kind == 1 then
+      out:line("%sLU_BP_BITCOUNT(%u) u16 %s;", indent, 9 + i % 8, name)
+   elseif kind == 2 then
+      out:line("%su32 %s;", indent, name)
+   elseif kind == 3 then
+      out:line("%sbool8 %s;", indent, name)
+   elseif kind == 4 then
+      out:line("%sLU_BP_MINMAX(%d, %d) s16 %s;", indent, -(i % 100), i % 1000, name)
+   else
+      out:line("%sLU_BP_STRING_UT u8 %s[%u];", indent, name, 1 + i % 10)
+   end
+end
+
+--
+-- Shapes. Each generator declares its types and a set of top-level variables,
+-- and returns the value of the `data` option for `generate_functions`.
+--
+
+shapes["fields"] = {
+   description = "one struct with <scale> scalar fields of varying types",
+   generate = function(out, scale)
+      out:line("struct Synthetic {")
+      for i = 0, scale - 1 do
+         scalar_field(out, "   ", fmt("field_%u", i), i)
+      end
+      out:line("} sSynthetic;")
+      return "sSynthetic"
+   end,
+}
+
+shapes["nesting"] = {
+   description = "a chain of structs nested <scale> levels deep",
+   generate = function(out, scale)
+      for i = scale - 1, 0, -1 do
+         out:line("struct Level%u {", i)
+         for j = 0, 2 do
+            scalar_field(out, "   ", fmt("field_%u", j), i + j)
+         end
+         if i < scale - 1 then
+            out:line("   struct Level%u next;", i + 1)
+         end
+         out:line("};")
+      end
+      out:line()
+      out:line("struct Level0 sSynthetic;")
+      return "sSynthetic"
+   end,
+}
+
+shapes["arrays"] = {
+   description = "multi-dimensional arrays of scalars and structs, <scale> rows",
+   generate = function(out, scale)
+      out:line("struct Cell {")
+      out:line("   LU_BP_BITCOUNT(5) u8 a;")
+      out:line("   u16 b;")
+      out:line("   LU_BP_MINMAX(0, 100) u8 c[3];")
+      out:line("};")
+      out:line()
+      out:line("struct Synthetic {")
+      out:line("   struct Cell grid[%u][8][4];", scale)
+      out:line("   LU_BP_BITCOUNT(3) u8 small[%u][16][4];", scale)
+      out:line("   u32 wide[%u][2];", scale)
+      out:line("} sSynthetic;")
+      return "sSynthetic"
+   end,
+}
+
+shapes["unions"] = {
+   description = "externally- and internally-tagged unions with <scale> members",
+   generate = function(out, scale)
+      out:line("struct Synthetic {")
+      out:line("   LU_BP_MINMAX(0, %u) u16 external_tag;", scale - 1)
+      out:line("   LU_BP_UNION_TAG(external_tag) union {")
+      for i = 0, scale - 1 do
+         out:line("      LU_BP_TAGGED_ID(%u) struct {", i)
+         for j = 0, i % 3 do
+            scalar_field(out, "         ", fmt("field_%u", j), i + j)
+         end
+         out:line("      } member_%u;", i)
+      end
+      out:line("   } external;")
+      out:line("   LU_BP_UNION_INTERNAL_TAG(tag) union {")
+      for i = 0, scale - 1 do
+         out:line("      LU_BP_TAGGED_ID(%u) struct {", i)
+         out:line("         LU_BP_MINMAX(0, %u) u16 tag;", scale - 1)
+         for j = 0, i % 3 do
+            scalar_field(out, "         ", fmt("field_%u", j), i + j)
+         end
+         out:line("      } member_%u;", i)
+      end
+      out:line("   } internal[4];")
+      out:line("} sSynthetic;")
+      return "sSynthetic"
+   end,
+}
+
+shapes["transforms"] = {
+   description = "<scale> distinct transformed types, each used by two fields",
+   generate = function(out, scale)
+      for i = 0, scale - 1 do
+         out:line("struct Packed%u;", i)
+         out:line("struct Unpacked%u;", i)
+         out:line("void Pack%u(const struct Unpacked%u*, struct Packed%u*);", i, i, i)
+         out:line("void Unpack%u(struct Unpacked%u*, const struct Packed%u*);", i, i, i)
+         out:line("struct Packed%u {", i)
+         out:line("   LU_BP_BITCOUNT(%u) u32 merged;", 2 + i % 30)
+         out:line("};")
+         out:line("struct LU_BP_TRANSFORM(Pack%u,Unpack%u) Unpacked%u {", i, i, i)
+         out:line("   u16 lo;")
+         out:line("   u16 hi;")
+         out:line("};")
+         out:line("void Pack%u(const struct Unpacked%u* src, struct Packed%u* dst) {", i, i, i)
+         out:line("   dst->merged = ((u32)src->hi << 16) | src->lo;")
+         out:line("}")
+         out:line("void Unpack%u(struct Unpacked%u* dst, const struct Packed%u* src) {", i, i, i)
+         out:line("   dst->lo = src->merged;")
+         out:line("   dst->hi = src->merged >> 16;")
+         out:line("}")
+         out:line()
+      end
+      out:line("struct Synthetic {")
+      for i = 0, scale - 1 do
+         out:line("   struct Unpacked%u single_%u;", i, i)
+         out:line("   struct Unpacked%u array_%u[2];", i, i)
+      end
+      out:line("} sSynthetic;")
+      return "sSynthetic"
+   end,
+}
+
+shapes["sectors"] = {
+   description = "<scale> top-level groups, each forced into its own sector",
+   generate = function(out, scale)
+      out:line("struct Group {")
+      for i = 0, 11 do
+         scalar_field(out, "   ", fmt("field_%u", i), i)
+      end
+      out:line("   u16 values[32];")
+      out:line("};")
+      out:line()
+      local names = {}
+      for i = 0, scale - 1 do
+         out:line("struct Group sGroup%u;", i)
+         names[#names + 1] = fmt("sGroup%u", i)
+      end
+      return table.concat(names, " | ")
+   end,
+}
+
+--
+-- Main.
+--
+
+local options = {
+   shape       = nil,
+   scale       = nil,
+   out         = nil,
+   sector_size = 3968,
+}
+do -- parse args
+   local i = 1
+   while i <= #arg do
+      local a = arg[i]
+      if a == "--shape" then
+         i = i + 1
+         options.shape = arg[i]
+      elseif a == "--scale" then
+         i = i + 1
+         options.scale = tonumber(arg[i])
+      elseif a == "--out" then
+         i = i + 1
+         options.out = arg[i]
+      elseif a == "--sector-size" then
+         i = i + 1
+         options.sector_size = tonumber(arg[i])
+      elseif a == "--list" then
+         local names = {}
+         for name, _ in pairs(shapes) do
+            names[#names + 1] = name
+         end
+         table.sort(names)
+         for _, name in ipairs(names) do
+            print(name)
+         end
+         os.exit(0)
+      else
+         usage(fmt("unrecognized argument %q", a))
+      end
+      i = i + 1
+   end
+end
+if not options.shape then
+   usage("no shape specified")
+end
+if not shapes[options.shape] then
+   usage(fmt("unknown shape %q", options.shape))
+end
+if not options.scale or options.scale < 1 or options.scale ~= math.floor(options.scale) then
+   usage("the scale must be a positive integer")
+end
+if not options.sector_size or options.sector_size < 1 then
+   usage("the sector size must be a positive integer")
+end
+
+local body = writer.new()
+local data = shapes[options.shape].generate(body, options.scale)
+
+local out = writer.new()
+out:line("// Generated by testcases/synthetic/generate.lua --shape %s --scale %u", options.shape, options.scale)
+out:line("#include \"types.h\"")
+out:line("#include \"bitstreams.h\"")
+out:line("#include \"helpers.h\"")
+out:line()
+-- Sector count is only an upper bound; the plug-in uses as many as it needs.
+out:line("#define SECTOR_COUNT 65535")
+out:line("#define SECTOR_SIZE %u", options.sector_size)
+out:line()
+out:line([[#pragma lu_bitpack enable
+#pragma lu_bitpack set_options ( \
+   sector_count=SECTOR_COUNT, \
+   sector_size=SECTOR_SIZE,  \
+   bool_typename            = bool8, \
+   buffer_byte_typename     = void, \
+   bitstream_state_typename = lu_BitstreamState, \
+   func_initialize  = lu_BitstreamInitialize, \
+   func_read_bool   = lu_BitstreamRead_bool, \
+   func_read_u8     = lu_BitstreamRead_u8,   \
+   func_read_u16    = lu_BitstreamRead_u16,  \
+   func_read_u32    = lu_BitstreamRead_u32,  \
+   func_read_s8     = lu_BitstreamRead_s8,   \
+   func_read_s16    = lu_BitstreamRead_s16,  \
+   func_read_s32    = lu_BitstreamRead_s32,  \
+   func_read_string_ut = lu_BitstreamRead_string_optional_terminator, \
+   func_read_string_nt = lu_BitstreamRead_string, \
+   func_read_buffer = lu_BitstreamRead_buffer, \
+   func_write_bool   = lu_BitstreamWrite_bool, \
+   func_write_u8     = lu_BitstreamWrite_u8,   \
+   func_write_u16    = lu_BitstreamWrite_u16,  \
+   func_write_u32    = lu_BitstreamWrite_u32,  \
+   func_write_s8     = lu_BitstreamWrite_s8,   \
+   func_write_s16    = lu_BitstreamWrite_s16,  \
+   func_write_s32    = lu_BitstreamWrite_s32,  \
+   func_write_string_ut = lu_BitstreamWrite_string_optional_terminator, \
+   func_write_string_nt = lu_BitstreamWrite_string, \
+   func_write_buffer = lu_BitstreamWrite_buffer \
+)]])
+out:line()
+for _, line in ipairs(body.lines) do
+   out.lines[#out.lines + 1] = line
+end
+out:line()
+out:line("extern void generated_read(const u8* src, int sector_id);")
+out:line("extern void generated_save(u8* dst, int sector_id);")
+out:line()
+out:line("#pragma lu_bitpack generate_functions( \\")
+out:line("   read_name = generated_read,         \\")
+out:line("   save_name = generated_save,         \\")
+out:line("   codegen_mode = LU_BP_CODEGEN_MODE, \\")
+out:line("   data      = %s \\", data)
+out:line(")")
+out:line()
+out:line([[//
+// Testing: save and read back each sector in turn. Unused sectors are no-ops.
+//
+
+static u8 sector_buffer[SECTOR_SIZE];
+
+int main() {
+   for(int i = 0; i < SECTOR_COUNT; ++i) {
+      generated_save(sector_buffer, i);
+      generated_read(sector_buffer, i);
+   }
+   return 0;
+}]])
+
+if options.out then
+   local file = assert(io.open(options.out, "w"))
+   file:write(out:text())
+   file:close()
+else
+   io.write(out:text())
+end